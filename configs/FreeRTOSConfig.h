@@ -160,6 +160,14 @@ standard names. */
 #define xPortPendSVHandler PendSV_Handler
 #define xPortSysTickHandler SysTick_Handler
 
+/* Task switch trace of source/radar_trace.c, enabled with RADAR_TRACE=1 */
+#if defined(RADAR_TRACE_ENABLE) && (RADAR_TRACE_ENABLE != 0)
+#if !defined(__ASSEMBLER__) && !defined(__IASMARM__)
+extern void radar_trace_task_switched_in(uint32_t task_number);
+#endif
+#define traceTASK_SWITCHED_IN() radar_trace_task_switched_in((uint32_t)pxCurrentTCB->uxTCBNumber)
+#endif
+
 /* Dynamic Memory Allocation Schemes */
 #define HEAP_ALLOCATION_TYPE1                       (1)     /* heap_1.c*/
 #define HEAP_ALLOCATION_TYPE2                       (2)     /* heap_2.c*/
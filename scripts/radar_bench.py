@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Runs the microbenchmark of the hot functions and compares results.
+
+The benchmark (source/radar_bench.c) measures each case RADAR_BENCH_SAMPLES
+times with warm caches, in batches of RADAR_BENCH_BATCH calls, and with cold
+caches, one call after the caches were flushed. It reports per call the
+median, the median absolute deviation (MAD), the minimum and the maximum,
+after subtracting the overhead of an empty measurement.
+
+The results are collected from one of three sources and written as JSON,
+tagged with the git commit of the tree, so that runs before and after a
+change can be compared:
+
+    python3 radar_bench.py --host -o host.json
+    python3 radar_bench.py --port /dev/ttyACM0 -o before.json
+    python3 radar_bench.py --log terminal.log -o after.json
+    python3 radar_bench.py --compare before.json after.json
+
+--host builds the portable cases with the host compiler (cc or $CC) and
+runs them there, timed in nanoseconds; useful to compare algorithm changes
+without hardware, not for absolute numbers. --port sends 'b' to a kit built
+with "make build RADAR_BENCH=1" and collects the "B ..." lines, timed in CPU
+cycles with interrupts disabled. --log reads the lines from a terminal log.
+
+--compare lists the change of the medians and marks a change as significant
+when it exceeds --threshold times the larger MAD of both runs, one counter
+tick and --min-change percent of the old median. It exits with status 1 if a
+case got significantly slower. On the target, with interrupts disabled,
+runs of the same firmware are expected to agree closely; on the host, runs
+differ by more than their MAD (frequency scaling, other processes), so use a
+larger --min-change there.
+
+Serial downloads need pyserial.
+"""
+
+import argparse
+import ctypes
+import json
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+HOST_SOURCES = ("radar_bench.c", "radar_crc.c", "radar_event_record.c", "radar_format.c",
+                "radar_led_pattern.c", "radar_line_edit.c", "radar_ring_buffer.c", "radar_timesync.c")
+OUTPUT = ctypes.CFUNCTYPE(None, ctypes.c_char_p)
+
+
+def parse(lines):
+    """Returns the header and the results of the "B ..." lines of one run."""
+    header = None
+    results = []
+    for line in lines:
+        line = line.strip()
+        if line.startswith("B BEGIN "):
+            header = json.loads(line[len("B BEGIN "):])
+            results = []
+        elif line == "B END":
+            if header is None:
+                break
+            return header, results
+        elif line.startswith("B {") and header is not None:
+            results.append(json.loads(line[2:]))
+        elif line.startswith("Benchmark not enabled"):
+            raise SystemExit("benchmark not enabled, build with RADAR_BENCH=1")
+    raise SystemExit("no complete benchmark run found")
+
+
+def run_host():
+    compiler = os.environ.get("CC") or shutil.which("cc") or shutil.which("gcc")
+    if compiler is None:
+        raise SystemExit("no C compiler found, set CC")
+    lines = []
+    with tempfile.TemporaryDirectory() as directory:
+        library = os.path.join(directory, "radar_bench.so")
+        sources = [os.path.join(ROOT, "source", name) for name in HOST_SOURCES]
+        subprocess.check_call([compiler, "-O2", "-shared", "-fPIC", "-DRADAR_BENCH_HOST",
+                               "-I" + os.path.join(ROOT, "source"), "-o", library] + sources)
+        bench = ctypes.CDLL(library)
+        bench.radar_bench_host.argtypes = [ctypes.c_char_p, OUTPUT]
+        bench.radar_bench_host.restype = None
+        output = OUTPUT(lambda line: lines.append(line.decode("ascii")))
+        target = "%s %s" % (platform.system(), platform.machine())
+        bench.radar_bench_host(target.encode("ascii"), output)
+    return parse(lines)
+
+
+def serial_lines(port):
+    while True:
+        line = port.readline()
+        if not line:
+            return
+        yield line.decode("ascii", errors="replace")
+
+
+def run_port(device, timeout):
+    import serial
+
+    with serial.Serial(device, 115200, timeout=timeout) as port:
+        port.reset_input_buffer()
+        port.write(b"b")
+        return parse(serial_lines(port))
+
+
+def git_commit():
+    try:
+        commit = subprocess.check_output(["git", "-C", ROOT, "rev-parse", "--short", "HEAD"],
+                                         stderr=subprocess.DEVNULL).decode().strip()
+        dirty = subprocess.call(["git", "-C", ROOT, "diff", "--quiet", "HEAD", "--", "source"],
+                                stderr=subprocess.DEVNULL) != 0
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    return commit + ("-dirty" if dirty else "")
+
+
+def print_results(header, results):
+    print("%s, %s, %d samples" % (header["target"], header["unit"], header["samples"]))
+    print("%-36s %-5s %10s %8s %10s %10s" % ("case", "cache", "median", "mad", "min", "max"))
+    for result in results:
+        print("%-36s %-5s %10d %8d %10d %10d" % (
+            result["name"][:36], result["variant"], result["median"], result["mad"], result["min"], result["max"]))
+
+
+def compare(old, new, threshold, min_change):
+    """Prints the change of the medians, returns the significantly slower cases."""
+    if old["unit"] != new["unit"] or old["target"] != new["target"]:
+        print("warning: comparing %s (%s) with %s (%s)" % (old["target"], old["unit"], new["target"], new["unit"]),
+              file=sys.stderr)
+    print("%s -> %s, %s" % (old.get("commit"), new.get("commit"), new["unit"]))
+    print("%-36s %-5s %10s %10s %10s %8s" % ("case", "cache", "old", "new", "delta", ""))
+    before = {(result["name"], result["variant"]): result for result in old["results"]}
+    slower = []
+    for result in new["results"]:
+        key = (result["name"], result["variant"])
+        base = before.pop(key, None)
+        if base is None:
+            print("%-36s %-5s %10s %10d %10s %8s" % (key[0][:36], key[1], "-", result["median"], "", "new"))
+            continue
+        delta = result["median"] - base["median"]
+        limit = max(threshold * max(base["mad"], result["mad"]), 1, min_change * base["median"] / 100.0)
+        mark = ""
+        if delta > limit:
+            mark = "slower"
+            slower.append(key)
+        elif -delta > limit:
+            mark = "faster"
+        percent = (100.0 * delta / base["median"]) if base["median"] else 0.0
+        print("%-36s %-5s %10d %10d %+9.1f%% %8s" % (
+            key[0][:36], key[1], base["median"], result["median"], percent, mark))
+    for key in before:
+        print("%-36s %-5s %10d %10s %10s %8s" % (key[0][:36], key[1], before[key]["median"], "-", "", "removed"))
+    return slower
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--host", action="store_true", help="run the portable cases on this machine")
+    source.add_argument("--port", help="serial port of a kit built with RADAR_BENCH=1")
+    source.add_argument("--log", help="terminal log with the benchmark output")
+    source.add_argument("--compare", nargs=2, metavar=("OLD", "NEW"), help="compare two result files")
+    parser.add_argument("-o", "--output", help="write the results to this JSON file")
+    parser.add_argument("--timeout", type=float, default=30.0, help="serial read timeout in seconds")
+    parser.add_argument("--threshold", type=float, default=3.0, help="significant change in MADs")
+    parser.add_argument("--min-change", type=float, default=2.0, help="significant change in percent")
+    args = parser.parse_args()
+
+    if args.compare:
+        runs = []
+        for name in args.compare:
+            with open(name, encoding="utf-8") as run_file:
+                runs.append(json.load(run_file))
+        slower = compare(runs[0], runs[1], args.threshold, args.min_change)
+        if slower:
+            print("significantly slower: %s" % ", ".join("%s (%s)" % key for key in slower), file=sys.stderr)
+            sys.exit(1)
+        return
+
+    if args.host:
+        header, results = run_host()
+    elif args.port:
+        header, results = run_port(args.port, args.timeout)
+    else:
+        with open(args.log, encoding="ascii", errors="replace") as log:
+            header, results = parse(log)
+
+    print_results(header, results)
+    if args.output:
+        run = dict(header, commit=git_commit(), results=results)
+        with open(args.output, "w", encoding="utf-8") as output_file:
+            json.dump(run, output_file, indent=2, sort_keys=True)
+            output_file.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Decodes the event history exported by the radar entrance counter.
+
+Press 'x' in the terminal and enter a sequence number to export the event
+journal as "X <base64>" chunk lines (see source/radar_history.h). This
+script decodes chunk lines from a saved terminal log, or downloads them from
+the serial port and resumes after a chunk with a wrong CRC. Records are
+written as CSV: sequence, type, timestamp in milliseconds, in and out count,
+and whether the timestamp is in the timebase of the gateway (time sync 'y')
+instead of the time since startup of the sensor.
+
+    python3 radar_history.py --log terminal.log
+    python3 radar_history.py --port /dev/ttyACM0 --since 0 > history.csv
+
+Serial downloads need pyserial.
+"""
+
+import argparse
+import base64
+import binascii
+import sys
+import zlib
+
+VERSION = 1
+TYPES = {1: "IN", 2: "OUT", 3: "OCCUPIED", 4: "FREE"}
+TAG_TYPE_MASK = 0x07
+TAG_GAP = 0x08
+TAG_COUNTS = 0x10
+TAG_SYNCED = 0x20
+
+
+class ChunkError(Exception):
+    """Chunk that cannot be decoded."""
+
+
+def read_varint(data, offset):
+    value = 0
+    shift = 0
+    while True:
+        if offset >= len(data):
+            raise ChunkError("truncated varint")
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, offset
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode_chunk(data):
+    """Returns the records of a chunk as (sequence, type, ms, in, out, synced) tuples."""
+    if len(data) < 6:
+        raise ChunkError("chunk too short")
+    crc = int.from_bytes(data[-4:], "little")
+    if zlib.crc32(data[:-4]) != crc:
+        raise ChunkError("CRC mismatch")
+    payload = data[:-4]
+    if payload[0] != VERSION:
+        raise ChunkError("unknown version %d" % payload[0])
+    count = payload[1]
+    sequence, offset = read_varint(payload, 2)
+    timestamp, offset = read_varint(payload, offset)
+    in_count, offset = read_varint(payload, offset)
+    out_count, offset = read_varint(payload, offset)
+
+    records = []
+    for _ in range(count):
+        if offset >= len(payload):
+            raise ChunkError("truncated record")
+        tag = payload[offset]
+        offset += 1
+        kind = tag & TAG_TYPE_MASK
+        if tag & TAG_GAP:
+            gap, offset = read_varint(payload, offset)
+            sequence = (sequence + gap) & 0xFFFFFFFF
+        delta, offset = read_varint(payload, offset)
+        timestamp += delta
+        if tag & TAG_COUNTS:
+            delta_in, offset = read_varint(payload, offset)
+            delta_out, offset = read_varint(payload, offset)
+            in_count = (in_count + unzigzag(delta_in)) & 0xFFFFFFFF
+            out_count = (out_count + unzigzag(delta_out)) & 0xFFFFFFFF
+        elif kind == 1:
+            in_count += 1
+        elif kind == 2:
+            out_count += 1
+        synced = 1 if tag & TAG_SYNCED else 0
+        records.append((sequence, TYPES.get(kind, str(kind)), timestamp, in_count, out_count, synced))
+        sequence = (sequence + 1) & 0xFFFFFFFF
+    if offset != len(payload):
+        raise ChunkError("trailing bytes")
+    return records
+
+
+def decode_lines(lines):
+    """Decodes chunk lines until the end line.
+
+    Returns the records of all good chunks before the first bad one, the
+    sequence number to resume at and whether the export was complete.
+    """
+    records = []
+    resume = None
+    for line in lines:
+        line = line.strip()
+        if not line.startswith("X "):
+            continue
+        fields = line.split()
+        if fields[1] == "END":
+            if resume is None and len(fields) > 3:
+                resume = int(fields[3])
+            return records, resume, True
+        try:
+            chunk = decode_chunk(base64.b64decode(fields[1], validate=True))
+        except (ChunkError, binascii.Error, ValueError) as error:
+            print("bad chunk: %s" % error, file=sys.stderr)
+            return records, resume, False
+        records.extend(chunk)
+        resume = (chunk[-1][0] + 1) & 0xFFFFFFFF
+    return records, resume, False
+
+
+def serial_lines(port):
+    while True:
+        line = port.readline()
+        if not line:
+            return
+        yield line.decode("ascii", errors="replace")
+
+
+def download(device, since, retries):
+    import serial
+
+    records = []
+    with serial.Serial(device, 115200, timeout=5) as port:
+        for _ in range(retries + 1):
+            port.reset_input_buffer()
+            port.write(b"x")
+            port.write(("%d\r" % since).encode("ascii"))
+            chunk_records, resume, complete = decode_lines(serial_lines(port))
+            records.extend(chunk_records)
+            if complete:
+                return records
+            if resume is not None:
+                since = resume
+            print("resuming at sequence %d" % since, file=sys.stderr)
+    raise SystemExit("export incomplete after %d retries" % retries)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--log", help="terminal log with chunk lines")
+    source.add_argument("--port", help="serial port of the kit")
+    parser.add_argument("--since", type=int, default=0, help="first sequence number to download")
+    parser.add_argument("--retries", type=int, default=3, help="resumes after bad chunks")
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, encoding="ascii", errors="replace") as log:
+            records, _, complete = decode_lines(log)
+        if not complete:
+            print("export incomplete", file=sys.stderr)
+    else:
+        records = download(args.port, args.since, args.retries)
+
+    print("sequence,type,timestamp_ms,in,out,synced")
+    for record in records:
+        print("%d,%s,%d,%d,%d,%d" % record)
+
+
+if __name__ == "__main__":
+    main()
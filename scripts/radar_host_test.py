@@ -0,0 +1,1168 @@
+#!/usr/bin/env python3
+"""Tests the hardware independent modules of the firmware on the host.
+
+The modules that only depend on the C standard library (see the notes in
+their headers) and radar_occupancy.c, with stand-ins for the HAL GPIO
+functions, the critical sections and the clock, are compiled with the host
+compiler together with a small test driver, once with AddressSanitizer and UndefinedBehaviorSanitizer for
+the functional checks and once optimized for the cost measurement. The
+script feeds the driver and compares its output with golden results or
+with a Python model of the expected behavior:
+
+    led_*         LED timelines of IN, OUT, OCCUPIED and FREE sequences,
+                  including an IN pattern cut short by an OUT event, against
+                  golden run-length strings (see radar_led_pattern.h)
+    line_edit_*   line editor cases (over-length lines, control bytes,
+                  backspace at column 0) and a random fuzz run against a
+                  model, with the line buffer allocated at its exact size
+    occupancy_*   occupancy limit output: threshold crossing, hysteresis,
+                  limit changes and the state restored after a reset, and
+                  the GPIO writes of radar_occupancy.c with the time from
+                  the event to the write
+    number_*      parameter values parsed into thousandths, at and beyond
+                  the limits of the int32_t range
+    journal_*     "J" journal lines through scripts/radar_journal.py: round
+                  trip, corrupted and unknown records, sequence gaps,
+                  duplicates and wrap around
+    history_*     history chunks encoded as by the 'x' export and decoded
+                  by scripts/radar_history.py, across resets and changes
+                  of the timebase
+    cost          time per iteration of the LED step and the line editor,
+                  which must stay below --max-ns
+
+    python3 radar_host_test.py
+    python3 radar_host_test.py --fuzz-bytes 1000000 --seed 7
+    python3 radar_host_test.py -k led
+
+Each failed check is listed and the script exits with status 1. Needs a C
+compiler with sanitizer support (cc or $CC, e.g. gcc or clang).
+"""
+
+import argparse
+import base64
+import ctypes
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import radar_history  # noqa: E402
+import radar_journal  # noqa: E402
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+SOURCES = ("radar_crc.c", "radar_event_record.c", "radar_format.c", "radar_history_chunk.c", "radar_led_pattern.c",
+           "radar_line_edit.c", "radar_occupancy.c", "radar_occupancy_rule.c")
+SANITIZE = ["-O1", "-g", "-fsanitize=address,undefined", "-fno-sanitize-recover=all", "-fno-omit-frame-pointer"]
+
+# Stand-ins for the headers of the HAL, the BSP and the RTOS abstraction
+# used by radar_occupancy.c, implemented by the test driver
+STUBS = {
+    "cy_result.h": r"""
+#pragma once
+#include <stdint.h>
+typedef uint32_t cy_rslt_t;
+#define CY_RSLT_SUCCESS ((cy_rslt_t)0U)
+""",
+    "cybsp.h": r"""
+#pragma once
+#define CYBSP_GPIO12 (12U)
+""",
+    "cyabs_rtos.h": r"""
+#pragma once
+void stand_in_critical(int nesting);
+#define taskENTER_CRITICAL() stand_in_critical(1)
+#define taskEXIT_CRITICAL() stand_in_critical(-1)
+""",
+    "cyhal.h": r"""
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "cy_result.h"
+typedef uint32_t cyhal_gpio_t;
+typedef enum { CYHAL_GPIO_DIR_OUTPUT } cyhal_gpio_direction_t;
+typedef enum { CYHAL_GPIO_DRIVE_STRONG } cyhal_gpio_drive_mode_t;
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction, cyhal_gpio_drive_mode_t drive_mode,
+                          bool init_val);
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value);
+""",
+}
+
+# Test driver, the command is the first argument. Checks that need the
+# internal state abort, so that the sanitizer report or the exit status
+# fails the test.
+DRIVER = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+#include "radar_format.h"
+#include "radar_history.h"
+#include "radar_led_pattern.h"
+#include "radar_line_edit.h"
+#include "radar_occupancy.h"
+#include "radar_occupancy_rule.h"
+
+#define CHECK(condition)                                                   \
+    do                                                                     \
+    {                                                                      \
+        if (!(condition))                                                  \
+        {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            abort();                                                       \
+        }                                                                  \
+    } while (0)
+
+static volatile uint32_t sink;
+
+static double now_ns(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec * 1e9 + (double)time.tv_nsec;
+}
+
+/* led <ticks> [<tick>:<type>]...: applies the events of a tick before
+ * stepping it, prints the color written or - per tick */
+static int run_led(int argc, char **argv)
+{
+    radar_led_pattern_t pattern;
+    int ticks = atoi(argv[0]);
+    int next = 1;
+
+    radar_led_pattern_init(&pattern);
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        int at;
+        int type;
+        while ((next < argc) && (sscanf(argv[next], "%d:%d", &at, &type) == 2) && (at == tick))
+        {
+            radar_led_pattern_event(&pattern, (radar_event_record_type_t)type);
+            next++;
+        }
+        uint32_t color;
+        if (radar_led_pattern_step(&pattern, &color))
+        {
+            printf("%u ", (unsigned)color);
+        }
+        else
+        {
+            printf("- ");
+        }
+    }
+    printf("\n%u\n", (unsigned)pattern.overrides);
+    return 0;
+}
+
+/* line <size>: feeds stdin to the line editor, prints each completed line
+ * as "<result> <line>" and all echoed bytes in hex */
+static int run_line(int argc, char **argv)
+{
+    uint32_t size = (uint32_t)atoi(argv[0]);
+    char *line = malloc(size);
+    char *echo = malloc(RADAR_LINE_EDIT_ECHO_MAXLENGTH);
+    radar_line_edit_t edit;
+    int key;
+
+    CHECK((line != NULL) && (echo != NULL));
+    radar_line_edit_init(&edit, line, size);
+    while ((key = getchar()) != EOF)
+    {
+        uint32_t echo_length = 0xFFFFFFFFU;
+        radar_line_edit_result_t result = radar_line_edit_input(&edit, (uint8_t)key, echo, &echo_length);
+        CHECK(echo_length <= RADAR_LINE_EDIT_ECHO_MAXLENGTH);
+        CHECK(edit.length < size);
+        for (uint32_t i = 0; i < echo_length; i++)
+        {
+            fprintf(stderr, "%02x", (unsigned char)echo[i]);
+        }
+        if (result != RADAR_LINE_EDIT_CONTINUE)
+        {
+            CHECK(strlen(line) == edit.length);
+            printf("%d %s\n", (int)result, line);
+            radar_line_edit_init(&edit, line, size);
+        }
+    }
+    free(echo);
+    free(line);
+    return 0;
+}
+
+/* choice: prints radar_line_edit_choice for every key and 0 to 9 choices */
+static int run_choice(int argc, char **argv)
+{
+    for (int key = 0; key < 256; key++)
+    {
+        for (int choices = 0; choices <= 9; choices++)
+        {
+            printf("%d ", radar_line_edit_choice((uint8_t)key, choices));
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+/* occupancy <limit> <hysteresis> <in> <out> [<in>:<out> | L<limit>]...:
+ * initializes the rule with retained counts, then applies counts or limit
+ * changes, prints "<occupancy> <full> <changed>" after each step */
+static int run_occupancy(int argc, char **argv)
+{
+    radar_occupancy_rule_t rule;
+    radar_occupancy_rule_init(&rule,
+                              (uint32_t)strtoul(argv[0], NULL, 0),
+                              (uint32_t)strtoul(argv[1], NULL, 0),
+                              (uint32_t)strtoul(argv[2], NULL, 0),
+                              (uint32_t)strtoul(argv[3], NULL, 0));
+    printf("%u %d 0\n", (unsigned)rule.occupancy, (int)rule.full);
+    for (int i = 4; i < argc; i++)
+    {
+        unsigned in_count;
+        unsigned out_count;
+        bool full = rule.full;
+        bool changed;
+        if (argv[i][0] == 'L')
+        {
+            changed = radar_occupancy_rule_set_limit(&rule, (uint32_t)strtoul(argv[i] + 1, NULL, 0));
+        }
+        else
+        {
+            CHECK(sscanf(argv[i], "%u:%u", &in_count, &out_count) == 2);
+            changed = radar_occupancy_rule_update(&rule, in_count, out_count);
+        }
+        CHECK(changed == (full != rule.full));
+        printf("%u %d %d\n", (unsigned)rule.occupancy, (int)rule.full, (int)changed);
+    }
+    return 0;
+}
+
+/* number <text>...: prints the thousandths of each parameter value, or
+ * "invalid", and checks that valid values are formatted back the same */
+static int run_number(int argc, char **argv)
+{
+    for (int i = 0; i < argc; i++)
+    {
+        int32_t thousandths;
+        if (radar_format_parse_fixed(argv[i], &thousandths))
+        {
+            char text[16];
+            int32_t again;
+            radar_format_fixed(text, sizeof(text), thousandths);
+            CHECK(radar_format_parse_fixed(text, &again) && (again == thousandths));
+            printf("%ld\n", (long)thousandths);
+        }
+        else
+        {
+            printf("invalid\n");
+        }
+    }
+    return 0;
+}
+
+/* Stand-ins of radar_occupancy.c: the clock advances by CLOCK_STEP_US per
+ * read, a GPIO write records the level and the time since the event */
+#define CLOCK_STEP_US (7U)
+
+static uint64_t clock_now_us = 1000000U;
+static uint64_t gpio_event_us;
+static int gpio_level = -1;
+static int gpio_writes;
+static uint64_t gpio_write_us;
+static int critical_nesting;
+
+uint64_t radar_clock_us(void)
+{
+    uint64_t now_us = clock_now_us;
+    clock_now_us += CLOCK_STEP_US;
+    return now_us;
+}
+
+void stand_in_critical(int nesting)
+{
+    critical_nesting += nesting;
+    CHECK((critical_nesting == 0) || (critical_nesting == 1));
+}
+
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction, cyhal_gpio_drive_mode_t drive_mode,
+                          bool init_val)
+{
+    CHECK((pin == RADAR_OCCUPANCY_GPIO) && (gpio_level < 0));
+    gpio_level = init_val ? 1 : 0;
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value)
+{
+    CHECK((pin == RADAR_OCCUPANCY_GPIO) && (gpio_level >= 0) && (critical_nesting == 1));
+    gpio_level = value ? 1 : 0;
+    gpio_writes++;
+    gpio_write_us = clock_now_us - gpio_event_us;
+}
+
+/* gpio <in> <out> [<in>:<out> | L<limit>]...: initializes radar_occupancy.c
+ * with retained counts, then feeds counter events or limit changes, prints
+ * "<occupancy> <full> <level> <writes> <write us> <latency us>" after each
+ * step, the times of the last write */
+static void gpio_print(void)
+{
+    radar_occupancy_stats_t stats;
+    radar_occupancy_get_stats(&stats);
+    CHECK(critical_nesting == 0);
+    CHECK(stats.switches == (uint32_t)gpio_writes);
+    printf("%u %d %d %d %u %u\n",
+           (unsigned)stats.occupancy,
+           (int)stats.full,
+           gpio_level,
+           gpio_writes,
+           (unsigned)gpio_write_us,
+           (unsigned)stats.latency_last_us);
+}
+
+static int run_gpio(int argc, char **argv)
+{
+    CHECK(radar_occupancy_init((uint32_t)strtoul(argv[0], NULL, 0), (uint32_t)strtoul(argv[1], NULL, 0)) ==
+          CY_RSLT_SUCCESS);
+    gpio_print();
+    for (int i = 2; i < argc; i++)
+    {
+        unsigned in_count;
+        unsigned out_count;
+        if (argv[i][0] == 'L')
+        {
+            radar_occupancy_set_limit((uint32_t)strtoul(argv[i] + 1, NULL, 0));
+        }
+        else
+        {
+            CHECK(sscanf(argv[i], "%u:%u", &in_count, &out_count) == 2);
+            /* The callback takes the time at its entry, as
+             * radar_counter_callback does */
+            gpio_event_us = radar_clock_us();
+            radar_occupancy_update(in_count, out_count, gpio_event_us);
+        }
+        gpio_print();
+    }
+    return 0;
+}
+
+/* history: reads "<sequence> <type> <timestamp us> <in> <out> <flags>"
+ * records from stdin and prints them as chunk lines, the same way as
+ * history_export_record and radar_history_export, the chunks in hex */
+static void history_send(radar_history_chunk_t *chunk)
+{
+    size_t length = radar_history_chunk_finish(chunk);
+    CHECK(length <= sizeof(chunk->buffer));
+    printf("X ");
+    for (size_t i = 0; i < length; i++)
+    {
+        printf("%02x", chunk->buffer[i]);
+    }
+    printf("\n");
+}
+
+static int run_history(int argc, char **argv)
+{
+    radar_history_chunk_t *chunk = malloc(sizeof(radar_history_chunk_t));
+    radar_event_record_t record;
+    unsigned sequence;
+    int type;
+    unsigned long long timestamp_us;
+    unsigned in_count;
+    unsigned out_count;
+    unsigned flags;
+    uint32_t records = 0;
+
+    CHECK(chunk != NULL);
+    while (scanf("%u %d %llu %u %u %u", &sequence, &type, &timestamp_us, &in_count, &out_count, &flags) == 6)
+    {
+        record.sequence = sequence;
+        record.type = (radar_event_record_type_t)type;
+        record.sensor_id = 0U;
+        record.timestamp_us = timestamp_us;
+        record.in_count = in_count;
+        record.out_count = out_count;
+        record.flags = flags;
+        if ((records == 0U) || !radar_history_chunk_add(chunk, &record))
+        {
+            if (records > 0U)
+            {
+                history_send(chunk);
+            }
+            radar_history_chunk_init(chunk, &record);
+            CHECK(radar_history_chunk_add(chunk, &record));
+        }
+        records++;
+    }
+    if (records > 0U)
+    {
+        history_send(chunk);
+    }
+    printf("X END %u %u\n", (unsigned)records, (unsigned)chunk->next_sequence);
+    free(chunk);
+    return 0;
+}
+
+/* cost <iterations>: prints the time per iteration in ns of each case, the
+ * best of several rounds */
+static int run_cost(int argc, char **argv)
+{
+    long iterations = atol(argv[0]);
+    radar_led_pattern_t pattern;
+    radar_line_edit_t edit;
+    char line[32];
+    char echo[RADAR_LINE_EDIT_ECHO_MAXLENGTH];
+    double best_led = 1e30;
+    double best_edit = 1e30;
+
+    for (int round = 0; round < 5; round++)
+    {
+        radar_led_pattern_init(&pattern);
+        radar_led_pattern_event(&pattern, RADAR_EVENT_RECORD_TYPE_FREE);
+        double start = now_ns();
+        for (long i = 0; i < iterations; i++)
+        {
+            uint32_t color = 0;
+            if ((i % 200) == 0)
+            {
+                radar_led_pattern_event(&pattern, ((i / 200) & 1) ? RADAR_EVENT_RECORD_TYPE_OUT
+                                                                   : RADAR_EVENT_RECORD_TYPE_IN);
+            }
+            sink += radar_led_pattern_step(&pattern, &color) ? color : 0U;
+        }
+        double elapsed = (now_ns() - start) / (double)iterations;
+        best_led = (elapsed < best_led) ? elapsed : best_led;
+
+        radar_line_edit_init(&edit, line, sizeof(line));
+        start = now_ns();
+        for (long i = 0; i < iterations; i++)
+        {
+            static const uint8_t keys[] = "s12 10\b0\r";
+            uint32_t echo_length;
+            if (radar_line_edit_input(&edit, keys[i % (sizeof(keys) - 1U)], echo, &echo_length) !=
+                RADAR_LINE_EDIT_CONTINUE)
+            {
+                radar_line_edit_init(&edit, line, sizeof(line));
+            }
+            sink += echo_length;
+        }
+        elapsed = (now_ns() - start) / (double)iterations;
+        best_edit = (elapsed < best_edit) ? elapsed : best_edit;
+    }
+    printf("led_pattern_step %.1f\n", best_led);
+    printf("line_edit_input %.1f\n", best_edit);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        return 2;
+    }
+    if (strcmp(argv[1], "led") == 0)
+    {
+        return run_led(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "line") == 0)
+    {
+        return run_line(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "choice") == 0)
+    {
+        return run_choice(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "occupancy") == 0)
+    {
+        return run_occupancy(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "number") == 0)
+    {
+        return run_number(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "gpio") == 0)
+    {
+        return run_gpio(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "history") == 0)
+    {
+        return run_history(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "cost") == 0)
+    {
+        return run_cost(argc - 2, argv + 2);
+    }
+    return 2;
+}
+"""
+
+# Clock advance per radar_clock_us call of the GPIO stand-ins
+CLOCK_STEP_US = 7
+
+# radar_event_record_type_t
+IN, OUT, OCCUPIED, FREE = 1, 2, 3, 4
+# radar_line_edit_result_t
+CONTINUE, COMPLETE, TOO_LONG = 0, 1, 2
+# Size of the line buffer of the terminal UI (TERMINAL_UI_LINE_MAXLENGTH)
+LINE_SIZE = 32
+
+# Golden LED timelines as runs of "<ticks><color>": R red, G green, o off,
+# - not written; adjacent runs of the same color are merged before the
+# comparison. A blink lasts OFF_TIME ticks, lit for ON_TIME - 1 ticks, and
+# the last tick of every blink but the last one writes nothing; the last
+# blink ends by restoring the traffic light color.
+IN_GREEN = "2G 17o 1- " * 6 + "2G 17o 1G"
+IN_RED = "2R 17o 1- " * 6 + "2R 17o 1R"
+OUT_GREEN = "2G 47o 1- " * 3 + "2G 47o 1G"
+OUT_RED = "2R 47o 1- " * 3 + "2R 47o 1R"
+
+
+class Failure(Exception):
+    pass
+
+
+def expect(condition, message):
+    if not condition:
+        raise Failure(message)
+
+
+def compiler():
+    name = os.environ.get("CC") or shutil.which("cc") or shutil.which("gcc")
+    if name is None:
+        raise SystemExit("no C compiler found, set CC")
+    return name
+
+
+def build(directory, name, flags):
+    driver = os.path.join(directory, "driver.c")
+    stubs = os.path.join(directory, "stubs")
+    if not os.path.exists(driver):
+        with open(driver, "w", encoding="ascii") as driver_file:
+            driver_file.write(DRIVER)
+        os.mkdir(stubs)
+        for header, text in STUBS.items():
+            with open(os.path.join(stubs, header), "w", encoding="ascii") as header_file:
+                header_file.write(text)
+    program = os.path.join(directory, name)
+    sources = [os.path.join(ROOT, "source", source) for source in SOURCES]
+    subprocess.check_call([compiler(), "-std=gnu11", "-Wall", "-Wextra", "-Werror", "-Wno-unused-parameter",
+                           "-I" + os.path.join(ROOT, "source"), "-I" + stubs, "-o", program, driver] + sources + flags)
+    return program
+
+
+class Driver:
+    """Runs the commands of the compiled test driver."""
+
+    def __init__(self, sanitized, optimized, decoder):
+        self.sanitized = sanitized
+        self.optimized = optimized
+        self.decoder = decoder
+
+    def run(self, arguments, data=b"", optimized=False):
+        program = self.optimized if optimized else self.sanitized
+        result = subprocess.run([program] + [str(argument) for argument in arguments], input=data,
+                                stdout=subprocess.PIPE, stderr=subprocess.PIPE, check=False)
+        if result.returncode != 0:
+            raise Failure("driver %s exited with %d\n%s" % (arguments[0], result.returncode,
+                                                           result.stderr.decode(errors="replace")))
+        return result.stdout.decode("ascii"), result.stderr.decode("ascii")
+
+
+def runs(names):
+    """Run-length string of the per-tick LED colors."""
+    result = []
+    for name in names:
+        if result and result[-1][1] == name:
+            result[-1][0] += 1
+        else:
+            result.append([1, name])
+    return " ".join("%d%s" % (count, name) for count, name in result)
+
+
+def expand(golden):
+    """Per-tick colors of a golden timeline."""
+    names = []
+    for run in golden.split():
+        names += [run[-1]] * int(run[:-1])
+    return names
+
+
+def led_timeline(driver, ticks, events):
+    output, _ = driver.run(["led", ticks] + ["%d:%d" % event for event in events])
+    lines = output.split("\n")
+    names = {"-": "-", "0": "o", "1": "R", "2": "G", "4": "B"}
+    return runs(names.get(token, "<%s>" % token) for token in lines[0].split()), int(lines[1])
+
+
+def check_led(driver, ticks, events, golden, overrides=0):
+    timeline, counted = led_timeline(driver, ticks, events)
+    golden = runs(expand(golden))
+    expect(timeline == golden, "timeline\n  got      %s\n  expected %s" % (timeline, golden))
+    expect(counted == overrides, "%d overrides, expected %d" % (counted, overrides))
+
+
+def test_led_idle(driver, args):
+    check_led(driver, 10, [], "10-")
+
+
+def test_led_in_idle(driver, args):
+    # Without a zone event the LEDs are released after the pattern
+    check_led(driver, 150, [(0, IN)], IN_GREEN + " 10-")
+
+
+def test_led_out_idle(driver, args):
+    check_led(driver, 210, [(0, OUT)], OUT_GREEN + " 10-")
+
+
+def test_led_occupied_free(driver, args):
+    check_led(driver, 30, [(0, OCCUPIED), (10, FREE), (20, OCCUPIED)], "10R 10G 10R")
+
+
+def test_led_in_occupied(driver, args):
+    check_led(driver, 155, [(0, OCCUPIED), (5, IN)], "5R " + IN_RED + " 10R")
+
+
+def test_led_out_free(driver, args):
+    check_led(driver, 215, [(0, OCCUPIED), (3, FREE), (5, OUT)], "3R 2G " + OUT_GREEN + " 10G")
+
+
+def test_led_zone_during_blink(driver, args):
+    # The traffic light changes color in the middle of a blink pattern
+    golden = "2G 17o 1- " * 3 + "2R 17o 1- " * 3 + "2R 17o 1R 5R"
+    check_led(driver, 145, [(0, FREE), (0, IN), (44, OCCUPIED)], golden)
+
+
+def test_led_override(driver, args):
+    # An OUT event during an IN pattern cuts it short and starts over
+    golden = "2G 17o 1- 2G 10o " + OUT_GREEN + " 10G"
+    check_led(driver, 242, [(0, FREE), (0, IN), (32, OUT)], golden, overrides=1)
+
+
+def test_led_override_same(driver, args):
+    # A second IN during the pattern counts as override but continues it, a
+    # third one after the end starts a new pattern and does not count
+    golden = IN_GREEN + " 19G " + IN_GREEN + " 11G"
+    check_led(driver, 310, [(0, FREE), (0, IN), (9, IN), (159, IN)], golden, overrides=1)
+
+
+def model_line_edit(data, size):
+    """Lines and echo expected from radar_line_edit_input."""
+    lines = []
+    echo = bytearray()
+    line = bytearray()
+    overflow = False
+    for key in data:
+        if key in (0x0D, 0x0A):
+            echo += b"\r\n"
+            lines.append((TOO_LONG if overflow else COMPLETE, line.decode("ascii")))
+            line = bytearray()
+            overflow = False
+        elif key in (0x08, 0x7F):
+            if line:
+                line.pop()
+                echo += b"\b \b"
+        elif 0x21 <= key <= 0x7E:
+            if len(line) < size - 1:
+                line.append(key)
+                echo.append(key)
+            else:
+                overflow = True
+    return lines, bytes(echo)
+
+
+def line_edit(driver, data, size):
+    output, errors = driver.run(["line", size], data)
+    lines = []
+    for text in output.split("\n")[:-1]:
+        result, _, line = text.partition(" ")
+        lines.append((int(result), line))
+    return lines, bytes.fromhex(errors.strip())
+
+
+def check_line_edit(driver, data, size, lines):
+    got, echo = line_edit(driver, data, size)
+    expected, expected_echo = model_line_edit(data, size)
+    expect(expected == lines, "model disagrees with the expected lines %r: %r" % (lines, expected))
+    expect(got == lines, "lines %r, expected %r" % (got, lines))
+    expect(echo == expected_echo, "echo %r, expected %r" % (echo, expected_echo))
+
+
+def test_line_edit_basic(driver, args):
+    check_line_edit(driver, b"s12 10\r\n", LINE_SIZE, [(COMPLETE, "s1210"), (COMPLETE, "")])
+
+
+def test_line_edit_backspace_column0(driver, args):
+    # Backspace and delete on an empty line neither echo nor underflow
+    check_line_edit(driver, b"\b\x7f\b\rab\b\b\b\x7fc\r", LINE_SIZE, [(COMPLETE, ""), (COMPLETE, "c")])
+
+
+def test_line_edit_control_bytes(driver, args):
+    data = bytes(range(0x00, 0x20)) + b"\x80\xff\x1b[A" + b"x\r"
+    lines = [(COMPLETE, "")] * 2 + [(COMPLETE, "[Ax")]
+    check_line_edit(driver, data, LINE_SIZE, lines)
+
+
+def test_line_edit_too_long(driver, args):
+    data = b"a" * (LINE_SIZE + 10) + b"\r" + b"b" * (LINE_SIZE - 1) + b"\r"
+    check_line_edit(driver, data, LINE_SIZE, [(TOO_LONG, "a" * (LINE_SIZE - 1)), (COMPLETE, "b" * (LINE_SIZE - 1))])
+
+
+def test_line_edit_too_long_backspace(driver, args):
+    # Dropped characters are not brought back by a backspace
+    data = b"a" * LINE_SIZE + b"\b" + b"z\r"
+    check_line_edit(driver, data, LINE_SIZE, [(TOO_LONG, "a" * (LINE_SIZE - 2) + "z")])
+
+
+def test_line_edit_size1(driver, args):
+    # A buffer of one byte only holds the terminator
+    check_line_edit(driver, b"\r\bx\r", 1, [(COMPLETE, ""), (TOO_LONG, "")])
+
+
+def fuzz_input(rng, length):
+    """Random keys with long lines, control bytes and backspaces."""
+    data = bytearray()
+    while len(data) < length:
+        kind = rng.random()
+        if kind < 0.4:
+            data += bytes(rng.randrange(0x21, 0x7F) for _ in range(rng.randrange(1, 2 * LINE_SIZE)))
+        elif kind < 0.55:
+            data += bytes(rng.choice((0x08, 0x7F)) for _ in range(rng.randrange(1, LINE_SIZE)))
+        elif kind < 0.7:
+            data.append(rng.randrange(0x00, 0x20))
+        elif kind < 0.8:
+            data.append(rng.randrange(0x80, 0x100))
+        else:
+            data.append(rng.choice((0x0D, 0x0A)))
+    return bytes(data[:length])
+
+
+def test_line_edit_fuzz(driver, args):
+    rng = random.Random(args.seed)
+    for size in (1, 2, 8, LINE_SIZE):
+        data = fuzz_input(rng, args.fuzz_bytes)
+        got, echo = line_edit(driver, data, size)
+        expected, expected_echo = model_line_edit(data, size)
+        expect(len(expected) > 0, "fuzz input without complete lines")
+        for index, (line, model) in enumerate(zip(got, expected)):
+            expect(line == model, "size %d, line %d: %r, expected %r" % (size, index, line, model))
+        expect(len(got) == len(expected), "size %d: %d lines, expected %d" % (size, len(got), len(expected)))
+        expect(echo == expected_echo, "size %d: echo differs from the model" % size)
+
+
+def test_line_edit_choice(driver, args):
+    output, _ = driver.run(["choice"])
+    for key, text in enumerate(output.split("\n")[:-1]):
+        for choices, value in enumerate(int(value) for value in text.split()):
+            if chr(key) in " \t\n\v\f\r":
+                expected = -2
+            elif ord("1") <= key < ord("1") + choices:
+                expected = key - ord("1")
+            else:
+                expected = -1
+            expect(value == expected, "key 0x%02x, %d choices: %d, expected %d" % (key, choices, value, expected))
+
+
+def occupancy(driver, limit, hysteresis, retained, steps):
+    """States (occupancy, full) after the reset and after each step."""
+    arguments = ["occupancy", limit, hysteresis, retained[0], retained[1]]
+    for step in steps:
+        arguments.append("L%d" % step if isinstance(step, int) else "%d:%d" % step)
+    output, _ = driver.run(arguments)
+    return [(int(line.split()[0]), line.split()[1] == "1") for line in output.split("\n")[:-1]]
+
+
+def model_occupancy(limit, hysteresis, retained, steps):
+    """States expected from radar_occupancy_rule.c."""
+    count = max(retained[0] - retained[1], 0)
+    full = count >= limit
+    states = [(count, full)]
+    for step in steps:
+        if isinstance(step, int):
+            limit = step
+        else:
+            count = max(step[0] - step[1], 0)
+        if count >= limit:
+            full = True
+        elif count <= max(limit - hysteresis, 0):
+            full = False
+        states.append((count, full))
+    return states
+
+
+def check_occupancy(driver, limit, hysteresis, retained, steps, full):
+    states = occupancy(driver, limit, hysteresis, retained, steps)
+    expected = model_occupancy(limit, hysteresis, retained, steps)
+    expect([state[1] for state in expected] == full, "model disagrees with the expected states %r" % full)
+    expect(states == expected, "states %r, expected %r" % (states, expected))
+
+
+def test_occupancy_threshold(driver, args):
+    # Full exactly at the limit, in count minus out count
+    steps = [(1, 0), (2, 0), (3, 0), (4, 1), (4, 2)]
+    check_occupancy(driver, 3, 1, (0, 0), steps, [False, False, False, True, True, False])
+
+
+def test_occupancy_hysteresis(driver, args):
+    # Full at 5, still full at 4, free at 3, still free at 4
+    steps = [(5, 0), (5, 1), (5, 2), (6, 2), (7, 2), (7, 3)]
+    check_occupancy(driver, 5, 2, (0, 0), steps, [False, True, True, False, False, True, True])
+
+
+def test_occupancy_no_hysteresis(driver, args):
+    check_occupancy(driver, 2, 0, (0, 0), [(2, 0), (2, 1), (3, 1)], [False, True, False, True])
+
+
+def test_occupancy_more_out(driver, args):
+    # More out than in counts, e.g. people who entered before counting started
+    check_occupancy(driver, 1, 1, (3, 5), [(4, 5), (6, 5), (6, 6)], [False, False, True, False])
+
+
+def test_occupancy_hysteresis_above_limit(driver, args):
+    # An empty room is free even if the hysteresis exceeds the limit
+    check_occupancy(driver, 2, 5, (0, 0), [(2, 0), (2, 1), (2, 2)], [False, True, True, False])
+
+
+def test_occupancy_set_limit(driver, args):
+    # Lowering the limit to the occupancy fills the room at once, raising it
+    # within the hysteresis keeps the room full
+    check_occupancy(driver, 10, 2, (6, 0), [8, 6, 7, 8, 0], [False, False, True, True, False, True])
+
+
+def test_occupancy_reset(driver, args):
+    # The output is restored from the counts retained over a warm restart:
+    # full at or above the limit, free below it, also inside the hysteresis
+    for retained, full in (((12, 2), True), ((13, 2), True), ((11, 2), False), ((9, 1), False), ((0, 0), False)):
+        states = occupancy(driver, 10, 2, retained, [])
+        expect(states == [(max(retained[0] - retained[1], 0), full)],
+               "retained %r: %r, expected full %r" % (retained, states, full))
+    # After the restart the hysteresis applies again
+    check_occupancy(driver, 10, 2, (11, 1), [(11, 2), (11, 3), (12, 3)], [True, True, False, False])
+
+
+def occupancy_config():
+    """RADAR_OCCUPANCY_LIMIT and RADAR_OCCUPANCY_HYSTERESIS of radar_occupancy.h."""
+    with open(os.path.join(ROOT, "source", "radar_occupancy.h"), encoding="ascii") as header:
+        text = header.read()
+    return tuple(int(re.search(r"#define %s \((\d+)U\)" % name, text).group(1))
+                 for name in ("RADAR_OCCUPANCY_LIMIT", "RADAR_OCCUPANCY_HYSTERESIS"))
+
+
+def check_occupancy_gpio(driver, retained, steps):
+    """Runs radar_occupancy.c with the GPIO stand-in against the model."""
+    limit, hysteresis = occupancy_config()
+    arguments = ["gpio", retained[0], retained[1]]
+    arguments += ["L%d" % step if isinstance(step, int) else "%d:%d" % step for step in steps]
+    output, _ = driver.run(arguments)
+    lines = [[int(field) for field in line.split()] for line in output.split("\n")[:-1]]
+    expected = model_occupancy(limit, hysteresis, retained, steps)
+    expect(len(lines) == len(expected), "%d states, expected %d" % (len(lines), len(expected)))
+    writes = 0
+    latency_us = 0
+    for index, ((count, full, level, written, write_us, last_us), state) in enumerate(zip(lines, expected)):
+        step = steps[index - 1] if index > 0 else None
+        expect((count, full == 1) == state, "step %d: %r, expected %r" % (index, (count, full), state))
+        expect(level == full, "step %d: output %d while full is %d" % (index, level, full))
+        if index > 0 and state[1] != expected[index - 1][1]:
+            writes += 1
+            if not isinstance(step, int):
+                # The output is written before anything else reads the
+                # clock, the latency is taken after the write
+                expect(write_us == CLOCK_STEP_US, "step %d: written %d us after the event" % (index, write_us))
+                expect(last_us >= write_us, "step %d: latency %d us before the write at %d us" % (
+                    index, last_us, write_us))
+                latency_us = last_us
+        expect(written == writes, "step %d: %d writes, expected %d" % (index, written, writes))
+        expect(last_us == latency_us, "step %d: latency %d us, expected %d us" % (index, last_us, latency_us))
+
+
+def test_occupancy_gpio(driver, args):
+    limit, hysteresis = occupancy_config()
+    steps = [(count, 0) for count in range(1, limit + 2)]
+    steps += [(limit + 1, out) for out in range(1, hysteresis + 3)]
+    steps += [limit - hysteresis - 2, limit + 5, (limit + 1, 0), 1]
+    check_occupancy_gpio(driver, (0, 0), steps)
+
+
+def test_occupancy_gpio_reset(driver, args):
+    # The output starts at the level of the retained counts, without a write
+    limit, _ = occupancy_config()
+    check_occupancy_gpio(driver, (limit + 3, 2), [(limit + 3, 3), (limit + 3, 20)])
+    check_occupancy_gpio(driver, (2, 2), [])
+
+
+def test_occupancy_random(driver, args):
+    rng = random.Random(args.seed)
+    for _ in range(20):
+        limit = rng.randrange(0, 12)
+        hysteresis = rng.randrange(0, 5)
+        retained = (rng.randrange(0, 20), rng.randrange(0, 20))
+        counts = list(retained)
+        steps = []
+        for _ in range(200):
+            if rng.random() < 0.05:
+                steps.append(rng.randrange(0, 12))
+            else:
+                counts[rng.randrange(2)] += 1
+                steps.append(tuple(counts))
+        states = occupancy(driver, limit, hysteresis, retained, steps)
+        expected = model_occupancy(limit, hysteresis, retained, steps)
+        expect(states == expected, "limit %d, hysteresis %d, retained %r: %r, expected %r" % (
+            limit, hysteresis, retained, states, expected))
+
+
+def check_numbers(driver, cases):
+    output, _ = driver.run(["number"] + [text for text, _ in cases])
+    values = output.split("\n")[:-1]
+    expect(len(values) == len(cases), "%d values for %d cases" % (len(values), len(cases)))
+    for (text, expected), value in zip(cases, values):
+        value = None if value == "invalid" else int(value)
+        expect(value == expected, "%r: %r, expected %r" % (text, value, expected))
+
+
+def test_number_basic(driver, args):
+    check_numbers(driver, [("1", 1000), ("1.25", 1250), (".5", 500), ("-.5", -500), ("0", 0), ("-0", 0),
+                           ("12.", 12000), ("3.14159", 3141), ("", None), ("-", None), (".", None),
+                           ("1.2.3", None), ("1e3", None), (" 1", None), ("1 ", None), ("+1", None),
+                           ("--1", None)])
+
+
+def test_number_limits(driver, args):
+    # The integer part may not exceed (INT32_MAX - 999) / 1000 = 2147482
+    check_numbers(driver, [("2147482", 2147482000), ("2147482.999", 2147482999), ("-2147482.999", -2147482999),
+                           ("2147483", None), ("2147484", None), ("-2147483.999", None),
+                           ("2147489", None), ("4294967296", None)])
+
+
+def test_number_long(driver, args):
+    # Long digit strings neither overflow nor wrap around
+    check_numbers(driver, [("9" * 40, None), ("1" + "0" * 30, None), ("0" * 40 + "7", 7000),
+                           ("-" + "0" * 40 + "2147482", -2147482000), ("1." + "9" * 40, 1999),
+                           ("0." + "0" * 40 + "1", 0), (".0015" + "9" * 40, 1)])
+
+
+def journal_line(driver, sequence, kind=IN, sensor=0, counts=(0, 0), flags=0, timestamp_us=0):
+    """"J" line of a record as printed by terminal_ui_journal_record."""
+    record = radar_journal.Record(kind, sensor, sequence, timestamp_us, counts[0], counts[1], flags)
+    data = ctypes.create_string_buffer(radar_journal.RECORD_SIZE)
+    expect(driver.decoder.radar_event_record_encode(ctypes.byref(record), data, len(data)) == len(data),
+           "encoding failed")
+    return "J " + data.raw.hex() + "\r\n"
+
+
+def journal(driver, lines):
+    decoded = radar_journal.Journal(driver.decoder)
+    decoded.add_lines(["Enter first sequence number [0-99], press enter\r\n"] + lines)
+    return decoded
+
+
+def test_journal_roundtrip(driver, args):
+    records = [(0, 7, "IN", 1000, 1, 0, 0), (0, 8, "OCCUPIED", 2500, 1, 0, 0),
+               (0, 9, "OUT", 1 << 40, 1, 1, 1), (0, 10, "FREE", (1 << 64) - 1, 0xFFFFFFFF, 5, 1)]
+    kinds = {"IN": IN, "OUT": OUT, "OCCUPIED": OCCUPIED, "FREE": FREE}
+    lines = [journal_line(driver, record[1], kinds[record[2]], record[0], record[4:6], record[6], record[3])
+             for record in records]
+    decoded = journal(driver, lines + ["4 records\r\n", journal_line(driver, 99)])
+    expect(decoded.records == records, "records %r, expected %r" % (decoded.records, records))
+    expect(decoded.errors == [], "errors %r" % decoded.errors)
+    expect(decoded.complete, "listing not complete")
+
+
+def test_journal_corrupted(driver, args):
+    good = journal_line(driver, 1)
+    data = bytearray.fromhex(journal_line(driver, 2)[2:])
+    data[12] ^= 0x01
+    corrupted = "J " + data.hex()
+    data[0] = 2
+    data[28:32] = zlib.crc32(bytes(data[:28])).to_bytes(4, "little")
+    version = "J " + data.hex()
+    lines = [good, corrupted, version, good[:-6] + "\r\n", "J 0g\r\n", journal_line(driver, 3), "3 records"]
+    decoded = journal(driver, lines)
+    expect([record[1] for record in decoded.records] == [1, 3], "records %r" % decoded.records)
+    reasons = [error.split(": ")[-1] for error in decoded.errors]
+    expected = ["CRC mismatch", "unknown version", "wrong length", None, "1 records missing before sequence 3"]
+    expect(len(reasons) == len(expected), "errors %r" % decoded.errors)
+    for reason, wanted in zip(reasons, expected):
+        expect(wanted is None or reason == wanted, "error %r, expected %r" % (reason, wanted))
+
+
+def test_journal_gaps(driver, args):
+    lines = [journal_line(driver, sequence) for sequence in (5, 6, 9, 10, 14)] + ["5 records"]
+    decoded = journal(driver, lines)
+    tracker = decoded.trackers[0]
+    expect((tracker.gaps, tracker.lost) == (2, 5), "%d gaps, %d lost, expected 2, 5" % (tracker.gaps, tracker.lost))
+    expect(decoded.errors == ["sensor 0: 2 records missing before sequence 9",
+                              "sensor 0: 3 records missing before sequence 14"], "errors %r" % decoded.errors)
+
+
+def test_journal_wrap_duplicates(driver, args):
+    # Sequence numbers wrap at 2^32, duplicates and older records are no gaps
+    sequences = (0xFFFFFFFE, 0xFFFFFFFF, 0, 1, 1, 2, 0, 1, 2, 3)
+    decoded = journal(driver, [journal_line(driver, sequence) for sequence in sequences] + ["10 records"])
+    expect(len(decoded.records) == len(sequences), "%d records" % len(decoded.records))
+    expect(decoded.errors == [], "errors %r" % decoded.errors)
+
+
+def test_journal_sensors(driver, args):
+    # Each sensor is tracked on its own, a listing without end is incomplete
+    lines = [journal_line(driver, sequence, sensor=sensor) for sequence in range(3) for sensor in (1, 2)]
+    lines.append(journal_line(driver, 5, sensor=2))
+    decoded = journal(driver, lines)
+    expect(sorted(decoded.trackers) == [1, 2], "sensors %r" % sorted(decoded.trackers))
+    expect(decoded.errors == ["sensor 2: 2 records missing before sequence 5"], "errors %r" % decoded.errors)
+    expect(not decoded.complete, "listing without end line is complete")
+
+
+def history(driver, records):
+    """Chunk lines of records (sequence, type, timestamp us, in, out, flags)."""
+    data = "".join("%d %d %d %d %d %d\n" % record for record in records).encode("ascii")
+    output, _ = driver.run(["history"], data)
+    lines = []
+    for line in output.split("\n")[:-1]:
+        fields = line.split()
+        if fields[1] != "END":
+            line = "X " + base64.b64encode(bytes.fromhex(fields[1])).decode("ascii")
+        lines.append(line + "\r\n")
+    return lines
+
+
+def check_history(driver, records, chunks=None):
+    lines = history(driver, records)
+    decoded, resume, complete = radar_history.decode_lines(lines)
+    names = {IN: "IN", OUT: "OUT", OCCUPIED: "OCCUPIED", FREE: "FREE"}
+    expected = [(record[0], names[record[1]], record[2] // 1000, record[3], record[4], record[5] & 1)
+                for record in records]
+    expect(complete, "export not complete")
+    expect(resume == (records[-1][0] + 1) & 0xFFFFFFFF, "resume at %r" % resume)
+    for index, (record, wanted) in enumerate(zip(decoded, expected)):
+        expect(record == wanted, "record %d: %r, expected %r" % (index, record, wanted))
+    expect(len(decoded) == len(expected), "%d records, expected %d" % (len(decoded), len(expected)))
+    if chunks is not None:
+        expect(len(lines) - 1 == chunks, "%d chunks, expected %d" % (len(lines) - 1, chunks))
+
+
+def crossings(sequence, timestamp_us, counts, number, flags=0, step_us=1500000):
+    """Alternating IN and OUT records with increasing timestamps."""
+    records = []
+    in_count, out_count = counts
+    for _ in range(number):
+        if sequence % 3 == 2:
+            out_count += 1
+            kind = OUT
+        else:
+            in_count += 1
+            kind = IN
+        records.append((sequence, kind, timestamp_us, in_count, out_count, flags))
+        sequence += 1
+        timestamp_us += step_us
+    return records
+
+
+def test_history_roundtrip(driver, args):
+    records = crossings(100, 5000000, (0, 0), 40)
+    records.insert(10, (110, OCCUPIED, records[9][2] + 10, records[9][3], records[9][4], 0))
+    records = [(index + 100,) + record[1:] for index, record in enumerate(records)]
+    check_history(driver, records, chunks=2)
+
+
+def test_history_reset(driver, args):
+    # The clock restarts at a warm reset while the sequence numbers and the
+    # counts continue, a cold reset also restarts the counts
+    before = crossings(10, 3600000000, (5, 3), 5)
+    warm = crossings(15, 2100000, before[-1][3:5], 5)
+    cold = crossings(21, 1900000, (0, 0), 5)
+    check_history(driver, before + warm + cold, chunks=3)
+
+
+def test_history_same_ms(driver, args):
+    # Timestamps within the same millisecond and a reset to the same time
+    records = [(1, IN, 5000900, 1, 0, 0), (2, OUT, 5000100, 1, 1, 0), (3, IN, 5000000, 2, 1, 0),
+               (4, IN, 4999999, 3, 1, 0)]
+    check_history(driver, records, chunks=2)
+
+
+def test_history_synced(driver, args):
+    # Synchronization switches to the gateway timebase and back after a reset
+    epoch_us = 1700000000 * 1000000
+    local = crossings(1, 60000000, (0, 0), 4)
+    synced = crossings(5, epoch_us, local[-1][3:5], 4, flags=1)
+    reset = crossings(9, 2000000, synced[-1][3:5], 4)
+    resynced = crossings(13, epoch_us + 30000000, reset[-1][3:5], 4, flags=1)
+    check_history(driver, local + synced + reset + resynced, chunks=4)
+
+
+def test_history_random(driver, args):
+    rng = random.Random(args.seed)
+    records = []
+    sequence = rng.randrange(0, 1 << 32)
+    timestamp_us = rng.randrange(0, 1 << 40)
+    counts = [0, 0]
+    flags = 0
+    for _ in range(2000):
+        event = rng.random()
+        if event < 0.02:
+            timestamp_us = rng.randrange(0, 10000000)
+            if rng.random() < 0.5:
+                counts = [0, 0]
+        elif event < 0.04:
+            flags ^= 1
+            timestamp_us = rng.randrange(0, 1 << 44)
+        elif event < 0.06:
+            sequence = (sequence + rng.randrange(1, 1000)) & 0xFFFFFFFF
+        kind = rng.choice((IN, IN, OUT, OUT, OCCUPIED, FREE))
+        if kind in (IN, OUT):
+            counts[kind - IN] = (counts[kind - IN] + 1) & 0xFFFFFFFF
+        if rng.random() < 0.05:
+            counts[rng.randrange(2)] = rng.randrange(0, 1 << 32)
+        timestamp_us += rng.randrange(0, 5000000)
+        records.append((sequence, kind, timestamp_us, counts[0], counts[1], flags))
+        sequence = (sequence + 1) & 0xFFFFFFFF
+    check_history(driver, records)
+
+
+def test_cost(driver, args):
+    output, _ = driver.run(["cost", args.iterations], optimized=True)
+    for text in output.split("\n")[:-1]:
+        name, cost = text.split()
+        print("  %-20s %8.1f ns per iteration" % (name, float(cost)))
+        expect(float(cost) < args.max_ns, "%s takes %s ns, more than %d ns" % (name, cost, args.max_ns))
+
+
+TESTS = [(name[len("test_"):], function) for name, function in list(globals().items()) if name.startswith("test_")]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-k", "--filter", default="", help="run the tests whose name contains this text")
+    parser.add_argument("--seed", type=int, default=1, help="random seed of the fuzz input")
+    parser.add_argument("--fuzz-bytes", type=int, default=200000, help="fuzz input length per buffer size")
+    parser.add_argument("--iterations", type=int, default=1000000, help="iterations of the cost measurement")
+    parser.add_argument("--max-ns", type=int, default=1000, help="highest cost per iteration in ns")
+    args = parser.parse_args()
+
+    failed = []
+    with tempfile.TemporaryDirectory() as directory:
+        driver = Driver(build(directory, "driver_sanitized", SANITIZE),
+                        build(directory, "driver_optimized", ["-O2"]),
+                        radar_journal.load_decoder(directory))
+        for name, function in TESTS:
+            if args.filter not in name:
+                continue
+            try:
+                function(driver, args)
+            except Failure as failure:
+                failed.append(name)
+                print("FAIL %s: %s" % (name, failure))
+                continue
+            print("PASS %s" % name)
+
+    if failed:
+        print("%d failed: %s" % (len(failed), ", ".join(failed)), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Decodes and verifies the journal records printed by the entrance counter.
+
+Press 'j' in the terminal and enter a sequence number to print the event
+journal from that number on as "J <hex>" lines, one binary record of
+source/radar_event_record.h per line. This script reads the lines from a
+saved terminal log, or requests them over the serial port, and decodes them
+with the firmware decoder: source/radar_event_record.c is compiled into a
+shared library, so the version and CRC checks and the sequence tracking of
+radar_event_record_track are the shipped code, not a copy of it.
+
+Records are written as CSV: sensor id, sequence, type, timestamp in
+microseconds, in and out count, and whether the timestamp is in the
+timebase of the gateway. Corrupted records, records of an unknown version
+and gaps in the sequence numbers of each sensor, i.e. records lost before
+they reached the journal or overwritten in it, are reported and make the
+script exit with status 1.
+
+    python3 radar_journal.py --log terminal.log > journal.csv
+    python3 radar_journal.py --port /dev/ttyACM0 --since 0 > journal.csv
+
+Needs a C compiler (cc or $CC). Serial downloads need pyserial.
+"""
+
+import argparse
+import ctypes
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SOURCE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "source")
+SOURCES = ("radar_crc.c", "radar_event_record.c")
+RECORD_SIZE = 32
+FLAG_SYNCED = 0x1
+TYPES = {1: "IN", 2: "OUT", 3: "OCCUPIED", 4: "FREE"}
+# radar_event_record_status_t
+STATUS = ("ok", "wrong length", "unknown version", "CRC mismatch")
+
+
+class Record(ctypes.Structure):
+    """radar_event_record_t"""
+    _fields_ = [("type", ctypes.c_int),
+                ("sensor_id", ctypes.c_uint16),
+                ("sequence", ctypes.c_uint32),
+                ("timestamp_us", ctypes.c_uint64),
+                ("in_count", ctypes.c_uint32),
+                ("out_count", ctypes.c_uint32),
+                ("flags", ctypes.c_uint32)]
+
+
+class Tracker(ctypes.Structure):
+    """radar_event_record_tracker_t"""
+    _fields_ = [("started", ctypes.c_bool),
+                ("next_sequence", ctypes.c_uint32),
+                ("gaps", ctypes.c_uint32),
+                ("lost", ctypes.c_uint32)]
+
+
+def load_decoder(directory):
+    compiler = os.environ.get("CC") or shutil.which("cc") or shutil.which("gcc")
+    if compiler is None:
+        raise SystemExit("no C compiler found, set CC")
+    library = os.path.join(directory, "radar_event_record.so")
+    subprocess.check_call([compiler, "-O2", "-shared", "-fPIC", "-I" + SOURCE, "-o", library] +
+                          [os.path.join(SOURCE, name) for name in SOURCES])
+    decoder = ctypes.CDLL(library)
+    decoder.radar_event_record_encode.argtypes = [ctypes.POINTER(Record), ctypes.c_char_p, ctypes.c_size_t]
+    decoder.radar_event_record_encode.restype = ctypes.c_size_t
+    decoder.radar_event_record_decode.argtypes = [ctypes.c_char_p, ctypes.c_size_t, ctypes.POINTER(Record)]
+    decoder.radar_event_record_decode.restype = ctypes.c_int
+    decoder.radar_event_record_tracker_init.argtypes = [ctypes.POINTER(Tracker)]
+    decoder.radar_event_record_tracker_init.restype = None
+    decoder.radar_event_record_track.argtypes = [ctypes.POINTER(Tracker), ctypes.POINTER(Record)]
+    decoder.radar_event_record_track.restype = ctypes.c_uint32
+    return decoder
+
+
+class Journal:
+    """Records decoded from "J" lines, with the problems found."""
+
+    def __init__(self, decoder):
+        self.decoder = decoder
+        self.records = []
+        self.errors = []
+        self.trackers = {}
+        self.complete = False
+
+    def add_line(self, line):
+        """Decodes one terminal line, returns False at the end of the listing."""
+        line = line.strip()
+        if line.endswith(" records") and line.split()[0].isdigit():
+            self.complete = True
+            return False
+        if not line.startswith("J "):
+            return True
+        try:
+            data = bytes.fromhex(line[2:])
+        except ValueError:
+            self.errors.append("bad hex line %r" % line)
+            return True
+        record = Record()
+        status = self.decoder.radar_event_record_decode(data, len(data), ctypes.byref(record))
+        if len(data) > RECORD_SIZE:
+            status = 1
+        if status != 0:
+            self.errors.append("bad record after %d records: %s" % (len(self.records), STATUS[status]))
+            return True
+        tracker = self.trackers.get(record.sensor_id)
+        if tracker is None:
+            tracker = self.trackers[record.sensor_id] = Tracker()
+            self.decoder.radar_event_record_tracker_init(ctypes.byref(tracker))
+        missing = self.decoder.radar_event_record_track(ctypes.byref(tracker), ctypes.byref(record))
+        if missing:
+            self.errors.append("sensor %d: %d records missing before sequence %d" % (
+                record.sensor_id, missing, record.sequence))
+        self.records.append((record.sensor_id, record.sequence, TYPES.get(record.type, str(record.type)),
+                             record.timestamp_us, record.in_count, record.out_count,
+                             1 if record.flags & FLAG_SYNCED else 0))
+        return True
+
+    def add_lines(self, lines):
+        for line in lines:
+            if not self.add_line(line):
+                return
+
+
+def serial_lines(port):
+    while True:
+        line = port.readline()
+        if not line:
+            return
+        yield line.decode("ascii", errors="replace")
+
+
+def download(journal, device, since):
+    import serial
+
+    with serial.Serial(device, 115200, timeout=5) as port:
+        port.reset_input_buffer()
+        port.write(b"j")
+        port.write(("%d\r" % since).encode("ascii"))
+        journal.add_lines(serial_lines(port))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--log", help="terminal log with journal lines")
+    source.add_argument("--port", help="serial port of the kit")
+    parser.add_argument("--since", type=int, default=0, help="first sequence number to download")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        journal = Journal(load_decoder(directory))
+        if args.log:
+            with open(args.log, encoding="ascii", errors="replace") as log:
+                journal.add_lines(log)
+        else:
+            download(journal, args.port, args.since)
+
+    print("sensor,sequence,type,timestamp_us,in,out,synced")
+    for record in journal.records:
+        print("%d,%d,%s,%d,%d,%d,%d" % record)
+
+    for error in journal.errors:
+        print(error, file=sys.stderr)
+    if not journal.complete:
+        print("journal listing incomplete", file=sys.stderr)
+    for sensor, tracker in sorted(journal.trackers.items()):
+        print("sensor %d: %d gaps, %d records lost" % (sensor, tracker.gaps, tracker.lost), file=sys.stderr)
+    if journal.errors or not journal.complete:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
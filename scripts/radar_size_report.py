@@ -0,0 +1,289 @@
+#!/usr/bin/env python3
+"""Reports the flash and RAM used per module from a GNU ld map file.
+
+The input sections of the map file are summed per module: application
+sources by file name, library objects by the library they are built from
+(e.g. freertos, mtb-pdl-cat1), toolchain archives by archive name. Space the
+linker reserves without an input section, e.g. the heap, is reported as
+"(<section>)". A memory region with write access counts as RAM, all others
+as flash; initialized data counts for both.
+
+With --baseline, the report is compared against a budget file: the build
+fails if the total flash exceeds the "budget" limit, if the heap left by
+the linker script is smaller than the "heap_min" limit, or if the total or
+any module grows by more than --tolerance bytes against the "modules" of
+the last accepted build. A missing budget file fails as well. The
+CONFIG=Release-Min build runs this check after linking (see Makefile).
+After an intended change, write the new baseline with --update, which
+keeps the budget limits, and commit it with the change.
+
+    python3 radar_size_report.py --map build/CYSBSYSKIT-DEV-01/Release-Min/mtb-example-radar-entrance-counter.map
+    python3 radar_size_report.py --map app.map --baseline scripts/radar_size_baseline.json
+    python3 radar_size_report.py --map app.map --baseline scripts/radar_size_baseline.json --update
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+HEX = r"0x([0-9a-fA-F]+)"
+# ".text  0x10002000  0x5a34" with an optional "load address 0x10008000";
+# after a long name, the numbers follow on the next line
+OUTPUT_RE = re.compile(r"^(\S+)?\s+" + HEX + r"\s+" + HEX + r"(?:\s+load address " + HEX + r")?\s*$")
+# " .text.name  0x10002000  0x40 path"; after a long name, "  0x10002000  0x40 path"
+INPUT_RE = re.compile(r"^ (\S+)\s+" + HEX + r"\s+" + HEX + r"\s*(.*)$")
+CONTINUATION_RE = re.compile(r"^\s+" + HEX + r"\s+" + HEX + r"\s*(.*)$")
+NAME_RE = re.compile(r"^ ?(\S+)\s*$")
+REGION_RE = re.compile(r"^(\S+)\s+" + HEX + r"\s+" + HEX + r"\s*(\S*)")
+ARCHIVE_RE = re.compile(r"([^/\\]+)\.a\(([^)]+)\)$")
+LIBRARY_DIRS = ("mtb_shared", "libs", "ext")
+# Module of the heap the linker script reserves up to the stack
+HEAP_MODULE = "(.heap)"
+
+
+class Region:
+    def __init__(self, name, origin, length, attributes):
+        self.name = name
+        self.origin = origin
+        self.length = length
+        self.ram = "w" in attributes
+
+    def contains(self, address):
+        return self.origin <= address < self.origin + self.length
+
+
+def module_name(path):
+    """Maps an object file to the module it is counted for."""
+    path = path.strip()
+    if not path:
+        return "(fill)"
+    match = ARCHIVE_RE.search(path)
+    if match:
+        return match.group(1)
+    parts = re.split(r"[/\\]", path)
+    for directory in LIBRARY_DIRS:
+        if directory in parts[:-1]:
+            index = parts.index(directory)
+            if index + 1 < len(parts) - 1:
+                return parts[index + 1]
+    return os.path.splitext(parts[-1])[0]
+
+
+def parse_map(lines):
+    """Returns {module: {"flash": bytes, "ram": bytes}} for a map file."""
+    regions = []
+    usage = {}
+    section = None
+    pending = None  # output or input section name waiting for its numbers
+    part = None
+
+    def region_of(address):
+        for region in regions:
+            if region.contains(address):
+                return region
+        return None
+
+    def add(module, address, size, load):
+        region = region_of(address)
+        if region is None or size == 0:
+            return
+        entry = usage.setdefault(module, {"flash": 0, "ram": 0})
+        entry["ram" if region.ram else "flash"] += size
+        # initialized data is also stored in flash
+        if load is not None and region.ram:
+            load_region = region_of(load)
+            if load_region is not None and not load_region.ram:
+                entry["flash"] += size
+
+    def open_section(name, match):
+        return {"name": name, "address": int(match.group(2), 16), "size": int(match.group(3), 16), "used": 0,
+                "load": int(match.group(4), 16) if match.group(4) else None}
+
+    def close_section():
+        # space of the output section without an input section, e.g. the heap
+        if section is not None and section["size"] > section["used"]:
+            add("(%s)" % section["name"], section["address"], section["size"] - section["used"], section["load"])
+
+    def add_input(name, address, size, path):
+        if section is None:
+            return
+        load = None
+        if section["load"] is not None:
+            load = section["load"] + (address - section["address"])
+        add("(fill)" if name == "*fill*" else module_name(path), address, size, load)
+        section["used"] += size
+
+    for line in lines:
+        line = line.rstrip("\r\n")
+        if line.startswith("Memory Configuration"):
+            part = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            part = "map"
+            continue
+        if part == "memory":
+            match = REGION_RE.match(line)
+            if match and match.group(1) not in ("Name", "*default*"):
+                regions.append(Region(match.group(1), int(match.group(2), 16), int(match.group(3), 16),
+                                      match.group(4)))
+            continue
+        if part != "map" or not line.strip():
+            continue
+
+        if not line[0].isspace():
+            close_section()
+            section = None
+            pending = None
+            match = OUTPUT_RE.match(line)
+            if match and match.group(1):
+                section = open_section(match.group(1), match)
+            elif NAME_RE.match(line) and line.startswith("."):
+                pending = ("output", line.strip())
+            continue
+
+        if pending is not None:
+            kind, name = pending
+            pending = None
+            if kind == "output":
+                match = OUTPUT_RE.match(line)
+                if match and not match.group(1):
+                    section = open_section(name, match)
+                continue
+            match = CONTINUATION_RE.match(line)
+            if match and not match.group(3).startswith("0x"):
+                add_input(name, int(match.group(1), 16), int(match.group(2), 16), match.group(3))
+                continue
+
+        match = INPUT_RE.match(line)
+        if match and not match.group(1).startswith("*(") and not match.group(4).startswith("0x"):
+            add_input(match.group(1), int(match.group(2), 16), int(match.group(3), 16), match.group(4))
+            continue
+        match = NAME_RE.match(line)
+        if match and line.startswith(" ") and not line.startswith("  ") and not match.group(1).startswith("*("):
+            pending = ("input", match.group(1))
+
+    close_section()
+    return usage
+
+
+def totals(usage):
+    return {
+        "flash": sum(entry["flash"] for entry in usage.values()),
+        "ram": sum(entry["ram"] for entry in usage.values()),
+    }
+
+
+def print_report(usage, baseline):
+    print("%-32s %10s %10s %10s %10s" % ("module", "flash", "delta", "ram", "delta"))
+    modules = sorted(set(usage) | set(baseline), key=lambda name: -usage.get(name, {"flash": 0})["flash"])
+    for name in modules:
+        entry = usage.get(name, {"flash": 0, "ram": 0})
+        base = baseline.get(name)
+        print("%-32s %10d %10s %10d %10s" % (
+            name[:32], entry["flash"], delta_text(entry["flash"], base, "flash"),
+            entry["ram"], delta_text(entry["ram"], base, "ram")))
+    total = totals(usage)
+    base_total = totals(baseline) if baseline else None
+    print("%-32s %10d %10s %10d %10s" % (
+        "total", total["flash"], delta_text(total["flash"], base_total, "flash"),
+        total["ram"], delta_text(total["ram"], base_total, "ram")))
+
+
+def delta_text(value, base, key):
+    if base is None:
+        return ""
+    return "%+d" % (value - base[key])
+
+
+def check(usage, baseline, tolerance):
+    """Returns the budget violations as text lines."""
+    violations = []
+    for name, entry in sorted(usage.items()):
+        base = baseline.get(name, {"flash": 0, "ram": 0})
+        for key in ("flash", "ram"):
+            if entry[key] > base[key] + tolerance:
+                violations.append("%s %s grew by %d bytes to %d" % (name, key, entry[key] - base[key], entry[key]))
+    total = totals(usage)
+    base_total = totals(baseline)
+    for key in ("flash", "ram"):
+        if total[key] > base_total[key] + tolerance:
+            violations.append("total %s grew by %d bytes to %d" % (key, total[key] - base_total[key], total[key]))
+    return violations
+
+
+def check_budget(usage, budget):
+    """Returns the violations of the budget limits as text lines."""
+    violations = []
+    total = totals(usage)
+    if "flash" in budget and total["flash"] > budget["flash"]:
+        violations.append("total flash of %d bytes exceeds the budget of %d" % (total["flash"], budget["flash"]))
+    if "heap_min" in budget:
+        heap = usage.get(HEAP_MODULE, {"ram": 0})["ram"]
+        if heap < budget["heap_min"]:
+            violations.append("heap of %d bytes is below the minimum of %d" % (heap, budget["heap_min"]))
+    return violations
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--map", required=True, help="map file written by the linker")
+    parser.add_argument("--baseline", help="budget file to compare against")
+    parser.add_argument("--update", action="store_true", help="write the report to the budget file")
+    parser.add_argument("--tolerance", type=int, default=64, help="allowed growth in bytes")
+    parser.add_argument("--json", help="also write the report to this file")
+    args = parser.parse_args()
+
+    with open(args.map, encoding="utf-8", errors="replace") as map_file:
+        usage = parse_map(map_file)
+    if not usage:
+        raise SystemExit("%s: no sections in known memory regions" % args.map)
+
+    baseline = {}
+    budget = {}
+    if args.baseline:
+        if os.path.exists(args.baseline):
+            with open(args.baseline, encoding="utf-8") as baseline_file:
+                budget_file = json.load(baseline_file)
+            budget = budget_file.get("budget", {})
+            if not args.update:
+                baseline = budget_file.get("modules") or {}
+        elif not args.update:
+            raise SystemExit("%s not found, write it with --update" % args.baseline)
+
+    print_report(usage, baseline)
+    report = {"map": os.path.basename(args.map), "totals": totals(usage), "modules": usage}
+    if budget:
+        report["budget"] = budget
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as json_file:
+            json.dump(report, json_file, indent=2, sort_keys=True)
+            json_file.write("\n")
+    if args.update:
+        if not args.baseline:
+            raise SystemExit("--update needs --baseline")
+        with open(args.baseline, "w", encoding="utf-8") as baseline_file:
+            json.dump(report, baseline_file, indent=2, sort_keys=True)
+            baseline_file.write("\n")
+        print("baseline %s updated" % args.baseline)
+        return
+
+    if args.baseline:
+        violations = check_budget(usage, budget)
+        grown = check(usage, baseline, args.tolerance) if baseline else []
+        violations += grown
+        if not baseline:
+            print("%s has no module sizes yet, only the budget limits are checked; write them with --update" %
+                  args.baseline, file=sys.stderr)
+        for violation in violations:
+            print("budget exceeded: %s" % violation, file=sys.stderr)
+        if grown:
+            print("if intended, update the baseline: %s --map %s --baseline %s --update" % (
+                sys.argv[0], args.map, args.baseline), file=sys.stderr)
+        if violations:
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
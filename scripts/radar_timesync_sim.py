@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+"""Simulates the time synchronization of several entrance counters.
+
+Each simulated sensor has a local clock that starts at a random time and
+runs off by a random drift that wanders slowly, like a crystal warming up.
+A gateway sends its reference time to all sensors as "y<ms>\\r" lines (see
+terminal_ui_sync_complete); the line arrives after the UART transmission
+time, which the firmware compensates, plus interrupt jitter and, now and
+then, a late write of the gateway. The firmware estimator in
+source/radar_timesync.c is compiled into a shared library and fed with the
+same local and reference timestamps as on the target, so the simulation
+checks the shipped code, not a model of it.
+
+Between the syncs, events are timestamped on every sensor at random times
+and converted into the reference timebase. The report shows per sensor the
+time until the error stays below --tolerance, the error after that and the
+estimated drift, and the largest disagreement between the sensors about the
+time of the same event.
+
+    python3 radar_timesync_sim.py
+    python3 radar_timesync_sim.py --devices 8 --interval 60 --hours 12 --step 6
+
+Needs a C compiler (cc or $CC).
+"""
+
+import argparse
+import ctypes
+import math
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SOURCE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "source", "radar_timesync.c")
+RESULTS = ("accepted", "rejected", "restarted")
+# Larger than radar_timesync_t, the script does not depend on its layout
+STATE_SIZE = 4096
+BAUDRATE = 115200
+CHAR_US = 10000000 // BAUDRATE
+
+
+def load_estimator(directory):
+    compiler = os.environ.get("CC") or shutil.which("cc") or shutil.which("gcc")
+    if compiler is None:
+        raise SystemExit("no C compiler found, set CC")
+    library = os.path.join(directory, "radar_timesync.so")
+    subprocess.check_call([compiler, "-O2", "-shared", "-fPIC", "-o", library, SOURCE])
+    estimator = ctypes.CDLL(library)
+    estimator.radar_timesync_init.argtypes = [ctypes.c_void_p]
+    estimator.radar_timesync_init.restype = None
+    estimator.radar_timesync_update.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint64]
+    estimator.radar_timesync_update.restype = ctypes.c_int
+    estimator.radar_timesync_to_reference.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+    estimator.radar_timesync_to_reference.restype = ctypes.c_uint64
+    return estimator
+
+
+class Device:
+    """Sensor with a drifting local clock and its own estimator state."""
+
+    def __init__(self, estimator, rng, args):
+        self.estimator = estimator
+        self.state = ctypes.create_string_buffer(STATE_SIZE)
+        estimator.radar_timesync_init(self.state)
+        self.rng = rng
+        self.args = args
+        # local clock: local = boot_us + integral of (1 + drift) over true time
+        self.boot_us = rng.uniform(0.0, 3600e6)
+        self.drift = rng.uniform(-args.drift, args.drift) * 1e-6
+        self.local_us = self.boot_us
+        self.true_us = 0.0
+        self.converged_us = None
+        self.errors = []
+        self.results = dict.fromkeys(RESULTS, 0)
+
+    def advance(self, true_us):
+        """Runs the local clock up to a true time, the drift wanders on the way."""
+        step = true_us - self.true_us
+        self.local_us += step * (1.0 + self.drift)
+        self.true_us = true_us
+        wander = self.args.wander * 1e-6 * math.sqrt(step / 3600e6)
+        limit = 2 * self.args.drift * 1e-6
+        self.drift = max(-limit, min(limit, self.drift + self.rng.gauss(0.0, wander)))
+
+    def local(self):
+        return int(self.local_us)
+
+    def sync(self, reference_us, line_length):
+        """Receives the line "y<reference ms>" sent at the current true time."""
+        args = self.args
+        arrival_us = (line_length + 2) * CHAR_US + self.rng.uniform(0.0, args.isr_jitter)
+        if self.rng.random() < args.late:
+            arrival_us += self.rng.uniform(0.0, args.late_ms * 1000.0)
+        self.advance(self.true_us + arrival_us)
+        compensated_us = reference_us + (line_length + 2) * CHAR_US
+        result = self.estimator.radar_timesync_update(self.state, self.local(), int(compensated_us))
+        self.results[RESULTS[result]] += 1
+
+    def to_reference(self, local_us):
+        return self.estimator.radar_timesync_to_reference(self.state, local_us)
+
+    def estimated_drift(self):
+        """Drift of the local clock in ppm, as estimated by the firmware."""
+        base = self.local()
+        reference_ppb = self.to_reference(base + 1000000000) - self.to_reference(base) - 1000000000
+        return -reference_ppb / 1000.0
+
+
+def simulate(args):
+    rng = random.Random(args.seed)
+    with tempfile.TemporaryDirectory() as directory:
+        estimator = load_estimator(directory)
+        devices = [Device(estimator, rng, args) for _ in range(args.devices)]
+        # reference = true time + epoch + gateway step, both in microseconds
+        epoch_us = 1700000000 * 1000000
+        step_us = 0
+        interval_us = args.interval * 1e6
+        end_us = args.hours * 3600e6
+        step_at_us = args.step * 3600e6 if args.step else None
+        true_us = 0.0
+        disagreement = []
+
+        while true_us < end_us:
+            if step_at_us is not None and true_us >= step_at_us:
+                # the gateway clock is set, e.g. by NTP after a long outage
+                step_us += int(args.step_ms * 1000)
+                step_at_us = None
+
+            # the gateway reads its clock, quantized to its resolution
+            reference_us = epoch_us + true_us + step_us + rng.gauss(0.0, args.gateway_jitter)
+            reference_us = int(reference_us // args.resolution) * args.resolution
+            text = "%d.%03d" % (reference_us // 1000, reference_us % 1000)
+            for device in devices:
+                device.advance(true_us)
+                device.sync(reference_us, len(text))
+
+            # events between this sync and the next one, seen by all sensors
+            # after the slowest line arrival, in order since the clocks only run forward
+            first_us = true_us + args.late_ms * 1000.0 + 1000.0
+            for event_us in sorted(rng.uniform(first_us, true_us + interval_us) for _ in range(args.events)):
+                expected_us = epoch_us + event_us + step_us
+                times = []
+                for device in devices:
+                    device.advance(event_us)
+                    error_us = device.to_reference(device.local()) - expected_us
+                    times.append(error_us)
+                    if abs(error_us) <= args.tolerance * 1000:
+                        if device.converged_us is None:
+                            device.converged_us = event_us
+                    else:
+                        device.converged_us = None
+                        device.errors = []
+                    if device.converged_us is not None:
+                        device.errors.append(error_us)
+                if all(device.converged_us is not None for device in devices):
+                    disagreement.append(max(times) - min(times))
+            true_us += interval_us
+
+    return devices, disagreement
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--devices", type=int, default=4, help="number of sensors")
+    parser.add_argument("--hours", type=float, default=6.0, help="simulated time")
+    parser.add_argument("--interval", type=float, default=30.0, help="seconds between sync lines")
+    parser.add_argument("--events", type=int, default=5, help="events per sync interval")
+    parser.add_argument("--drift", type=float, default=50.0, help="largest initial clock drift in ppm")
+    parser.add_argument("--wander", type=float, default=1.0, help="drift random walk in ppm per square root hour")
+    parser.add_argument("--gateway-jitter", type=float, default=200.0, help="gateway timestamp jitter in us")
+    parser.add_argument("--resolution", type=int, default=1, help="gateway clock resolution in us")
+    parser.add_argument("--isr-jitter", type=float, default=50.0, help="interrupt latency jitter in us")
+    parser.add_argument("--late", type=float, default=0.02, help="share of lines written late")
+    parser.add_argument("--late-ms", type=float, default=100.0, help="largest delay of a late line in ms")
+    parser.add_argument("--step", type=float, default=0.0, help="hour at which the gateway clock steps, 0 never")
+    parser.add_argument("--step-ms", type=float, default=2000.0, help="size of the gateway clock step in ms")
+    parser.add_argument("--tolerance", type=float, default=1.0, help="error bound for convergence in ms")
+    parser.add_argument("--seed", type=int, default=1, help="random seed")
+    args = parser.parse_args()
+
+    devices, disagreement = simulate(args)
+
+    print("device  drift ppm  estimated ppm  converged s  rms us  max us  accepted  rejected  restarted")
+    failed = False
+    for index, device in enumerate(devices):
+        if device.converged_us is None or not device.errors:
+            failed = True
+            converged = "never"
+            rms = peak = float("nan")
+        else:
+            converged = "%.0f" % (device.converged_us / 1e6)
+            rms = math.sqrt(sum(error * error for error in device.errors) / len(device.errors))
+            peak = max(abs(error) for error in device.errors)
+        print("%6d  %9.2f  %13.2f  %11s  %6.0f  %6.0f  %8d  %8d  %9d" % (
+            index, device.drift * 1e6, device.estimated_drift(), converged, rms, peak,
+            device.results["accepted"], device.results["rejected"], device.results["restarted"]))
+    if disagreement:
+        disagreement.sort()
+        print("disagreement between sensors: median %.0f us, max %.0f us" % (
+            disagreement[len(disagreement) // 2], disagreement[-1]))
+    if failed:
+        print("not all sensors converged within %.1f ms" % args.tolerance, file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Converts a trace dump of the radar entrance counter to Chrome trace JSON.
+
+Build with "make build RADAR_TRACE=1", press 'T' in the terminal and save
+the terminal output. The "T ..." lines of the dump (see source/radar_trace.c)
+are converted into a JSON file that can be opened in chrome://tracing or
+https://ui.perfetto.dev:
+
+    python3 radar_trace.py terminal.log trace.json
+
+The CPU track shows which task runs. Each task is shown as a thread with
+the radar processing calls, counter callbacks, terminal mutex waits and
+UART writes of the task as nested slices, and received UART data as
+instant events.
+"""
+
+import argparse
+import json
+import sys
+
+TASK_SWITCH = 0x01
+PROCESS_START = 0x02
+PROCESS_END = 0x03
+CALLBACK_ENTER = 0x04
+CALLBACK_EXIT = 0x05
+MUTEX_WAIT = 0x06
+MUTEX_TAKE = 0x07
+MUTEX_GIVE = 0x08
+UART_TX_START = 0x09
+UART_TX_END = 0x0A
+UART_RX = 0x0B
+
+PID = 1
+ISR_TID = 0
+CPU_TID = 1000
+
+
+def parse(lines):
+    clock = None
+    tasks = {}
+    records = []
+    for line in lines:
+        fields = line.strip().split(None, 3)
+        if len(fields) < 2 or fields[0] != "T":
+            continue
+        if fields[1] == "CLOCK":
+            clock = int(fields[2])
+        elif fields[1] == "TASK":
+            tasks[int(fields[2])] = fields[3] if len(fields) > 3 else fields[2]
+        elif fields[1] == "END":
+            break
+        elif len(fields) == 4:
+            records.append((int(fields[1], 16), int(fields[2], 16), int(fields[3], 16)))
+    if clock is None:
+        raise SystemExit("no trace dump found")
+    return clock, tasks, records
+
+
+def convert(clock, tasks, records):
+    events = [{"ph": "M", "pid": PID, "tid": ISR_TID, "name": "thread_name", "args": {"name": "interrupts"}},
+              {"ph": "M", "pid": PID, "tid": CPU_TID, "name": "thread_name", "args": {"name": "CPU"}}]
+    for number, name in sorted(tasks.items()):
+        events.append({"ph": "M", "pid": PID, "tid": number, "name": "thread_name", "args": {"name": name}})
+
+    # Unwrap the 32-bit cycle counter, records are in time order
+    cycles = 0
+    previous = None
+    running = None
+    switched_in = 0.0
+    for raw, event, arg in records:
+        if previous is not None:
+            cycles += (raw - previous) & 0xFFFFFFFF
+        previous = raw
+        ts = cycles * 1e6 / clock
+        tid = running if running is not None else ISR_TID
+
+        if event == TASK_SWITCH:
+            # Running tasks on a track of their own, a task may be switched
+            # out in the middle of its slices
+            if running is not None:
+                events.append({"ph": "X", "pid": PID, "tid": CPU_TID, "ts": switched_in, "dur": ts - switched_in,
+                               "name": tasks.get(running, str(running))})
+            running = arg
+            switched_in = ts
+        elif event == PROCESS_START:
+            events.append({"ph": "B", "pid": PID, "tid": tid, "ts": ts, "name": "process"})
+        elif event == PROCESS_END:
+            events.append({"ph": "E", "pid": PID, "tid": tid, "ts": ts, "name": "process", "args": {"error": arg}})
+        elif event == CALLBACK_ENTER:
+            events.append({"ph": "B", "pid": PID, "tid": tid, "ts": ts, "name": "callback", "args": {"event": arg}})
+        elif event == CALLBACK_EXIT:
+            events.append({"ph": "E", "pid": PID, "tid": tid, "ts": ts, "name": "callback"})
+        elif event == MUTEX_WAIT:
+            events.append({"ph": "B", "pid": PID, "tid": tid, "ts": ts, "name": "mutex wait", "args": {"timeout_ms": arg}})
+        elif event == MUTEX_TAKE:
+            events.append({"ph": "E", "pid": PID, "tid": tid, "ts": ts, "name": "mutex wait", "args": {"timeout": arg}})
+            if arg == 0:
+                events.append({"ph": "B", "pid": PID, "tid": tid, "ts": ts, "name": "mutex held"})
+        elif event == MUTEX_GIVE:
+            events.append({"ph": "E", "pid": PID, "tid": tid, "ts": ts, "name": "mutex held"})
+        elif event == UART_TX_START:
+            events.append({"ph": "B", "pid": PID, "tid": tid, "ts": ts, "name": "uart tx", "args": {"bytes": arg}})
+        elif event == UART_TX_END:
+            events.append({"ph": "E", "pid": PID, "tid": tid, "ts": ts, "name": "uart tx"})
+        elif event == UART_RX:
+            events.append({"ph": "i", "s": "t", "pid": PID, "tid": ISR_TID, "ts": ts, "name": "uart rx",
+                           "args": {"bytes": arg}})
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", help="terminal log with the trace dump")
+    parser.add_argument("output", nargs="?", help="JSON file, default standard output")
+    args = parser.parse_args()
+
+    with open(args.log, encoding="ascii", errors="replace") as log:
+        trace = convert(*parse(log))
+    if args.output:
+        with open(args.output, "w") as output:
+            json.dump(trace, output)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
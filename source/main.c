@@ -31,9 +31,15 @@
 #include "cyabs_rtos.h"
 
 /* Header file for local task */
+#include "radar_boot_profile.h"
+#include "radar_clock.h"
+#include "radar_counter_retain.h"
 #include "radar_counter_task.h"
 #include "radar_counter_terminal_ui.h"
+#include "radar_event_bus.h"
+#include "radar_journal.h"
 #include "radar_led_task.h"
+#include "radar_trace.h"
 
 /*******************************************************************************
  * Function Name: main
@@ -54,12 +60,23 @@
  *******************************************************************************/
 int main(void)
 {
+    /* Measure the time of each init stage from here on. */
+    radar_boot_profile_start();
+
     /* Initialize the board support package. */
     cy_rslt_t result = cybsp_init();
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_BSP);
+
+    /* Keep the high resolution clock monotonic across counter wraps. */
+    result = radar_clock_start();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
 
     /* Enable global interrupts. */
     __enable_irq();
@@ -70,12 +87,72 @@ int main(void)
     {
         CY_ASSERT(0);
     }
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_RETARGET_IO);
+
+    /* Enable interrupt driven reception of terminal UI keys. */
+    result = radar_counter_terminal_ui_init();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_TERMINAL_UI);
 
-    /* \x1b[2J\x1b[;H - ANSI ESC sequence to clear screen. */
-    printf("\x1b[2J\x1b[;H");
-    printf("====================================================================\r\n");
-    printf("Connected Sensor Kit: Radar Entrance Counter Application on FreeRTOS\r\n");
-    printf("====================================================================\r\n\r\n");
+    /* Printing blocks on the UART, keep the banner short after a warm */
+    /* restart so that counting resumes sooner.                        */
+    if (radar_counter_retain_init())
+    {
+        printf("\r\nWarm restart, counts and settings restored\r\n");
+    }
+    else
+    {
+        /* \x1b[2J\x1b[;H - ANSI ESC sequence to clear screen. */
+        printf("\x1b[2J\x1b[;H");
+        printf("====================================================================\r\n");
+        printf("Connected Sensor Kit: Radar Entrance Counter Application on FreeRTOS\r\n");
+        printf("====================================================================\r\n\r\n");
+    }
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_BANNER);
+
+    /* Create task that delivers counter events to the LEDs, the console */
+    /* and other sinks of the event bus.                                 */
+    result = radar_event_bus_init();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+    cy_thread_t ifxradar_event_bus_task;
+    result = cy_rtos_create_thread(&ifxradar_event_bus_task,
+                                   radar_event_bus_task,
+                                   RADAR_EVENT_BUS_TASK_NAME,
+                                   NULL,
+                                   RADAR_EVENT_BUS_TASK_STACK_SIZE,
+                                   RADAR_EVENT_BUS_TASK_PRIORITY,
+                                   (cy_thread_arg_t)NULL);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Create task that writes counter events to the flash journal. The */
+    /* journal is scanned before the counter task continues the event  */
+    /* sequence numbers.                                                */
+    result = radar_journal_init();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+    cy_thread_t ifxradar_journal_task;
+    result = cy_rtos_create_thread(&ifxradar_journal_task,
+                                   radar_journal_task,
+                                   RADAR_JOURNAL_TASK_NAME,
+                                   NULL,
+                                   RADAR_JOURNAL_TASK_STACK_SIZE,
+                                   RADAR_JOURNAL_TASK_PRIORITY,
+                                   (cy_thread_arg_t)NULL);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
 
     /* Create task that initializes context object of RadarSensing for     */
     /* entrance counter, initializes radar device configuration, sets      */
@@ -124,6 +201,11 @@ int main(void)
         CY_ASSERT(0);
     }
 
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_TASKS);
+
+    /* Record from the first task switch on (RADAR_TRACE=1) */
+    radar_trace_start();
+
     /* Start the FreeRTOS scheduler. */
     vTaskStartScheduler();
 
@@ -0,0 +1,539 @@
+/*****************************************************************************
+** File name: radar_bench.c
+**
+** Description: This file implements a microbenchmark harness that reports the
+** median, spread and extremes of the execution time of the hot functions,
+** with warm and cold caches.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_bench.h"
+#include "radar_crc.h"
+#include "radar_event_record.h"
+#include "radar_format.h"
+#include "radar_led_pattern.h"
+#include "radar_line_edit.h"
+#include "radar_ring_buffer.h"
+#include "radar_timesync.h"
+
+#ifdef RADAR_BENCH_HOST
+#include <time.h>
+#endif
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Size of the buffer written to evict the host caches */
+#define BENCH_HOST_FLUSH_SIZE (8U * 1024U * 1024U)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static uint32_t bench_overhead[2];      // empty measurement, per call, warm and cold
+static volatile uint32_t bench_sink;    // keeps the results of the measured calls alive
+
+static uint8_t bench_record[RADAR_EVENT_RECORD_SIZE]; // encoded record
+static radar_event_record_t bench_event;               // decoded record
+static radar_ring_buffer_t bench_ring;                 // ring of the put and get cases
+static uint8_t bench_ring_data[64];                    // storage of bench_ring
+static char bench_text[32];                            // formatted text
+static char bench_event_line[80];                      // formatted event message
+static radar_led_pattern_t bench_pattern;              // pattern of the LED cases
+static radar_line_edit_t bench_edit;                   // line of the line edit case
+static char bench_line[16];                            // storage of bench_edit
+static radar_timesync_t bench_sync;                    // synchronized estimator
+static bool bench_sync_ready = false;                  // bench_sync was fed
+
+/*******************************************************************************
+ * Function Name: bench_empty
+ ********************************************************************************
+ * Summary:
+ *   Empty case, measures the overhead of a measurement.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void bench_empty(void)
+{
+}
+
+/*******************************************************************************
+ * Portable cases: the setup functions prepare enough state for
+ * RADAR_BENCH_BATCH calls of the run functions.
+ *******************************************************************************/
+static void bench_record_setup(void)
+{
+    bench_event.type = RADAR_EVENT_RECORD_TYPE_IN;
+    bench_event.sensor_id = 1U;
+    bench_event.sequence = 1234U;
+    bench_event.timestamp_us = 1700000000123456ULL;
+    bench_event.in_count = 42U;
+    bench_event.out_count = 17U;
+    bench_event.flags = RADAR_EVENT_RECORD_FLAG_SYNCED;
+    radar_event_record_encode(&bench_event, bench_record, sizeof(bench_record));
+}
+
+static void bench_crc32_run(void)
+{
+    bench_sink = radar_crc32(0U, bench_record, sizeof(bench_record));
+}
+
+static void bench_record_encode_run(void)
+{
+    bench_sink = (uint32_t)radar_event_record_encode(&bench_event, bench_record, sizeof(bench_record));
+}
+
+static void bench_record_decode_run(void)
+{
+    bench_sink = (uint32_t)radar_event_record_decode(bench_record, sizeof(bench_record), &bench_event);
+}
+
+static void bench_ring_empty_setup(void)
+{
+    radar_ring_buffer_init(&bench_ring, bench_ring_data, sizeof(bench_ring_data));
+}
+
+static void bench_ring_full_setup(void)
+{
+    radar_ring_buffer_init(&bench_ring, bench_ring_data, sizeof(bench_ring_data));
+    while (radar_ring_buffer_put(&bench_ring, 0x55U))
+    {
+    }
+}
+
+static void bench_ring_put_run(void)
+{
+    bench_sink = radar_ring_buffer_put(&bench_ring, 0x55U);
+}
+
+static void bench_ring_get_run(void)
+{
+    uint8_t value;
+    bench_sink = radar_ring_buffer_get(&bench_ring, &value);
+}
+
+static void bench_format_timestamp_run(void)
+{
+    bench_sink = (uint32_t)radar_format_timestamp(bench_text, sizeof(bench_text), 1700000000123ULL);
+}
+
+static void bench_format_uint_run(void)
+{
+    bench_sink = (uint32_t)radar_format_uint(bench_text, sizeof(bench_text), 1700000000123456ULL);
+}
+
+#ifdef RADAR_BENCH_HOST
+/* Event message as printed before radar_format.c, with float printf. Only
+ * measured on the host: on the target, it would link the float conversion
+ * that RADAR_NANO_PRINTF=1 leaves out. */
+static void bench_event_float_run(void)
+{
+    bench_sink = (uint32_t)snprintf(bench_event_line,
+                                    sizeof(bench_event_line),
+                                    "%.2f: Counter IN detected, IN: %d, OUT: %d\r\n",
+                                    (float)86399999U / 1000,
+                                    1234,
+                                    1230);
+}
+#endif /* RADAR_BENCH_HOST */
+
+/* The same message with integer arithmetic, as radar_counter_task_format_event */
+static void bench_event_integer_run(void)
+{
+    size_t size = sizeof(bench_event_line);
+    size_t length = radar_format_timestamp(bench_event_line, size, 86399999U);
+    length += radar_format_string(bench_event_line + length, size - length, ": ");
+    length += radar_format_string(bench_event_line + length, size - length, "Counter IN detected");
+    length += radar_format_string(bench_event_line + length, size - length, ", IN: ");
+    length += radar_format_uint(bench_event_line + length, size - length, 1234U);
+    length += radar_format_string(bench_event_line + length, size - length, ", OUT: ");
+    length += radar_format_uint(bench_event_line + length, size - length, 1230U);
+    length += radar_format_string(bench_event_line + length, size - length, "\r\n");
+    bench_sink = (uint32_t)length;
+}
+
+static void bench_led_pattern_setup(void)
+{
+    radar_led_pattern_init(&bench_pattern);
+    radar_led_pattern_event(&bench_pattern, RADAR_EVENT_RECORD_TYPE_FREE);
+    radar_led_pattern_event(&bench_pattern, RADAR_EVENT_RECORD_TYPE_IN);
+}
+
+static void bench_led_pattern_step_run(void)
+{
+    uint32_t color;
+    bench_sink = radar_led_pattern_step(&bench_pattern, &color);
+}
+
+static void bench_led_pattern_event_run(void)
+{
+    radar_led_pattern_event(&bench_pattern, RADAR_EVENT_RECORD_TYPE_OUT);
+    bench_sink = bench_pattern.overrides;
+}
+
+static void bench_line_edit_setup(void)
+{
+    radar_line_edit_init(&bench_edit, bench_line, sizeof(bench_line));
+}
+
+static void bench_line_edit_run(void)
+{
+    char echo[RADAR_LINE_EDIT_ECHO_MAXLENGTH];
+    uint32_t echo_length;
+    bench_sink = (uint32_t)radar_line_edit_input(&bench_edit, '7', echo, &echo_length);
+}
+
+static void bench_timesync_setup(void)
+{
+    if (!bench_sync_ready)
+    {
+        /* one sync per 30 s with a clock running 20 ppm fast */
+        radar_timesync_init(&bench_sync);
+        for (uint64_t i = 0U; i < RADAR_TIMESYNC_WINDOW; i++)
+        {
+            uint64_t reference_us = 1700000000000000ULL + (i * 30000000ULL);
+            radar_timesync_update(&bench_sync, 5000000ULL + (i * 30000600ULL), reference_us);
+        }
+        bench_sync_ready = true;
+    }
+}
+
+static void bench_timesync_run(void)
+{
+    bench_sink = (uint32_t)radar_timesync_to_reference(&bench_sync, 400000000ULL);
+}
+
+const radar_bench_case_t radar_bench_portable_cases[] = {
+    {"radar_crc32", bench_record_setup, bench_crc32_run},
+    {"radar_event_record_encode", bench_record_setup, bench_record_encode_run},
+    {"radar_event_record_decode", bench_record_setup, bench_record_decode_run},
+    {"radar_ring_buffer_put", bench_ring_empty_setup, bench_ring_put_run},
+    {"radar_ring_buffer_get", bench_ring_full_setup, bench_ring_get_run},
+    {"radar_format_timestamp", NULL, bench_format_timestamp_run},
+    {"radar_format_uint", NULL, bench_format_uint_run},
+#ifdef RADAR_BENCH_HOST
+    {"event_message_float_printf", NULL, bench_event_float_run},
+#endif
+    {"event_message_integer", NULL, bench_event_integer_run},
+    {"radar_led_pattern_step", bench_led_pattern_setup, bench_led_pattern_step_run},
+    {"radar_led_pattern_event", bench_led_pattern_setup, bench_led_pattern_event_run},
+    {"radar_line_edit_input", bench_line_edit_setup, bench_line_edit_run},
+    {"radar_timesync_to_reference", bench_timesync_setup, bench_timesync_run}};
+const uint32_t radar_bench_portable_case_count =
+    sizeof(radar_bench_portable_cases) / sizeof(radar_bench_portable_cases[0]);
+
+/*******************************************************************************
+ * Function Name: bench_sort
+ ********************************************************************************
+ * Summary:
+ *   Sorts samples in ascending order, insertion sort since there are few.
+ *
+ * Parameters:
+ *   samples: samples to sort
+ *   count: number of samples
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void bench_sort(uint32_t *samples, uint32_t count)
+{
+    for (uint32_t i = 1U; i < count; i++)
+    {
+        uint32_t value = samples[i];
+        uint32_t j = i;
+        while ((j > 0U) && (samples[j - 1U] > value))
+        {
+            samples[j] = samples[j - 1U];
+            j--;
+        }
+        samples[j] = value;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: bench_sample
+ ********************************************************************************
+ * Summary:
+ *   Measures one sample: RADAR_BENCH_BATCH calls with warm caches, or a
+ *   single call after the caches were flushed.
+ *
+ * Parameters:
+ *   platform: platform hooks
+ *   bench_case: case to measure
+ *   cold: true to flush the caches before the call
+ *
+ * Return:
+ *   counter ticks of the whole sample
+ *******************************************************************************/
+static uint32_t bench_sample(const radar_bench_platform_t *platform, const radar_bench_case_t *bench_case, bool cold)
+{
+    uint32_t calls = cold ? 1U : RADAR_BENCH_BATCH;
+    uint32_t state = 0U;
+
+    if (bench_case->setup != NULL)
+    {
+        bench_case->setup();
+    }
+    if (cold && (platform->flush != NULL))
+    {
+        platform->flush();
+    }
+    if (platform->enter != NULL)
+    {
+        state = platform->enter();
+    }
+
+    uint32_t start = platform->counter();
+    for (uint32_t i = 0U; i < calls; i++)
+    {
+        bench_case->run();
+    }
+    uint32_t elapsed = platform->counter() - start;
+
+    if (platform->exit != NULL)
+    {
+        platform->exit(state);
+    }
+    return elapsed;
+}
+
+/*******************************************************************************
+ * Function Name: radar_bench_measure
+ ********************************************************************************
+ * Summary:
+ *   Measures RADAR_BENCH_SAMPLES samples of a case after a warm-up call and
+ *   computes the statistics per call. The overhead measured by
+ *   radar_bench_begin, i.e. of the counter reads and an empty call, is
+ *   subtracted.
+ *
+ * Parameters:
+ *   platform: platform hooks
+ *   bench_case: case to measure
+ *   cold: true to flush the caches before each sample
+ *   result: statistics
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_bench_measure(const radar_bench_platform_t *platform,
+                         const radar_bench_case_t *bench_case,
+                         bool cold,
+                         radar_bench_result_t *result)
+{
+    uint32_t samples[RADAR_BENCH_SAMPLES];
+    uint32_t calls = cold ? 1U : RADAR_BENCH_BATCH;
+    uint32_t overhead = bench_overhead[cold ? 1 : 0];
+
+    (void)bench_sample(platform, bench_case, false);
+    for (uint32_t i = 0U; i < RADAR_BENCH_SAMPLES; i++)
+    {
+        uint32_t per_call = bench_sample(platform, bench_case, cold) / calls;
+        samples[i] = (per_call > overhead) ? (per_call - overhead) : 0U;
+    }
+
+    bench_sort(samples, RADAR_BENCH_SAMPLES);
+    result->min = samples[0];
+    result->max = samples[RADAR_BENCH_SAMPLES - 1U];
+    result->median = samples[RADAR_BENCH_SAMPLES / 2U];
+
+    for (uint32_t i = 0U; i < RADAR_BENCH_SAMPLES; i++)
+    {
+        samples[i] = (samples[i] > result->median) ? (samples[i] - result->median) : (result->median - samples[i]);
+    }
+    bench_sort(samples, RADAR_BENCH_SAMPLES);
+    result->mad = samples[RADAR_BENCH_SAMPLES / 2U];
+}
+
+/*******************************************************************************
+ * Function Name: radar_bench_begin
+ ********************************************************************************
+ * Summary:
+ *   Measures the overhead of an empty case and prints the header line:
+ *     B BEGIN {"target":..,"unit":..,"samples":..,"batch":..,
+ *              "overhead_warm":..,"overhead_cold":..}
+ *
+ * Parameters:
+ *   platform: platform hooks
+ *   target: name of the target, e.g. the board
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_bench_begin(const radar_bench_platform_t *platform, const char *target)
+{
+    static const radar_bench_case_t empty = {"empty", NULL, bench_empty};
+    char line[RADAR_BENCH_LINE_MAXLENGTH];
+    radar_bench_result_t result;
+
+    for (uint32_t cold = 0U; cold < 2U; cold++)
+    {
+        bench_overhead[cold] = 0U;
+        radar_bench_measure(platform, &empty, cold != 0U, &result);
+        bench_overhead[cold] = result.median;
+    }
+
+    snprintf(line,
+             sizeof(line),
+             "B BEGIN {\"target\":\"%s\",\"unit\":\"%s\",\"samples\":%lu,\"batch\":%lu,"
+             "\"overhead_warm\":%lu,\"overhead_cold\":%lu}",
+             target,
+             platform->unit,
+             (unsigned long)RADAR_BENCH_SAMPLES,
+             (unsigned long)RADAR_BENCH_BATCH,
+             (unsigned long)bench_overhead[0],
+             (unsigned long)bench_overhead[1]);
+    platform->output(line);
+}
+
+/*******************************************************************************
+ * Function Name: radar_bench_run
+ ********************************************************************************
+ * Summary:
+ *   Measures cases with warm and, if the platform can flush its caches, cold
+ *   caches, one line per case and variant:
+ *     B {"name":..,"variant":"warm"|"cold","median":..,"mad":..,"min":..,"max":..}
+ *
+ * Parameters:
+ *   platform: platform hooks
+ *   cases: cases to measure
+ *   count: number of cases
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_bench_run(const radar_bench_platform_t *platform,
+                     const radar_bench_case_t *cases,
+                     uint32_t count)
+{
+    char line[RADAR_BENCH_LINE_MAXLENGTH];
+    radar_bench_result_t result;
+
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        for (uint32_t cold = 0U; cold < 2U; cold++)
+        {
+            if ((cold != 0U) && (platform->flush == NULL))
+            {
+                continue;
+            }
+            radar_bench_measure(platform, &cases[i], cold != 0U, &result);
+            snprintf(line,
+                     sizeof(line),
+                     "B {\"name\":\"%s\",\"variant\":\"%s\",\"median\":%lu,\"mad\":%lu,\"min\":%lu,\"max\":%lu}",
+                     cases[i].name,
+                     (cold != 0U) ? "cold" : "warm",
+                     (unsigned long)result.median,
+                     (unsigned long)result.mad,
+                     (unsigned long)result.min,
+                     (unsigned long)result.max);
+            platform->output(line);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_bench_end
+ ********************************************************************************
+ * Summary:
+ *   Prints the line "B END" that ends a benchmark run.
+ *
+ * Parameters:
+ *   platform: platform hooks
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_bench_end(const radar_bench_platform_t *platform)
+{
+    platform->output("B END");
+}
+
+#ifdef RADAR_BENCH_HOST
+static uint8_t bench_host_flush_buffer[BENCH_HOST_FLUSH_SIZE]; // written to evict the caches
+
+/*******************************************************************************
+ * Function Name: bench_host_counter
+ ********************************************************************************
+ * Summary:
+ *   Host counter, the monotonic clock in nanoseconds.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   nanoseconds, wraps every 4.3 s
+ *******************************************************************************/
+static uint32_t bench_host_counter(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec);
+}
+
+/*******************************************************************************
+ * Function Name: bench_host_flush
+ ********************************************************************************
+ * Summary:
+ *   Evicts the host caches by writing a buffer larger than the last level
+ *   cache.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void bench_host_flush(void)
+{
+    memset(bench_host_flush_buffer, (int)bench_sink, sizeof(bench_host_flush_buffer));
+    bench_sink = bench_host_flush_buffer[bench_sink % BENCH_HOST_FLUSH_SIZE];
+}
+
+/*******************************************************************************
+ * Function Name: radar_bench_host
+ ********************************************************************************
+ * Summary:
+ *   Runs the portable cases on the host, timed in nanoseconds. Called by
+ *   scripts/radar_bench.py, which builds this file with RADAR_BENCH_HOST.
+ *
+ * Parameters:
+ *   target: name of the host
+ *   output: writes a line without line end
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_bench_host(const char *target, void (*output)(const char *line))
+{
+    radar_bench_platform_t platform = {"ns", bench_host_counter, bench_host_flush, NULL, NULL, output};
+
+    radar_bench_begin(&platform, target);
+    radar_bench_run(&platform, radar_bench_portable_cases, radar_bench_portable_case_count);
+    radar_bench_end(&platform);
+}
+#endif /* RADAR_BENCH_HOST */
@@ -0,0 +1,105 @@
+/******************************************************************************
+** File name: radar_bench.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_bench.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* This header and radar_bench.c only depend on the C standard library and
+ * the modules that do, so scripts/radar_bench.py can run the same cases on
+ * the host. The target adds its own cases and counter (radar_bench_target.c). */
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Set to 1 to build the on-target benchmark, e.g. with make build RADAR_BENCH=1 */
+#ifndef RADAR_BENCH_ENABLE
+#define RADAR_BENCH_ENABLE (0)
+#endif
+
+/* Measurements per case and variant, odd for an exact median */
+#define RADAR_BENCH_SAMPLES (63U)
+/* Calls per warm measurement, the result is given per call */
+#define RADAR_BENCH_BATCH (8U)
+/* Maximum length of an output line */
+#define RADAR_BENCH_LINE_MAXLENGTH (160U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Benchmark case: setup() prepares the state before each measurement and is
+ * not measured, run() is the measured call */
+typedef struct
+{
+    const char *name;
+    void (*setup)(void);
+    void (*run)(void);
+} radar_bench_case_t;
+
+/* Platform hooks */
+typedef struct
+{
+    const char *unit;               // unit of the counter, e.g. "cycles"
+    uint32_t (*counter)(void);      // free running counter, may wrap
+    void (*flush)(void);            // evicts code and data from the caches, NULL if none
+    uint32_t (*enter)(void);        // called before a measurement, e.g. to mask interrupts
+    void (*exit)(uint32_t state);   // called after a measurement
+    void (*output)(const char *line); // writes a line without line end
+} radar_bench_platform_t;
+
+/* Statistics of a case and variant, per call */
+typedef struct
+{
+    uint32_t median;
+    uint32_t mad;    // median absolute deviation from the median
+    uint32_t min;
+    uint32_t max;
+} radar_bench_result_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Cases of the modules that only depend on the C standard library */
+extern const radar_bench_case_t radar_bench_portable_cases[];
+extern const uint32_t radar_bench_portable_case_count;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_bench_measure(const radar_bench_platform_t *platform,
+                         const radar_bench_case_t *bench_case,
+                         bool cold,
+                         radar_bench_result_t *result);
+void radar_bench_run(const radar_bench_platform_t *platform,
+                     const radar_bench_case_t *cases,
+                     uint32_t count);
+void radar_bench_begin(const radar_bench_platform_t *platform, const char *target);
+void radar_bench_end(const radar_bench_platform_t *platform);
+/* Target cases and hooks, implemented in radar_bench_target.c */
+void radar_bench_target_run(void);
+#ifdef RADAR_BENCH_HOST
+void radar_bench_host(const char *target, void (*output)(const char *line));
+#endif
@@ -0,0 +1,196 @@
+/*****************************************************************************
+** File name: radar_bench_target.c
+**
+** Description: This file implements the target side of the microbenchmark: the
+** cycle counter, cache flush and critical section hooks and the cases of the
+** modules that need the hardware or the RTOS.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdio.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "radar_bench.h"
+#include "radar_clock.h"
+#include "radar_counter_task.h"
+#include "radar_event_bus.h"
+#include "radar_led_pattern.h"
+#include "radar_led_task.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static volatile uint32_t bench_target_sink;         // keeps the results of the measured calls alive
+static radar_counter_event_t bench_target_event;    // event of the formatting cases
+static radar_event_record_t bench_target_record;    // record converted from the event
+static char bench_target_line[96];                  // formatted event line
+static uint32_t bench_target_color = RADAR_LED_RED; // LED color, changes with every write
+
+/*******************************************************************************
+ * Function Name: bench_target_counter
+ ********************************************************************************
+ * Summary:
+ *   Reads the DWT cycle counter, started by radar_clock_init.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   CPU cycles, wraps
+ *******************************************************************************/
+static uint32_t bench_target_counter(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*******************************************************************************
+ * Function Name: bench_target_output
+ ********************************************************************************
+ * Summary:
+ *   Prints a benchmark line on the terminal.
+ *
+ * Parameters:
+ *   line: line without line end
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void bench_target_output(const char *line)
+{
+    printf("%s\r\n", line);
+}
+
+/*******************************************************************************
+ * Target cases: the measured functions of the event path that run on every
+ * counter event. radar_counter_callback itself is not called, it would
+ * publish the events to the journal and the sinks; its parts are measured
+ * instead.
+ *******************************************************************************/
+static void bench_target_event_setup(void)
+{
+    bench_target_event.time_us = radar_clock_us();
+    bench_target_event.timestamp_ms = 86399999U;
+    bench_target_event.in_count = 1234U;
+    bench_target_event.out_count = 1230U;
+    bench_target_event.sequence = 2464U;
+    bench_target_event.event = MTB_RADAR_SENSING_EVENT_COUNTER_IN;
+}
+
+static void bench_target_format_event_run(void)
+{
+    bench_target_sink = (uint32_t)radar_counter_task_format_event(&bench_target_event,
+                                                                  bench_target_line,
+                                                                  sizeof(bench_target_line));
+}
+
+static void bench_target_to_record_run(void)
+{
+    radar_event_bus_to_record(&bench_target_event, &bench_target_record);
+    bench_target_sink = bench_target_record.flags;
+}
+
+static void bench_target_clock_us_run(void)
+{
+    bench_target_sink = (uint32_t)radar_clock_us();
+}
+
+static void bench_target_led_pattern_run(void)
+{
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_COUNTER_IN);
+}
+
+static void bench_target_led_write_run(void)
+{
+    bench_target_color ^= (RADAR_LED_RED | RADAR_LED_GREEN);
+    radar_led_write(bench_target_color);
+}
+
+static void bench_target_led_unchanged_setup(void)
+{
+    radar_led_write(bench_target_color);
+}
+
+static void bench_target_led_unchanged_run(void)
+{
+    radar_led_write(bench_target_color);
+}
+
+/* LED write before radar_led_write used port registers: one HAL call per
+ * LED on every tick, kept as reference for the comparison */
+static void bench_target_led_hal_run(void)
+{
+    bench_target_color ^= (RADAR_LED_RED | RADAR_LED_GREEN);
+    cyhal_gpio_write(LED_RGB_RED, ((bench_target_color & RADAR_LED_RED) != 0U) ? LED_STATE_ON : LED_STATE_OFF);
+    cyhal_gpio_write(LED_RGB_GREEN, ((bench_target_color & RADAR_LED_GREEN) != 0U) ? LED_STATE_ON : LED_STATE_OFF);
+    cyhal_gpio_write(LED_RGB_BLUE, ((bench_target_color & RADAR_LED_BLUE) != 0U) ? LED_STATE_ON : LED_STATE_OFF);
+}
+
+static const radar_bench_case_t bench_target_cases[] = {
+    {"radar_counter_task_format_event", bench_target_event_setup, bench_target_format_event_run},
+    {"radar_event_bus_to_record", bench_target_event_setup, bench_target_to_record_run},
+    {"radar_clock_us", NULL, bench_target_clock_us_run},
+    {"radar_led_set_pattern", NULL, bench_target_led_pattern_run},
+    {"radar_led_write", NULL, bench_target_led_write_run},
+    {"radar_led_write_unchanged", bench_target_led_unchanged_setup, bench_target_led_unchanged_run},
+    {"cyhal_gpio_write_rgb", NULL, bench_target_led_hal_run}};
+
+/*******************************************************************************
+ * Function Name: radar_bench_target_run
+ ********************************************************************************
+ * Summary:
+ *   Runs the portable and the target cases and prints the results, see
+ *   radar_bench_begin and radar_bench_run for the output lines. Each sample
+ *   runs with interrupts disabled, so the results are not disturbed by other
+ *   tasks. The cold variant clears the flash cache and buffer before the call.
+ *   The LEDs flicker while the LED cases run.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_bench_target_run(void)
+{
+    static const radar_bench_platform_t platform = {"cycles",
+                                                    bench_target_counter,
+                                                    Cy_SysLib_ClearFlashCacheAndBuffer,
+                                                    Cy_SysLib_EnterCriticalSection,
+                                                    Cy_SysLib_ExitCriticalSection,
+                                                    bench_target_output};
+    char target[32];
+
+    if (RADAR_BENCH_ENABLE == 0)
+    {
+        printf("Benchmark not enabled, build with RADAR_BENCH=1\r\n");
+        return;
+    }
+
+    snprintf(target, sizeof(target), "CM4 %lu MHz", (unsigned long)(SystemCoreClock / 1000000U));
+    radar_bench_begin(&platform, target);
+    radar_bench_run(&platform, radar_bench_portable_cases, radar_bench_portable_case_count);
+    radar_bench_run(&platform, bench_target_cases, sizeof(bench_target_cases) / sizeof(bench_target_cases[0]));
+    radar_bench_end(&platform);
+}
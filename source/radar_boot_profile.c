@@ -0,0 +1,195 @@
+/*****************************************************************************
+** File name: radar_boot_profile.c
+**
+** Description: This file measures the time from the entry of main() to the
+** completion of each init stage with the DWT cycle counter.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdio.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "radar_boot_profile.h"
+#include "radar_clock.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static const char *const boot_stage_names[RADAR_BOOT_STAGE_COUNT] = {
+    [RADAR_BOOT_STAGE_BSP] = "BSP",
+    [RADAR_BOOT_STAGE_RETARGET_IO] = "retarget-io",
+    [RADAR_BOOT_STAGE_TERMINAL_UI] = "terminal UI",
+    [RADAR_BOOT_STAGE_BANNER] = "banner",
+    [RADAR_BOOT_STAGE_TASKS] = "tasks",
+    [RADAR_BOOT_STAGE_SCHEDULER] = "scheduler",
+    [RADAR_BOOT_STAGE_RADAR_HW] = "radar GPIO/SPI",
+    [RADAR_BOOT_STAGE_SENSING] = "sensing init",
+    [RADAR_BOOT_STAGE_PARAMS] = "parameters",
+    [RADAR_BOOT_STAGE_FIRST_PROCESS] = "first process",
+};
+
+/* Time of completion of each stage in microseconds since the entry of main */
+static uint32_t boot_stage_us[RADAR_BOOT_STAGE_COUNT];
+static uint32_t boot_last_cycles = 0; // cycle counter at the previous mark
+static uint32_t boot_last_us = 0;     // time of the previous mark
+
+/*******************************************************************************
+ * Function Name: radar_boot_profile_start
+ ********************************************************************************
+ * Summary:
+ *   Starts the clock. Must be called first thing in main().
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_boot_profile_start(void)
+{
+    radar_clock_init();
+    boot_last_cycles = (uint32_t)radar_clock_cycles();
+    boot_last_us = 0U;
+}
+
+/*******************************************************************************
+ * Function Name: radar_boot_profile_elapsed_us
+ ********************************************************************************
+ * Summary:
+ *   Advances the boot time to now. Cycles since the previous call are
+ *   converted with the current core clock, so the BSP stage, which switches
+ *   to the final clock, is an estimate. Calls must be less than a cycle
+ *   counter period (about 40 s) apart.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   microseconds since the entry of main
+ *******************************************************************************/
+uint32_t radar_boot_profile_elapsed_us(void)
+{
+    uint32_t now = (uint32_t)radar_clock_cycles();
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+
+    if (cycles_per_us == 0U)
+    {
+        cycles_per_us = 1U;
+    }
+    boot_last_us += (now - boot_last_cycles) / cycles_per_us;
+    /* Keep the remainder for the next interval */
+    boot_last_cycles = now - ((now - boot_last_cycles) % cycles_per_us);
+    return boot_last_us;
+}
+
+/*******************************************************************************
+ * Function Name: radar_boot_profile_mark
+ ********************************************************************************
+ * Summary:
+ *   Records the completion of a boot stage. Only the first completion is
+ *   recorded.
+ *
+ * Parameters:
+ *   stage: completed stage
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_boot_profile_mark(radar_boot_stage_t stage)
+{
+    if (boot_stage_us[stage] == 0U)
+    {
+        boot_stage_us[stage] = radar_boot_profile_elapsed_us();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_boot_profile_format_line
+ ********************************************************************************
+ * Summary:
+ *   Formats a line of the boot profile: a header, the duration of each boot
+ *   stage and the time at its completion, and an empty line. The caller
+ *   prints the lines, so the profile can be passed to the buffered event
+ *   output instead of being printed by the radar counter task.
+ *
+ * Parameters:
+ *   index: line number, from 0
+ *   line: destination
+ *   size: size of the destination
+ *
+ * Return:
+ *   length of the line, 0 after the last line
+ *******************************************************************************/
+size_t radar_boot_profile_format_line(uint32_t index, char *line, size_t size)
+{
+    int length;
+
+    if (index == 0U)
+    {
+        length = snprintf(line, size, "Boot profile (us since main)\r\n");
+    }
+    else if (index <= RADAR_BOOT_STAGE_COUNT)
+    {
+        uint32_t stage = index - 1U;
+        uint32_t stage_us = boot_stage_us[stage];
+        uint32_t previous_us = 0U;
+
+        /* Duration since the previous stage that completed */
+        for (uint32_t i = stage; i > 0U; i--)
+        {
+            if (boot_stage_us[i - 1U] != 0U)
+            {
+                previous_us = boot_stage_us[i - 1U];
+                break;
+            }
+        }
+        if (stage_us == 0U)
+        {
+            length = snprintf(line, size, "  %-16s -\r\n", boot_stage_names[stage]);
+        }
+        else
+        {
+            length = snprintf(line,
+                              size,
+                              "  %-16s %8lu %8lu\r\n",
+                              boot_stage_names[stage],
+                              (unsigned long)(stage_us - previous_us),
+                              (unsigned long)stage_us);
+        }
+    }
+    else if (index == (RADAR_BOOT_STAGE_COUNT + 1U))
+    {
+        length = snprintf(line, size, "\r\n");
+    }
+    else
+    {
+        return 0U;
+    }
+
+    if (length < 0)
+    {
+        return 0U;
+    }
+    return ((size_t)length < size) ? (size_t)length : (size - 1U);
+}
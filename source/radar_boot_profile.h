@@ -0,0 +1,56 @@
+/******************************************************************************
+** File name: radar_boot_profile.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_boot_profile.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Boot stages in the order they complete */
+typedef enum
+{
+    RADAR_BOOT_STAGE_BSP,           // cybsp_init
+    RADAR_BOOT_STAGE_RETARGET_IO,   // debug UART
+    RADAR_BOOT_STAGE_TERMINAL_UI,   // UART receive interrupt
+    RADAR_BOOT_STAGE_BANNER,        // start banner printed
+    RADAR_BOOT_STAGE_TASKS,         // tasks created
+    RADAR_BOOT_STAGE_SCHEDULER,     // radar counter task running
+    RADAR_BOOT_STAGE_RADAR_HW,      // radar GPIOs and SPI
+    RADAR_BOOT_STAGE_SENSING,       // mtb_radar_sensing_init and enable
+    RADAR_BOOT_STAGE_PARAMS,        // parameters set or restored
+    RADAR_BOOT_STAGE_FIRST_PROCESS, // first successful processing call
+    RADAR_BOOT_STAGE_COUNT
+} radar_boot_stage_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_boot_profile_start(void);
+void radar_boot_profile_mark(radar_boot_stage_t stage);
+uint32_t radar_boot_profile_elapsed_us(void);
+size_t radar_boot_profile_format_line(uint32_t index, char *line, size_t size);
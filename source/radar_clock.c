@@ -0,0 +1,278 @@
+/*****************************************************************************
+** File name: radar_clock.c
+**
+** Description: This file implements a monotonic 64-bit clock with sub-microsecond
+** resolution from the DWT cycle counter.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdbool.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "radar_clock.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static uint32_t clock_high = 0;         // upper 32 bits of the cycle count
+static uint32_t clock_last = 0;         // DWT counter at the previous read
+static bool clock_initialized = false;
+static uint32_t clock_us_per_cycle = 0; // microseconds per cycle, 0.32 fixed point
+static cy_timer_t clock_refresh_timer;
+static radar_timesync_t clock_sync;     // estimate of the reference clock
+
+/*******************************************************************************
+ * Function Name: radar_clock_refresh
+ ********************************************************************************
+ * Summary:
+ *   Timer callback that reads the clock, so that no wrap of the DWT counter
+ *   is missed while nobody else reads it.
+ *
+ * Parameters:
+ *   arg: unused
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_clock_refresh(cy_timer_callback_arg_t arg)
+{
+    (void)radar_clock_cycles();
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_set_scale
+ ********************************************************************************
+ * Summary:
+ *   Computes the factor that converts cycles into microseconds for the
+ *   current core clock, rounded to 32 fractional bits: the conversion is
+ *   off by at most 10 ppb, far below the tolerance of the clock source.
+ *   The core clock must be above 1 MHz.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_clock_set_scale(void)
+{
+    uint32_t hz = SystemCoreClock;
+
+    clock_us_per_cycle = (uint32_t)(((1000000ULL << 32) + (hz / 2U)) / hz);
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_init
+ ********************************************************************************
+ * Summary:
+ *   Starts the DWT cycle counter. Can be called before the clocks are
+ *   configured; further calls have no effect.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_clock_init(void)
+{
+    if (clock_initialized)
+    {
+        return;
+    }
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    clock_high = 0U;
+    clock_last = 0U;
+    radar_clock_set_scale();
+    radar_timesync_init(&clock_sync);
+    clock_initialized = true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_start
+ ********************************************************************************
+ * Summary:
+ *   Starts the timer that keeps the 64-bit extension up to date and takes
+ *   over the final core clock for the conversion into microseconds. Must be
+ *   called after the clocks are configured and before the scheduler is
+ *   started.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the timer creation
+ *******************************************************************************/
+cy_rslt_t radar_clock_start(void)
+{
+    radar_clock_init();
+    radar_clock_set_scale();
+
+    cy_rslt_t result = cy_rtos_init_timer(&clock_refresh_timer, CY_TIMER_TYPE_PERIODIC, radar_clock_refresh, 0U);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cy_rtos_start_timer(&clock_refresh_timer, RADAR_CLOCK_REFRESH_MS);
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_cycles
+ ********************************************************************************
+ * Summary:
+ *   Reads the cycle counter extended to 64 bits.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   core clock cycles since radar_clock_init()
+ *******************************************************************************/
+uint64_t radar_clock_cycles(void)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    uint32_t low = DWT->CYCCNT;
+
+    if (low < clock_last)
+    {
+        clock_high++;
+    }
+    clock_last = low;
+    uint64_t cycles = ((uint64_t)clock_high << 32) | low;
+    Cy_SysLib_ExitCriticalSection(state);
+    return cycles;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_us
+ ********************************************************************************
+ * Summary:
+ *   Reads the clock in microseconds. Called on every counter event and
+ *   lock operation, so the cycles are scaled with two 32 x 32 bit
+ *   multiplications instead of a 64-bit division by the core clock.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   microseconds since radar_clock_init()
+ *******************************************************************************/
+uint64_t radar_clock_us(void)
+{
+    uint64_t cycles = radar_clock_cycles();
+    uint32_t factor = clock_us_per_cycle;
+
+    /* (cycles * factor) >> 32, split into the upper and lower 32 bits of
+     * the cycles so that no product overflows */
+    return ((uint64_t)(uint32_t)(cycles >> 32) * factor) + (((uint64_t)(uint32_t)cycles * factor) >> 32);
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_ms
+ ********************************************************************************
+ * Summary:
+ *   Reads the clock in milliseconds.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   milliseconds since radar_clock_init()
+ *******************************************************************************/
+uint64_t radar_clock_ms(void)
+{
+    return radar_clock_us() / 1000U;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_sync
+ ********************************************************************************
+ * Summary:
+ *   Adds a pair of local and reference timestamps to the estimate of the
+ *   reference clock. The estimate is updated on a copy, so that readers are
+ *   only blocked while it is stored.
+ *
+ * Parameters:
+ *   local_us: local time of the sample, from radar_clock_us()
+ *   reference_us: reference time of the sample
+ *
+ * Return:
+ *   outcome of the sample
+ *******************************************************************************/
+radar_timesync_result_t radar_clock_sync(uint64_t local_us, uint64_t reference_us)
+{
+    static radar_timesync_t sync;
+
+    radar_clock_get_sync(&sync);
+    radar_timesync_result_t result = radar_timesync_update(&sync, local_us, reference_us);
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    clock_sync = sync;
+    Cy_SysLib_ExitCriticalSection(state);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_reference_us
+ ********************************************************************************
+ * Summary:
+ *   Converts a local time into the timebase of the reference clock.
+ *
+ * Parameters:
+ *   local_us: local time, from radar_clock_us()
+ *   reference_us: reference time, local_us unchanged if not synchronized
+ *
+ * Return:
+ *   true if the clock is synchronized
+ *******************************************************************************/
+bool radar_clock_reference_us(uint64_t local_us, uint64_t *reference_us)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    bool synced = clock_sync.synced;
+    *reference_us = radar_timesync_to_reference(&clock_sync, local_us);
+    Cy_SysLib_ExitCriticalSection(state);
+    return synced;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_get_sync
+ ********************************************************************************
+ * Summary:
+ *   Copies the state of the reference clock estimate, e.g. for diagnostics.
+ *
+ * Parameters:
+ *   sync: copy of the estimator state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_clock_get_sync(radar_timesync_t *sync)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    *sync = clock_sync;
+    Cy_SysLib_ExitCriticalSection(state);
+}
@@ -0,0 +1,63 @@
+/******************************************************************************
+** File name: radar_clock.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_clock.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/* Header file for local module */
+#include "radar_timesync.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Period of the timer that extends the cycle counter, well below the wrap
+ * period of the 32-bit DWT counter (about 43 s at 100 MHz) */
+#define RADAR_CLOCK_REFRESH_MS (1000U)
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+/* Monotonic clock based on the DWT cycle counter of the CM4, extended to
+ * 64 bits in software. The 64-bit cycle count wraps after thousands of years
+ * at any core clock, so none of the values below wrap in practice. Time
+ * counts from the first call of radar_clock_init(); cycles before
+ * cybsp_init() are converted with the final core clock. The functions can be
+ * called from tasks and interrupts. */
+void radar_clock_init(void);
+cy_rslt_t radar_clock_start(void);
+uint64_t radar_clock_cycles(void);
+uint64_t radar_clock_us(void);
+uint64_t radar_clock_ms(void);
+
+/* Synchronization with the reference clock of a gateway. radar_clock_sync()
+ * must only be called from one task; the conversion can be called from any
+ * task. */
+radar_timesync_result_t radar_clock_sync(uint64_t local_us, uint64_t reference_us);
+bool radar_clock_reference_us(uint64_t local_us, uint64_t *reference_us);
+void radar_clock_get_sync(radar_timesync_t *sync);
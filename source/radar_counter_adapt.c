@@ -0,0 +1,439 @@
+/*****************************************************************************
+** File name: radar_counter_adapt.c
+**
+** Description: This file implements the adaptation of the counter sensitivity to the
+** observed traffic: event rates, zone occupation times and the in/out
+** balance are tracked over a sliding window of fixed size.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Header file for local module */
+#include "radar_counter_adapt.h"
+#include "radar_counter_params.h"
+#include "radar_event_bus.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Events queued for the controller by the event bus */
+#define ADAPT_SINK_LENGTH (4U)
+#define ADAPT_WINDOW_MS   (RADAR_COUNTER_ADAPT_BUCKETS * RADAR_COUNTER_ADAPT_BUCKET_MS)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Event counts of one bucket or of the whole window */
+typedef struct
+{
+    uint32_t in;
+    uint32_t out;
+    uint32_t occupations;
+    uint32_t false_occupations;
+    uint32_t occupied_ms;
+} adapt_counts_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static radar_event_bus_sink_t adapt_sink;
+static uint8_t adapt_sink_storage[RADAR_EVENT_BUS_SINK_STORAGE_SIZE(ADAPT_SINK_LENGTH)];
+
+static volatile bool adapt_enabled = (RADAR_COUNTER_ADAPT_ENABLE != 0);
+static adapt_counts_t adapt_buckets[RADAR_COUNTER_ADAPT_BUCKETS];
+static adapt_counts_t adapt_window;      // sum of all buckets
+static uint32_t adapt_bucket = 0;        // bucket of the current time
+static uint64_t adapt_bucket_start_ms = 0;
+static uint64_t adapt_window_start_ms = 0; // start of the observation, reset after a change
+
+/* Zone occupation in progress */
+static bool adapt_occupied = false;
+static bool adapt_crossed = false;       // IN or OUT during the occupation
+static uint64_t adapt_occupied_start_ms = 0;
+
+static bool adapt_changed = false;       // a change was made since startup
+static uint64_t adapt_last_change_ms = 0;
+static uint32_t adapt_changes = 0;
+static uint32_t adapt_rate_limited = 0;
+static radar_counter_adapt_change_t adapt_log[RADAR_COUNTER_ADAPT_LOG_LENGTH];
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_reset
+ ********************************************************************************
+ * Summary:
+ *   Clears the window, e.g. after a change so that the next decision is
+ *   based on the new sensitivity only.
+ *
+ * Parameters:
+ *   now_ms: current time
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_adapt_reset(uint64_t now_ms)
+{
+    taskENTER_CRITICAL();
+    memset(adapt_buckets, 0, sizeof(adapt_buckets));
+    memset(&adapt_window, 0, sizeof(adapt_window));
+    taskEXIT_CRITICAL();
+    adapt_bucket_start_ms = now_ms;
+    adapt_window_start_ms = now_ms;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_advance
+ ********************************************************************************
+ * Summary:
+ *   Moves the window to the current time: buckets that fell out of the
+ *   window are subtracted from the window sums and reused. At most one pass
+ *   over the buckets, so the cost per event is bounded.
+ *
+ * Parameters:
+ *   now_ms: current time
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_adapt_advance(uint64_t now_ms)
+{
+    if ((now_ms - adapt_bucket_start_ms) >= ADAPT_WINDOW_MS)
+    {
+        /* Idle for a whole window, nothing left to subtract */
+        radar_counter_adapt_reset(now_ms);
+        return;
+    }
+
+    while ((now_ms - adapt_bucket_start_ms) >= RADAR_COUNTER_ADAPT_BUCKET_MS)
+    {
+        adapt_bucket = (adapt_bucket + 1U) % RADAR_COUNTER_ADAPT_BUCKETS;
+        adapt_counts_t *old = &adapt_buckets[adapt_bucket];
+        taskENTER_CRITICAL();
+        adapt_window.in -= old->in;
+        adapt_window.out -= old->out;
+        adapt_window.occupations -= old->occupations;
+        adapt_window.false_occupations -= old->false_occupations;
+        adapt_window.occupied_ms -= old->occupied_ms;
+        memset(old, 0, sizeof(*old));
+        taskEXIT_CRITICAL();
+        adapt_bucket_start_ms += RADAR_COUNTER_ADAPT_BUCKET_MS;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_change
+ ********************************************************************************
+ * Summary:
+ *   Moves the sensitivity one step within the operator bounds, unless the
+ *   last change was less than RADAR_COUNTER_ADAPT_MIN_INTERVAL_MS ago, and
+ *   logs the change.
+ *
+ * Parameters:
+ *   direction: 1 to raise, -1 to lower
+ *   reason: reason logged with the change
+ *   now_ms: current time
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_adapt_change(int32_t direction, radar_counter_adapt_reason_t reason, uint64_t now_ms)
+{
+    const radar_counter_param_t *param = &radar_counter_params[RADAR_COUNTER_PARAM_SENSITIVITY];
+    int32_t old_value = radar_counter_params_get(RADAR_COUNTER_PARAM_SENSITIVITY);
+    int32_t new_value = old_value + (direction * RADAR_COUNTER_ADAPT_STEP);
+    char text[16];
+
+    if (new_value < RADAR_COUNTER_ADAPT_MIN)
+    {
+        new_value = RADAR_COUNTER_ADAPT_MIN;
+    }
+    else if (new_value > RADAR_COUNTER_ADAPT_MAX)
+    {
+        new_value = RADAR_COUNTER_ADAPT_MAX;
+    }
+    if (new_value == old_value)
+    {
+        return;
+    }
+    if (adapt_changed && ((now_ms - adapt_last_change_ms) < RADAR_COUNTER_ADAPT_MIN_INTERVAL_MS))
+    {
+        adapt_rate_limited++;
+        return;
+    }
+
+    (void)radar_counter_params_format(param, new_value, text, sizeof(text));
+    cy_rslt_t result = radar_counter_params_set(param, text);
+
+    taskENTER_CRITICAL();
+    radar_counter_adapt_change_t *entry = &adapt_log[adapt_changes % RADAR_COUNTER_ADAPT_LOG_LENGTH];
+    entry->timestamp_ms = now_ms;
+    entry->old_value = old_value;
+    entry->new_value = new_value;
+    entry->reason = reason;
+    entry->result = result;
+    adapt_changes++;
+    taskEXIT_CRITICAL();
+
+    adapt_changed = true;
+    adapt_last_change_ms = now_ms;
+    radar_counter_adapt_reset(now_ms);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_decide
+ ********************************************************************************
+ * Summary:
+ *   Evaluates the window after a completed zone occupation. Occupations
+ *   without crossing lower the sensitivity; busy traffic with long
+ *   occupations (merged crossings) or an in/out imbalance raise it.
+ *
+ * Parameters:
+ *   now_ms: current time
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_adapt_decide(uint64_t now_ms)
+{
+    const adapt_counts_t *window = &adapt_window;
+    uint32_t crossings = window->in + window->out;
+
+    if (!adapt_enabled || (window->occupations < RADAR_COUNTER_ADAPT_MIN_SAMPLES))
+    {
+        return;
+    }
+
+    uint64_t span_ms = now_ms - adapt_window_start_ms;
+    if (span_ms > ADAPT_WINDOW_MS)
+    {
+        span_ms = ADAPT_WINDOW_MS;
+    }
+    if (span_ms < RADAR_COUNTER_ADAPT_BUCKET_MS)
+    {
+        span_ms = RADAR_COUNTER_ADAPT_BUCKET_MS;
+    }
+    uint32_t rate = (uint32_t)(((uint64_t)crossings * 60000U) / span_ms);
+    uint32_t mean_occupied_ms = window->occupied_ms / window->occupations;
+    uint32_t imbalance = (window->in > window->out) ? (window->in - window->out) : (window->out - window->in);
+
+    if ((window->false_occupations * 100U) >= (window->occupations * RADAR_COUNTER_ADAPT_FALSE_PERCENT))
+    {
+        radar_counter_adapt_change(-1, RADAR_COUNTER_ADAPT_REASON_FALSE, now_ms);
+    }
+    else if ((rate >= RADAR_COUNTER_ADAPT_BUSY_RATE) && (mean_occupied_ms >= RADAR_COUNTER_ADAPT_LONG_OCCUPIED_MS))
+    {
+        radar_counter_adapt_change(1, RADAR_COUNTER_ADAPT_REASON_MERGED, now_ms);
+    }
+    else if ((crossings >= RADAR_COUNTER_ADAPT_MIN_SAMPLES) &&
+             ((imbalance * 100U) > (crossings * RADAR_COUNTER_ADAPT_IMBALANCE_PERCENT)))
+    {
+        radar_counter_adapt_change(1, RADAR_COUNTER_ADAPT_REASON_IMBALANCE, now_ms);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_sink
+ ********************************************************************************
+ * Summary:
+ *   Event bus sink that adds an event to the current bucket and to the
+ *   window sums. Constant time and memory per event.
+ *
+ * Parameters:
+ *   event: counter event
+ *   arg: unused
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_adapt_sink(const radar_counter_event_t *event, void *arg)
+{
+    uint64_t now_ms = event->time_us / 1000U;
+
+    radar_counter_adapt_advance(now_ms);
+    adapt_counts_t *bucket = &adapt_buckets[adapt_bucket];
+
+    taskENTER_CRITICAL();
+    switch (event->event)
+    {
+        case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
+            bucket->in++;
+            adapt_window.in++;
+            adapt_crossed = true;
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
+            bucket->out++;
+            adapt_window.out++;
+            adapt_crossed = true;
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
+            adapt_occupied = true;
+            adapt_crossed = false;
+            adapt_occupied_start_ms = now_ms;
+            break;
+        default:
+            if (adapt_occupied)
+            {
+                uint32_t occupied_ms = (uint32_t)(now_ms - adapt_occupied_start_ms);
+                bucket->occupations++;
+                bucket->occupied_ms += occupied_ms;
+                adapt_window.occupations++;
+                adapt_window.occupied_ms += occupied_ms;
+                if (!adapt_crossed)
+                {
+                    bucket->false_occupations++;
+                    adapt_window.false_occupations++;
+                }
+            }
+            adapt_occupied = false;
+            break;
+    }
+    taskEXIT_CRITICAL();
+
+    if (event->event == MTB_RADAR_SENSING_EVENT_COUNTER_FREE)
+    {
+        radar_counter_adapt_decide(now_ms);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_init
+ ********************************************************************************
+ * Summary:
+ *   Subscribes the controller to all counter events.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the subscription
+ *******************************************************************************/
+cy_rslt_t radar_counter_adapt_init(void)
+{
+    return radar_event_bus_subscribe(&adapt_sink,
+                                     "adapt",
+                                     RADAR_EVENT_BUS_FILTER_ALL,
+                                     radar_counter_adapt_sink,
+                                     NULL,
+                                     adapt_sink_storage,
+                                     sizeof(adapt_sink_storage));
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_enable
+ ********************************************************************************
+ * Summary:
+ *   Enables or disables the adaptation. The sensitivity is kept when the
+ *   adaptation is disabled.
+ *
+ * Parameters:
+ *   enable: true to enable
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_adapt_enable(bool enable)
+{
+    adapt_enabled = enable;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_get_stats
+ ********************************************************************************
+ * Summary:
+ *   Copies the window statistics.
+ *
+ * Parameters:
+ *   stats: copy of the statistics
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_adapt_get_stats(radar_counter_adapt_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    stats->enabled = adapt_enabled;
+    stats->crossings = adapt_window.in + adapt_window.out;
+    stats->in = adapt_window.in;
+    stats->out = adapt_window.out;
+    stats->occupations = adapt_window.occupations;
+    stats->false_occupations = adapt_window.false_occupations;
+    stats->occupied_ms = adapt_window.occupied_ms;
+    stats->changes = adapt_changes;
+    stats->rate_limited = adapt_rate_limited;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_get_log
+ ********************************************************************************
+ * Summary:
+ *   Copies the logged changes, the oldest first.
+ *
+ * Parameters:
+ *   log: copy of the changes
+ *   length: maximum number of changes to copy
+ *
+ * Return:
+ *   number of changes copied
+ *******************************************************************************/
+uint32_t radar_counter_adapt_get_log(radar_counter_adapt_change_t *log, uint32_t length)
+{
+    taskENTER_CRITICAL();
+    uint32_t count = (adapt_changes < RADAR_COUNTER_ADAPT_LOG_LENGTH) ? adapt_changes : RADAR_COUNTER_ADAPT_LOG_LENGTH;
+    if (count > length)
+    {
+        count = length;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        log[i] = adapt_log[(adapt_changes - count + i) % RADAR_COUNTER_ADAPT_LOG_LENGTH];
+    }
+    taskEXIT_CRITICAL();
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_adapt_reason
+ ********************************************************************************
+ * Summary:
+ *   Gets the text of a change reason.
+ *
+ * Parameters:
+ *   reason: reason
+ *
+ * Return:
+ *   text
+ *******************************************************************************/
+const char *radar_counter_adapt_reason(radar_counter_adapt_reason_t reason)
+{
+    switch (reason)
+    {
+        case RADAR_COUNTER_ADAPT_REASON_MERGED:
+            return "merged crossings";
+        case RADAR_COUNTER_ADAPT_REASON_IMBALANCE:
+            return "in/out imbalance";
+        default:
+            return "false triggers";
+    }
+}
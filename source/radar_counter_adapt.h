@@ -0,0 +1,111 @@
+/******************************************************************************
+** File name: radar_counter_adapt.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_counter_adapt.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Set to 1 to start with the adaptation enabled, 'a' toggles it */
+#ifndef RADAR_COUNTER_ADAPT_ENABLE
+#define RADAR_COUNTER_ADAPT_ENABLE (0)
+#endif
+
+/* Operator bounds and step of the sensitivity, in thousandths */
+#define RADAR_COUNTER_ADAPT_MIN  (300)
+#define RADAR_COUNTER_ADAPT_MAX  (900)
+#define RADAR_COUNTER_ADAPT_STEP (50)
+
+/* Sliding window: RADAR_COUNTER_ADAPT_BUCKETS buckets of
+ * RADAR_COUNTER_ADAPT_BUCKET_MS each */
+#define RADAR_COUNTER_ADAPT_BUCKETS   (12U)
+#define RADAR_COUNTER_ADAPT_BUCKET_MS (5U * 60000U)
+/* Minimum time between two changes */
+#define RADAR_COUNTER_ADAPT_MIN_INTERVAL_MS (15U * 60000U)
+/* Minimum number of zone occupations in the window before deciding */
+#define RADAR_COUNTER_ADAPT_MIN_SAMPLES (10U)
+
+/* Busy traffic: crossings per minute, with the zone occupied longer than
+ * RADAR_COUNTER_ADAPT_LONG_OCCUPIED_MS on average, hints at merged
+ * crossings */
+#define RADAR_COUNTER_ADAPT_BUSY_RATE          (10U)
+#define RADAR_COUNTER_ADAPT_LONG_OCCUPIED_MS   (3000U)
+/* Percentage of occupations without crossing that hints at false triggers */
+#define RADAR_COUNTER_ADAPT_FALSE_PERCENT      (50U)
+/* Percentage of in/out imbalance that hints at missed crossings */
+#define RADAR_COUNTER_ADAPT_IMBALANCE_PERCENT  (20U)
+
+/* Number of changes kept in the log */
+#define RADAR_COUNTER_ADAPT_LOG_LENGTH (8U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Reasons for a sensitivity change */
+typedef enum
+{
+    RADAR_COUNTER_ADAPT_REASON_MERGED,    // busy with long occupations, raised
+    RADAR_COUNTER_ADAPT_REASON_IMBALANCE, // in/out imbalance, raised
+    RADAR_COUNTER_ADAPT_REASON_FALSE      // occupations without crossing, lowered
+} radar_counter_adapt_reason_t;
+
+/* Logged sensitivity change */
+typedef struct
+{
+    uint64_t timestamp_ms;
+    int32_t old_value;  // thousandths
+    int32_t new_value;  // thousandths
+    radar_counter_adapt_reason_t reason;
+    cy_rslt_t result;   // result of setting the parameter
+} radar_counter_adapt_change_t;
+
+/* Window statistics and controller state */
+typedef struct
+{
+    bool enabled;
+    uint32_t crossings;       // IN and OUT events in the window
+    uint32_t in;
+    uint32_t out;
+    uint32_t occupations;     // completed zone occupations in the window
+    uint32_t false_occupations; // occupations without crossing
+    uint32_t occupied_ms;     // total occupied time of the completed occupations
+    uint32_t changes;         // changes since startup
+    uint32_t rate_limited;    // decisions suppressed by the minimum interval
+} radar_counter_adapt_stats_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t radar_counter_adapt_init(void);
+void radar_counter_adapt_enable(bool enable);
+void radar_counter_adapt_get_stats(radar_counter_adapt_stats_t *stats);
+uint32_t radar_counter_adapt_get_log(radar_counter_adapt_change_t *log, uint32_t length);
+const char *radar_counter_adapt_reason(radar_counter_adapt_reason_t reason);
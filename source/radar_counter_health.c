@@ -0,0 +1,248 @@
+/*****************************************************************************
+** File name: radar_counter_health.c
+**
+** Description: This file implements the supervision of the radar processing:
+** detection of processing errors and stalls, bookkeeping of recoveries and
+** the hardware watchdog.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "radar_counter_health.h"
+#include "radar_counter_task.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static radar_counter_health_stats_t health_stats;
+static volatile bool health_faulted = false;  // fault detected, recovery pending
+static volatile uint64_t health_fault_ms = 0; // time of fault detection
+static cy_timer_t health_timer;
+#if RADAR_COUNTER_HEALTH_WDT_ENABLE
+static cyhal_wdt_t health_wdt;
+#endif
+
+/*******************************************************************************
+ * Function Name: radar_counter_health_fault
+ ********************************************************************************
+ * Summary:
+ *   Records the detection of a fault and requests a recovery.
+ *
+ * Parameters:
+ *   time_ms: time of detection
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_health_fault(uint64_t time_ms)
+{
+    taskENTER_CRITICAL();
+    if (!health_faulted)
+    {
+        health_fault_ms = time_ms;
+        health_faulted = true;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_health_check
+ ********************************************************************************
+ * Summary:
+ *   Timer callback that detects a stalled processing loop. Runs in the timer
+ *   service task, so it only sees stalls during which the processing task
+ *   blocks, see radar_counter_health.h. last_success_ms is 64 bits wide and
+ *   written by the processing task, so it is read in a critical section.
+ *
+ * Parameters:
+ *   arg: unused
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_health_check(cy_timer_callback_arg_t arg)
+{
+    uint64_t now_ms = ifx_currenttime();
+
+    taskENTER_CRITICAL();
+    uint64_t last_success_ms = health_stats.last_success_ms;
+    taskEXIT_CRITICAL();
+
+    if (!health_faulted && (now_ms > last_success_ms) &&
+        ((now_ms - last_success_ms) > RADAR_COUNTER_HEALTH_STALL_TIMEOUT_MS))
+    {
+        health_stats.stalls++;
+        radar_counter_health_fault(now_ms);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_health_init
+ ********************************************************************************
+ * Summary:
+ *   Starts the stall detection and the hardware watchdog. Must be called
+ *   right before the processing loop starts.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the initialization
+ *******************************************************************************/
+cy_rslt_t radar_counter_health_init(void)
+{
+    taskENTER_CRITICAL();
+    health_stats.last_success_ms = ifx_currenttime();
+    taskEXIT_CRITICAL();
+
+    cy_rslt_t result = cy_rtos_init_timer(&health_timer, CY_TIMER_TYPE_PERIODIC, radar_counter_health_check, NULL);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cy_rtos_start_timer(&health_timer, RADAR_COUNTER_HEALTH_CHECK_PERIOD_MS);
+    }
+#if RADAR_COUNTER_HEALTH_WDT_ENABLE
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_wdt_init(&health_wdt, RADAR_COUNTER_HEALTH_WDT_TIMEOUT_MS);
+    }
+#endif
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_health_process_ok
+ ********************************************************************************
+ * Summary:
+ *   Records a successful processing call and feeds the watchdog.
+ *
+ * Parameters:
+ *   time_ms: time of the call
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_health_process_ok(uint64_t time_ms)
+{
+    taskENTER_CRITICAL();
+    health_stats.last_success_ms = time_ms;
+    taskEXIT_CRITICAL();
+#if RADAR_COUNTER_HEALTH_WDT_ENABLE
+    cyhal_wdt_kick(&health_wdt);
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_health_process_error
+ ********************************************************************************
+ * Summary:
+ *   Records a failed processing or configuration call and requests a
+ *   recovery.
+ *
+ * Parameters:
+ *   result: result of the failed call
+ *   time_ms: time of the call
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_health_process_error(cy_rslt_t result, uint64_t time_ms)
+{
+    health_stats.process_errors++;
+    health_stats.last_error = result;
+    radar_counter_health_fault(time_ms);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_health_recovery_requested
+ ********************************************************************************
+ * Summary:
+ *   Tells whether the radar needs to be re-initialized.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if a fault was detected and not yet recovered
+ *******************************************************************************/
+bool radar_counter_health_recovery_requested(void)
+{
+    return health_faulted;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_health_recovery_attempt
+ ********************************************************************************
+ * Summary:
+ *   Records the outcome of a re-initialization attempt. The watchdog is fed
+ *   as long as recovery attempts are being made.
+ *
+ * Parameters:
+ *   success: true if the radar was re-initialized
+ *   time_ms: time at the end of the attempt
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_health_recovery_attempt(bool success, uint64_t time_ms)
+{
+#if RADAR_COUNTER_HEALTH_WDT_ENABLE
+    cyhal_wdt_kick(&health_wdt);
+#endif
+    if (!success)
+    {
+        health_stats.recovery_failures++;
+        return;
+    }
+
+    uint32_t duration_ms = (uint32_t)(time_ms - health_fault_ms);
+    health_stats.recoveries++;
+    health_stats.last_recovery_ms = duration_ms;
+    if (duration_ms > health_stats.max_recovery_ms)
+    {
+        health_stats.max_recovery_ms = duration_ms;
+    }
+    taskENTER_CRITICAL();
+    health_stats.last_success_ms = time_ms;
+    health_faulted = false;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_health_get_stats
+ ********************************************************************************
+ * Summary:
+ *   Copies the health statistics.
+ *
+ * Parameters:
+ *   stats: copy of the statistics
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_health_get_stats(radar_counter_health_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = health_stats;
+    taskEXIT_CRITICAL();
+}
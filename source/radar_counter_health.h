@@ -0,0 +1,80 @@
+/******************************************************************************
+** File name: radar_counter_health.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_counter_health.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Processing is considered stalled after this time without a successful call.
+ * The check runs in the FreeRTOS timer service task (configTIMER_TASK_PRIORITY),
+ * below the radar counter task, so it detects a processing loop that blocks or
+ * keeps failing, e.g. waiting for SPI transfers that never complete. A
+ * processing call that never returns without blocking starves the check;
+ * only the hardware watchdog below covers that case. */
+#define RADAR_COUNTER_HEALTH_STALL_TIMEOUT_MS (100U)
+/* Period of the stall check */
+#define RADAR_COUNTER_HEALTH_CHECK_PERIOD_MS (50U)
+/* Delay between failed recovery attempts */
+#define RADAR_COUNTER_HEALTH_RETRY_DELAY_MS (500U)
+
+/* Hardware watchdog, last resort if processing never returns. Disable while
+ * debugging, since the watchdog keeps running while the CPU is halted. */
+#ifndef RADAR_COUNTER_HEALTH_WDT_ENABLE
+#define RADAR_COUNTER_HEALTH_WDT_ENABLE (1)
+#endif
+#define RADAR_COUNTER_HEALTH_WDT_TIMEOUT_MS (4000U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Health statistics of the radar processing */
+typedef struct
+{
+    uint32_t process_errors;    // failed mtb_radar_sensing_process calls
+    uint32_t stalls;            // processing stalls detected
+    uint32_t recoveries;        // successful re-initializations
+    uint32_t recovery_failures; // failed re-initialization attempts
+    cy_rslt_t last_error;       // result of the last failed call
+    uint32_t last_recovery_ms;  // time from fault detection to recovery
+    uint32_t max_recovery_ms;
+    uint64_t last_success_ms;   // time of the last successful processing
+} radar_counter_health_stats_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t radar_counter_health_init(void);
+void radar_counter_health_process_ok(uint64_t time_ms);
+void radar_counter_health_process_error(cy_rslt_t result, uint64_t time_ms);
+bool radar_counter_health_recovery_requested(void);
+void radar_counter_health_recovery_attempt(bool success, uint64_t time_ms);
+void radar_counter_health_get_stats(radar_counter_health_stats_t *stats);
@@ -0,0 +1,478 @@
+/*****************************************************************************
+** File name: radar_counter_params.c
+**
+** Description: This file generates the entrance counter parameter table and
+** implements lookup and validation of parameter values.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "radar_counter_params.h"
+#include "radar_counter_retain.h"
+#include "radar_counter_task.h"
+#include "radar_format.h"
+#include "radar_lock.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Expansion of the value descriptions of the parameter table */
+#define RADAR_COUNTER_PARAM_CHOICES(...)                                \
+    .type = RADAR_COUNTER_PARAM_TYPE_CHOICE,                            \
+    .choices = (const char *const[]){__VA_ARGS__},                      \
+    .num_choices = sizeof((const char *const[]){__VA_ARGS__}) / sizeof(const char *)
+
+#define RADAR_COUNTER_PARAM_RANGE(min_value, max_value) \
+    .type = RADAR_COUNTER_PARAM_TYPE_NUMBER,            \
+    .min = (int32_t)((min_value) * 1000),               \
+    .max = (int32_t)((max_value) * 1000),               \
+    .min_text = #min_value,                             \
+    .max_text = #max_value
+
+#define RADAR_COUNTER_PARAM_ENTRY(id, param_key, param_name, param_label, param_unit, values) \
+    [RADAR_COUNTER_PARAM_##id] = {.key = param_key,                                           \
+                                  .name = param_name,                                         \
+                                  .label = param_label,                                       \
+                                  .unit = param_unit,                                         \
+                                  values},
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+const radar_counter_param_t radar_counter_params[RADAR_COUNTER_PARAM_COUNT] = {
+    RADAR_COUNTER_PARAMS(RADAR_COUNTER_PARAM_ENTRY)
+};
+
+/* Parameter snapshot, published seqlock style: the sequence is odd while
+ * the snapshot is being written. */
+static radar_counter_param_snapshot_t param_snapshot;
+static volatile uint32_t param_sequence = 0;
+static radar_lock_t param_write_mutex; // serializes writers
+static bool param_online = true; // false while the library is re-initialized
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_find_key
+ ********************************************************************************
+ * Summary:
+ *   Looks up the parameter configured with a terminal UI key.
+ *
+ * Parameters:
+ *   key: terminal UI key
+ *
+ * Return:
+ *   parameter description, NULL if no parameter uses the key
+ *******************************************************************************/
+const radar_counter_param_t *radar_counter_params_find_key(char key)
+{
+    for (int i = 0; i < RADAR_COUNTER_PARAM_COUNT; i++)
+    {
+        if (radar_counter_params[i].key == key)
+        {
+            return &radar_counter_params[i];
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_validate
+ ********************************************************************************
+ * Summary:
+ *   Checks a value against the choices or the range of a parameter.
+ *
+ * Parameters:
+ *   param: parameter description
+ *   value: value to be checked
+ *
+ * Return:
+ *   true if the value is valid for the parameter
+ *******************************************************************************/
+bool radar_counter_params_validate(const radar_counter_param_t *param, const char *value)
+{
+    if (param->type == RADAR_COUNTER_PARAM_TYPE_CHOICE)
+    {
+        for (int i = 0; i < param->num_choices; i++)
+        {
+            if (strcmp(param->choices[i], value) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int32_t number;
+    return radar_format_parse_fixed(value, &number) && (number >= param->min) && (number <= param->max);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_to_value
+ ********************************************************************************
+ * Summary:
+ *   Converts a parameter value string into its typed representation.
+ *
+ * Parameters:
+ *   param: parameter description
+ *   text: value string
+ *   value: typed value
+ *
+ * Return:
+ *   true if the string could be converted
+ *******************************************************************************/
+static bool radar_counter_params_to_value(const radar_counter_param_t *param, const char *text, int32_t *value)
+{
+    if (param->type == RADAR_COUNTER_PARAM_TYPE_NUMBER)
+    {
+        return radar_format_parse_fixed(text, value);
+    }
+
+    for (int i = 0; i < param->num_choices; i++)
+    {
+        if (strcmp(param->choices[i], text) == 0)
+        {
+            *value = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_publish
+ ********************************************************************************
+ * Summary:
+ *   Replaces the snapshot with a new set of values. All values are written
+ *   under one sequence update, so readers see either the old or the new set,
+ *   never a mix of both. The update runs in a critical section, so on this
+ *   single core readers never observe a write in progress and never have to
+ *   spin.
+ *
+ * Parameters:
+ *   values: new parameter values
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_params_publish(const radar_counter_param_snapshot_t *values)
+{
+    taskENTER_CRITICAL();
+    param_sequence++;
+    __DMB();
+    param_snapshot = *values;
+    __DMB();
+    param_sequence++;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the lock of the parameters. Must be called before any other
+ *   function of this module.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the initialization
+ *******************************************************************************/
+cy_rslt_t radar_counter_params_init(void)
+{
+    return radar_lock_init(&param_write_mutex, "params");
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_load
+ ********************************************************************************
+ * Summary:
+ *   Loads the snapshot with the current values of the RadarSensing library.
+ *   Must be called once the sensing context is initialized.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_params_load(void)
+{
+    char text[32];
+
+    radar_counter_params_lock();
+    radar_counter_param_snapshot_t values = param_snapshot;
+    for (int i = 0; i < RADAR_COUNTER_PARAM_COUNT; i++)
+    {
+        int32_t value = 0;
+        if ((mtb_radar_sensing_get_parameter(&sensing_context, radar_counter_params[i].name, text, sizeof(text)) ==
+             MTB_RADAR_SENSING_SUCCESS) &&
+            radar_counter_params_to_value(&radar_counter_params[i], text, &value))
+        {
+            values.value[i] = value;
+        }
+    }
+    radar_counter_params_publish(&values);
+    radar_counter_params_unlock();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_restore
+ ********************************************************************************
+ * Summary:
+ *   Sets the values of a snapshot, e.g. one retained across a reset. Only
+ *   values that differ from the current ones are set in the RadarSensing
+ *   library. While the library is offline, they are only stored.
+ *
+ * Parameters:
+ *   snapshot: values to be set
+ *
+ * Return:
+ *   Status of the first failing call, MTB_RADAR_SENSING_SUCCESS otherwise
+ *******************************************************************************/
+cy_rslt_t radar_counter_params_restore(const radar_counter_param_snapshot_t *snapshot)
+{
+    char text[32];
+    cy_rslt_t result = MTB_RADAR_SENSING_SUCCESS;
+
+    radar_counter_params_lock();
+    radar_counter_param_snapshot_t values = param_snapshot;
+    for (int i = 0; (i < RADAR_COUNTER_PARAM_COUNT) && (result == MTB_RADAR_SENSING_SUCCESS); i++)
+    {
+        if (snapshot->value[i] == param_snapshot.value[i])
+        {
+            continue;
+        }
+        if (param_online)
+        {
+            (void)radar_counter_params_format(&radar_counter_params[i], snapshot->value[i], text, sizeof(text));
+            result = mtb_radar_sensing_set_parameter(&sensing_context, radar_counter_params[i].name, text);
+        }
+        if (result == MTB_RADAR_SENSING_SUCCESS)
+        {
+            values.value[i] = snapshot->value[i];
+        }
+    }
+    radar_counter_params_publish(&values);
+    radar_counter_retain_store_params(&param_snapshot);
+    radar_counter_params_unlock();
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_set
+ ********************************************************************************
+ * Summary:
+ *   Validates a value, sets it in the RadarSensing library and, on success,
+ *   updates the snapshot and the values retained across resets. While the
+ *   library is offline, the value is only stored and set by
+ *   radar_counter_params_apply once the library is back.
+ *
+ * Parameters:
+ *   param: parameter description
+ *   value: value string
+ *
+ * Return:
+ *   RADAR_COUNTER_PARAMS_RSLT_ERR_INVALID_VALUE if the value is not valid,
+ *   otherwise the result of mtb_radar_sensing_set_parameter
+ *******************************************************************************/
+cy_rslt_t radar_counter_params_set(const radar_counter_param_t *param, const char *value)
+{
+    int32_t typed;
+
+    if (!radar_counter_params_validate(param, value) || !radar_counter_params_to_value(param, value, &typed))
+    {
+        return RADAR_COUNTER_PARAMS_RSLT_ERR_INVALID_VALUE;
+    }
+
+    radar_counter_params_lock();
+    cy_rslt_t result = param_online ? mtb_radar_sensing_set_parameter(&sensing_context, param->name, value)
+                                    : MTB_RADAR_SENSING_SUCCESS;
+    if (result == MTB_RADAR_SENSING_SUCCESS)
+    {
+        radar_counter_param_snapshot_t values = param_snapshot;
+        values.value[param - radar_counter_params] = typed;
+        radar_counter_params_publish(&values);
+        radar_counter_retain_store_params(&param_snapshot);
+    }
+    radar_counter_params_unlock();
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_apply
+ ********************************************************************************
+ * Summary:
+ *   Sets all parameters of the snapshot in the RadarSensing library, e.g.
+ *   after the library was re-initialized.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the first failing call, MTB_RADAR_SENSING_SUCCESS otherwise
+ *******************************************************************************/
+cy_rslt_t radar_counter_params_apply(void)
+{
+    char text[32];
+    radar_counter_param_snapshot_t snapshot;
+    cy_rslt_t result = MTB_RADAR_SENSING_SUCCESS;
+
+    radar_counter_params_get_snapshot(&snapshot);
+    radar_counter_params_lock();
+    for (int i = 0; (i < RADAR_COUNTER_PARAM_COUNT) && (result == MTB_RADAR_SENSING_SUCCESS); i++)
+    {
+        (void)radar_counter_params_format(&radar_counter_params[i], snapshot.value[i], text, sizeof(text));
+        result = mtb_radar_sensing_set_parameter(&sensing_context, radar_counter_params[i].name, text);
+    }
+    radar_counter_params_unlock();
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_set_online
+ ********************************************************************************
+ * Summary:
+ *   Marks the RadarSensing library as available or not. While it is offline,
+ *   e.g. between deinit and init during a recovery, parameter changes are
+ *   not passed to the library. Must be called with the lock held.
+ *
+ * Parameters:
+ *   online: true if the library is initialized
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_params_set_online(bool online)
+{
+    param_online = online;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_lock
+ ********************************************************************************
+ * Summary:
+ *   Blocks parameter changes, e.g. while the RadarSensing library is being
+ *   re-initialized. The lock is recursive.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_params_lock(void)
+{
+    (void)radar_lock_get(&param_write_mutex, CY_RTOS_NEVER_TIMEOUT);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_unlock
+ ********************************************************************************
+ * Summary:
+ *   Allows parameter changes again.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_params_unlock(void)
+{
+    (void)radar_lock_release(&param_write_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_get_snapshot
+ ********************************************************************************
+ * Summary:
+ *   Copies a consistent snapshot of all parameter values without locking.
+ *   The copy is retried if a writer updated the snapshot meanwhile.
+ *
+ * Parameters:
+ *   snapshot: copy of the parameter values
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_params_get_snapshot(radar_counter_param_snapshot_t *snapshot)
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = param_sequence;
+        __DMB();
+        *snapshot = param_snapshot;
+        __DMB();
+    } while (((sequence & 1U) != 0U) || (sequence != param_sequence));
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_get
+ ********************************************************************************
+ * Summary:
+ *   Returns the current value of one parameter.
+ *
+ * Parameters:
+ *   id: parameter identifier
+ *
+ * Return:
+ *   typed value
+ *******************************************************************************/
+int32_t radar_counter_params_get(radar_counter_param_id_t id)
+{
+    /* A single aligned word is read atomically */
+    return param_snapshot.value[id];
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_params_format
+ ********************************************************************************
+ * Summary:
+ *   Converts a typed value into text: the choice string, or the number with
+ *   trailing zero decimals removed.
+ *
+ * Parameters:
+ *   param: parameter description
+ *   value: typed value
+ *   text: destination of the text
+ *   size: size of the destination
+ *
+ * Return:
+ *   length of the text
+ *******************************************************************************/
+int radar_counter_params_format(const radar_counter_param_t *param, int32_t value, char *text, size_t size)
+{
+    if (param->type == RADAR_COUNTER_PARAM_TYPE_CHOICE)
+    {
+        const char *choice = ((value >= 0) && (value < param->num_choices)) ? param->choices[value] : "?";
+        return (int)radar_format_string(text, size, choice);
+    }
+
+    return (int)radar_format_fixed(text, size, value);
+}
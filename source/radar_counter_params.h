@@ -0,0 +1,138 @@
+/******************************************************************************
+** File name: radar_counter_params.h
+**
+** Description: This file contains the table of entrance counter parameters
+**   configurable from the terminal UI, together with the function
+**   prototypes and constants used in radar_counter_params.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Parameter table
+ *******************************************************************************/
+/* Every entrance counter parameter is described once here. The menu, the
+ * key handling, the range validation and the parameter identifiers are all
+ * generated from this table.
+ *
+ * X(id, key, library name, label, unit, values)
+ *
+ * values is either RADAR_COUNTER_PARAM_CHOICES(choice, ...) or
+ * RADAR_COUNTER_PARAM_RANGE(min, max). Ranges are written as decimal
+ * literals and stored in thousandths, so no floating point is used at run
+ * time. The order of the table defines the parameter identifiers used in
+ * binary records; append new parameters at the end. */
+#define RADAR_COUNTER_PARAMS(X)                                                                     \
+    X(INSTALLATION,       'i', "radar_counter_installation",       "installation",       "",  \
+      RADAR_COUNTER_PARAM_CHOICES("ceiling", "side"))                                         \
+    X(ORIENTATION,        'o', "radar_counter_orientation",        "orientation",        "",  \
+      RADAR_COUNTER_PARAM_CHOICES("landscape", "portrait"))                                   \
+    X(CEILING_HEIGHT,     'h', "radar_counter_ceiling_height",     "ceiling height",     "m", \
+      RADAR_COUNTER_PARAM_RANGE(0.0, 3.0))                                                    \
+    X(ENTRANCE_WIDTH,     'w', "radar_counter_entrance_width",     "entrance width",     "m", \
+      RADAR_COUNTER_PARAM_RANGE(0.0, 3.0))                                                    \
+    X(SENSITIVITY,        's', "radar_counter_sensitivity",        "sensitivity",        "",  \
+      RADAR_COUNTER_PARAM_RANGE(0.0, 1.0))                                                    \
+    X(TRAFFIC_LIGHT_ZONE, 't', "radar_counter_traffic_light_zone", "traffic light zone", "m", \
+      RADAR_COUNTER_PARAM_RANGE(0.0, 1.0))                                                    \
+    X(REVERSE,            'r', "radar_counter_reverse",            "reverse",            "",  \
+      RADAR_COUNTER_PARAM_CHOICES("true", "false"))                                           \
+    X(MIN_PERSON_HEIGHT,  'm', "radar_counter_min_person_height",  "min person height",  "m", \
+      RADAR_COUNTER_PARAM_RANGE(0.0, 2.0))
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Value rejected by validation, the parameter was not set */
+#define RADAR_COUNTER_PARAMS_RSLT_ERR_INVALID_VALUE \
+    (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x80U))
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Parameter identifiers */
+#define RADAR_COUNTER_PARAM_ID(id, key, name, label, unit, values) RADAR_COUNTER_PARAM_##id,
+typedef enum
+{
+    RADAR_COUNTER_PARAMS(RADAR_COUNTER_PARAM_ID)
+    RADAR_COUNTER_PARAM_COUNT
+} radar_counter_param_id_t;
+#undef RADAR_COUNTER_PARAM_ID
+
+/* Kinds of parameter values */
+typedef enum
+{
+    RADAR_COUNTER_PARAM_TYPE_CHOICE, // one string out of a list of choices
+    RADAR_COUNTER_PARAM_TYPE_NUMBER  // decimal number within a range
+} radar_counter_param_type_t;
+
+/* Description of a parameter */
+typedef struct
+{
+    char key;                   // terminal UI key
+    const char *name;           // RadarSensing library parameter name
+    const char *label;          // text shown in the terminal UI
+    const char *unit;           // unit of numbers, empty if none
+    radar_counter_param_type_t type;
+    const char *const *choices; // choices of RADAR_COUNTER_PARAM_TYPE_CHOICE
+    uint8_t num_choices;
+    int32_t min;                // range of RADAR_COUNTER_PARAM_TYPE_NUMBER in thousandths
+    int32_t max;
+    const char *min_text;       // range as written in the table
+    const char *max_text;
+} radar_counter_param_t;
+
+/* Typed copy of all parameter values: index of the choice for
+ * RADAR_COUNTER_PARAM_TYPE_CHOICE, number in thousandths for
+ * RADAR_COUNTER_PARAM_TYPE_NUMBER */
+typedef struct
+{
+    int32_t value[RADAR_COUNTER_PARAM_COUNT];
+} radar_counter_param_snapshot_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+extern const radar_counter_param_t radar_counter_params[RADAR_COUNTER_PARAM_COUNT];
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+const radar_counter_param_t *radar_counter_params_find_key(char key);
+bool radar_counter_params_validate(const radar_counter_param_t *param, const char *value);
+cy_rslt_t radar_counter_params_init(void);
+void radar_counter_params_load(void);
+cy_rslt_t radar_counter_params_restore(const radar_counter_param_snapshot_t *snapshot);
+cy_rslt_t radar_counter_params_set(const radar_counter_param_t *param, const char *value);
+cy_rslt_t radar_counter_params_apply(void);
+void radar_counter_params_set_online(bool online);
+void radar_counter_params_lock(void);
+void radar_counter_params_unlock(void);
+void radar_counter_params_get_snapshot(radar_counter_param_snapshot_t *snapshot);
+int32_t radar_counter_params_get(radar_counter_param_id_t id);
+int radar_counter_params_format(const radar_counter_param_t *param, int32_t value, char *text, size_t size);
@@ -0,0 +1,504 @@
+/*****************************************************************************
+** File name: radar_counter_profiles.c
+**
+** Description: This file implements named configuration profiles stored in flash. A
+** profile selected by command or by its schedule is applied by the radar
+** counter task between two processing calls.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "cyhal.h"
+
+/* Header file for library */
+#include "mtb_radar_sensing.h"
+
+/* Header file for local module */
+#include "radar_clock.h"
+#include "radar_counter_profiles.h"
+#include "radar_crc.h"
+#include "radar_lock.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+#define PROFILES_MAGIC (0x464F5250UL) // "PROF"
+/* Changes whenever the parameter table changes size */
+#define PROFILES_LAYOUT (((uint32_t)RADAR_COUNTER_PARAM_COUNT << 16) | sizeof(radar_counter_profile_t))
+#define PROFILES_MINUTES_PER_DAY (1440U)
+#define PROFILES_MS_PER_MINUTE (60000U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Profiles as stored in flash */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t layout;
+    radar_counter_profile_t profiles[RADAR_COUNTER_PROFILES_MAX];
+    uint32_t crc; // CRC-32 of all preceding bytes
+} radar_counter_profiles_store_t;
+
+/* A flash row holding the store, written as a whole */
+typedef union
+{
+    radar_counter_profiles_store_t store;
+    uint32_t row[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
+} radar_counter_profiles_row_t;
+
+_Static_assert(sizeof(radar_counter_profiles_store_t) <= CY_FLASH_SIZEOF_ROW, "profiles must fit a flash row");
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Flash row in the emulated EEPROM region, erased by programming. Read
+ * through profiles_stored, like the journal rows, so that reads of the
+ * programmed row cannot be folded to the zeros of the initializer. */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8_t profiles_flash[CY_FLASH_SIZEOF_ROW] = {0};
+static const uint8_t *volatile const profiles_stored = profiles_flash;
+
+static cyhal_flash_t profiles_flash_obj;
+static radar_counter_profiles_row_t profiles_row; // RAM copy, written to flash on save
+static radar_lock_t profiles_lock;               // protects the RAM copy
+static volatile int32_t profiles_requested = -1; // profile to be applied by the radar counter task
+static radar_counter_profiles_stats_t profiles_stats = {.active = -1};
+
+/* Time of day, kept as offset to the monotonic clock */
+static volatile bool profiles_time_valid = false;
+static uint64_t profiles_time_offset_ms = 0;
+static uint32_t profiles_last_minute = RADAR_COUNTER_PROFILES_UNSCHEDULED; // minute of the last schedule check
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_crc
+ ********************************************************************************
+ * Summary:
+ *   Calculates the CRC of the profile store.
+ *
+ * Parameters:
+ *   store: profile store
+ *
+ * Return:
+ *   CRC-32 of all fields but the CRC
+ *******************************************************************************/
+static uint32_t radar_counter_profiles_crc(const radar_counter_profiles_store_t *store)
+{
+    return radar_crc32(0U, store, offsetof(radar_counter_profiles_store_t, crc));
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_defaults
+ ********************************************************************************
+ * Summary:
+ *   Fills the store with a "ceiling" and a "side" profile, both with the
+ *   current parameter values and the respective installation.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_profiles_defaults(void)
+{
+    static const char *const names[] = {"ceiling", "side"};
+    radar_counter_profiles_store_t *store = &profiles_row.store;
+
+    memset(&profiles_row, 0, sizeof(profiles_row));
+    store->magic = PROFILES_MAGIC;
+    store->layout = PROFILES_LAYOUT;
+    for (uint32_t i = 0; i < RADAR_COUNTER_PROFILES_MAX; i++)
+    {
+        radar_counter_profile_t *profile = &store->profiles[i];
+        radar_counter_params_get_snapshot(&profile->params);
+        profile->start_minute = RADAR_COUNTER_PROFILES_UNSCHEDULED;
+        if (i < (sizeof(names) / sizeof(names[0])))
+        {
+            strncpy(profile->name, names[i], sizeof(profile->name) - 1U);
+            profile->params.value[RADAR_COUNTER_PARAM_INSTALLATION] = (int32_t)i;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_init
+ ********************************************************************************
+ * Summary:
+ *   Loads the profiles from flash, or creates the default profiles if the
+ *   flash holds none. Must be called once the parameters are configured.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the initialization
+ *******************************************************************************/
+cy_rslt_t radar_counter_profiles_init(void)
+{
+    const radar_counter_profiles_store_t *stored = (const radar_counter_profiles_store_t *)profiles_stored;
+
+    cy_rslt_t result = radar_lock_init(&profiles_lock, "profiles");
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_flash_init(&profiles_flash_obj);
+    }
+
+    if ((stored->magic == PROFILES_MAGIC) && (stored->layout == PROFILES_LAYOUT) &&
+        (stored->crc == radar_counter_profiles_crc(stored)))
+    {
+        memcpy(&profiles_row, profiles_stored, sizeof(profiles_row));
+        for (uint32_t i = 0; i < RADAR_COUNTER_PROFILES_MAX; i++)
+        {
+            profiles_row.store.profiles[i].name[RADAR_COUNTER_PROFILES_NAME_MAXLENGTH - 1U] = '\0';
+        }
+    }
+    else
+    {
+        radar_counter_profiles_defaults();
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_get
+ ********************************************************************************
+ * Summary:
+ *   Copies a profile.
+ *
+ * Parameters:
+ *   index: profile index
+ *   profile: copy of the profile
+ *
+ * Return:
+ *   false if the index is out of range or the slot is unused
+ *******************************************************************************/
+bool radar_counter_profiles_get(uint32_t index, radar_counter_profile_t *profile)
+{
+    if (index >= RADAR_COUNTER_PROFILES_MAX)
+    {
+        return false;
+    }
+    (void)radar_lock_get(&profiles_lock, CY_RTOS_NEVER_TIMEOUT);
+    *profile = profiles_row.store.profiles[index];
+    (void)radar_lock_release(&profiles_lock);
+    return profile->name[0] != '\0';
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_write
+ ********************************************************************************
+ * Summary:
+ *   Writes the profiles to flash. The RAM copy is copied first, so the lock
+ *   is not held during the flash write.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the flash write
+ *******************************************************************************/
+static cy_rslt_t radar_counter_profiles_write(void)
+{
+    static radar_counter_profiles_row_t row;
+
+    (void)radar_lock_get(&profiles_lock, CY_RTOS_NEVER_TIMEOUT);
+    profiles_row.store.crc = radar_counter_profiles_crc(&profiles_row.store);
+    row = profiles_row;
+    (void)radar_lock_release(&profiles_lock);
+
+    cy_rslt_t result = cyhal_flash_write(&profiles_flash_obj, (uint32_t)(uintptr_t)profiles_flash, row.row);
+    Cy_SysLib_ClearFlashCacheAndBuffer();
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_save
+ ********************************************************************************
+ * Summary:
+ *   Saves the current parameter values as profile and writes all profiles
+ *   to flash.
+ *
+ * Parameters:
+ *   index: profile index
+ *   name: profile name, NULL or empty to keep the name of the slot
+ *
+ * Return:
+ *   Status of the flash write, RADAR_COUNTER_PROFILES_RSLT_ERR_INVALID for
+ *   a wrong index or an unused slot without name
+ *******************************************************************************/
+cy_rslt_t radar_counter_profiles_save(uint32_t index, const char *name)
+{
+    if (index >= RADAR_COUNTER_PROFILES_MAX)
+    {
+        return RADAR_COUNTER_PROFILES_RSLT_ERR_INVALID;
+    }
+
+    (void)radar_lock_get(&profiles_lock, CY_RTOS_NEVER_TIMEOUT);
+    radar_counter_profile_t *profile = &profiles_row.store.profiles[index];
+    if ((name != NULL) && (name[0] != '\0'))
+    {
+        memset(profile->name, 0, sizeof(profile->name));
+        strncpy(profile->name, name, sizeof(profile->name) - 1U);
+    }
+    bool named = (profile->name[0] != '\0');
+    if (named)
+    {
+        radar_counter_params_get_snapshot(&profile->params);
+    }
+    (void)radar_lock_release(&profiles_lock);
+
+    return named ? radar_counter_profiles_write() : RADAR_COUNTER_PROFILES_RSLT_ERR_INVALID;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_schedule
+ ********************************************************************************
+ * Summary:
+ *   Sets the minute of the day a profile is applied and writes all profiles
+ *   to flash. Schedules are active once the time of day is set.
+ *
+ * Parameters:
+ *   index: profile index
+ *   start_minute: minute of the day, RADAR_COUNTER_PROFILES_UNSCHEDULED for
+ *   none
+ *
+ * Return:
+ *   Status of the flash write, RADAR_COUNTER_PROFILES_RSLT_ERR_INVALID for
+ *   a wrong index or minute or an unused slot
+ *******************************************************************************/
+cy_rslt_t radar_counter_profiles_schedule(uint32_t index, uint16_t start_minute)
+{
+    if ((index >= RADAR_COUNTER_PROFILES_MAX) ||
+        ((start_minute >= PROFILES_MINUTES_PER_DAY) && (start_minute != RADAR_COUNTER_PROFILES_UNSCHEDULED)))
+    {
+        return RADAR_COUNTER_PROFILES_RSLT_ERR_INVALID;
+    }
+
+    (void)radar_lock_get(&profiles_lock, CY_RTOS_NEVER_TIMEOUT);
+    radar_counter_profile_t *profile = &profiles_row.store.profiles[index];
+    bool named = (profile->name[0] != '\0');
+    if (named)
+    {
+        profile->start_minute = start_minute;
+    }
+    (void)radar_lock_release(&profiles_lock);
+
+    return named ? radar_counter_profiles_write() : RADAR_COUNTER_PROFILES_RSLT_ERR_INVALID;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_select
+ ********************************************************************************
+ * Summary:
+ *   Requests a profile to be applied by the radar counter task before its
+ *   next processing call.
+ *
+ * Parameters:
+ *   index: profile index
+ *
+ * Return:
+ *   false if the index is out of range or the slot is unused
+ *******************************************************************************/
+bool radar_counter_profiles_select(uint32_t index)
+{
+    radar_counter_profile_t profile;
+
+    if (!radar_counter_profiles_get(index, &profile))
+    {
+        return false;
+    }
+    profiles_requested = (int32_t)index;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_set_time
+ ********************************************************************************
+ * Summary:
+ *   Sets the time of day used by the profile schedules while the clock is
+ *   not synchronized with the gateway.
+ *
+ * Parameters:
+ *   minute_of_day: current minute of the day, 0 to 1439
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_profiles_set_time(uint32_t minute_of_day)
+{
+    uint64_t now_ms = radar_clock_ms();
+    uint64_t day_ms = (uint64_t)PROFILES_MINUTES_PER_DAY * PROFILES_MS_PER_MINUTE;
+    uint64_t target_ms = (uint64_t)(minute_of_day % PROFILES_MINUTES_PER_DAY) * PROFILES_MS_PER_MINUTE;
+
+    /* offset such that (now + offset) modulo one day is the time of day */
+    profiles_time_valid = false;
+    profiles_time_offset_ms = (target_ms + day_ms - (now_ms % day_ms)) % day_ms;
+    profiles_last_minute = RADAR_COUNTER_PROFILES_UNSCHEDULED;
+    profiles_time_valid = true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_minute_of_day
+ ********************************************************************************
+ * Summary:
+ *   Determines the current minute of the day. The time of the gateway is
+ *   used once the clock is synchronized, the time set with
+ *   radar_counter_profiles_set_time() before.
+ *
+ * Parameters:
+ *   minute: current minute of the day
+ *
+ * Return:
+ *   false if the time of day is not known
+ *******************************************************************************/
+static bool radar_counter_profiles_minute_of_day(uint32_t *minute)
+{
+    uint64_t day_ms = (uint64_t)PROFILES_MINUTES_PER_DAY * PROFILES_MS_PER_MINUTE;
+    uint64_t reference_us;
+
+    if (radar_clock_reference_us(radar_clock_us(), &reference_us))
+    {
+        /* Gateway time is UTC, the offset is at most one day */
+        int64_t time_ms = (int64_t)((reference_us / 1000U) % day_ms) + (int64_t)day_ms +
+                          ((int64_t)RADAR_COUNTER_PROFILES_UTC_OFFSET_MINUTES * PROFILES_MS_PER_MINUTE);
+        *minute = (uint32_t)(((uint64_t)time_ms % day_ms) / PROFILES_MS_PER_MINUTE);
+        return true;
+    }
+    if (!profiles_time_valid)
+    {
+        return false;
+    }
+    *minute = (uint32_t)(((radar_clock_ms() + profiles_time_offset_ms) / PROFILES_MS_PER_MINUTE) %
+                         PROFILES_MINUTES_PER_DAY);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_check_schedule
+ ********************************************************************************
+ * Summary:
+ *   Requests the profile scheduled for the current minute, once per minute.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_profiles_check_schedule(void)
+{
+    uint32_t minute;
+
+    if (!radar_counter_profiles_minute_of_day(&minute) || (minute == profiles_last_minute))
+    {
+        return;
+    }
+    profiles_last_minute = minute;
+
+    /* Only tried, the next minute is early enough if the UI holds the lock */
+    if (radar_lock_get(&profiles_lock, 0U) != CY_RSLT_SUCCESS)
+    {
+        profiles_last_minute = RADAR_COUNTER_PROFILES_UNSCHEDULED;
+        return;
+    }
+    for (uint32_t i = 0; i < RADAR_COUNTER_PROFILES_MAX; i++)
+    {
+        const radar_counter_profile_t *profile = &profiles_row.store.profiles[i];
+        if ((profile->name[0] != '\0') && (profile->start_minute == minute))
+        {
+            profiles_requested = (int32_t)i;
+        }
+    }
+    (void)radar_lock_release(&profiles_lock);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_poll
+ ********************************************************************************
+ * Summary:
+ *   Applies a requested or scheduled profile. Called by the radar counter
+ *   task between processing calls, so the parameters of a profile are all
+ *   set before the next radar data is processed. Only the values that differ
+ *   from the current ones are set; in/out counts are kept.
+ *
+ * Parameters:
+ *   result: status of the switch, only set if a profile was applied
+ *
+ * Return:
+ *   index of the profile applied, -1 if none
+ *******************************************************************************/
+int32_t radar_counter_profiles_poll(cy_rslt_t *result)
+{
+    radar_counter_profile_t profile;
+
+    radar_counter_profiles_check_schedule();
+
+    int32_t index = profiles_requested;
+    if ((index < 0) || !radar_counter_profiles_get((uint32_t)index, &profile))
+    {
+        return -1;
+    }
+    profiles_requested = -1;
+
+    uint64_t start_us = radar_clock_us();
+    *result = radar_counter_params_restore(&profile.params);
+    uint32_t switch_us = (uint32_t)(radar_clock_us() - start_us);
+
+    taskENTER_CRITICAL();
+    profiles_stats.active = index;
+    profiles_stats.switches++;
+    if (*result != MTB_RADAR_SENSING_SUCCESS)
+    {
+        profiles_stats.failures++;
+    }
+    profiles_stats.last_switch_us = switch_us;
+    if (switch_us > profiles_stats.max_switch_us)
+    {
+        profiles_stats.max_switch_us = switch_us;
+    }
+    taskEXIT_CRITICAL();
+    return index;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_profiles_get_stats
+ ********************************************************************************
+ * Summary:
+ *   Copies the profile switch statistics.
+ *
+ * Parameters:
+ *   stats: copy of the statistics
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_profiles_get_stats(radar_counter_profiles_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = profiles_stats;
+    taskEXIT_CRITICAL();
+    uint32_t minute;
+    stats->time_valid = radar_counter_profiles_minute_of_day(&minute);
+}
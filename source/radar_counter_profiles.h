@@ -0,0 +1,89 @@
+/******************************************************************************
+** File name: radar_counter_profiles.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_counter_profiles.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/* Header file for local module */
+#include "radar_counter_params.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Number of configuration profiles */
+#define RADAR_COUNTER_PROFILES_MAX (4U)
+/* Maximum length of a profile name, including terminator */
+#define RADAR_COUNTER_PROFILES_NAME_MAXLENGTH (12U)
+/* Time zone of the schedules in minutes east of UTC, applied to the gateway
+ * time once the clock is synchronized */
+#ifndef RADAR_COUNTER_PROFILES_UTC_OFFSET_MINUTES
+#define RADAR_COUNTER_PROFILES_UTC_OFFSET_MINUTES (0)
+#endif
+/* Start minute of a profile that is not scheduled */
+#define RADAR_COUNTER_PROFILES_UNSCHEDULED (0xFFFFU)
+
+/* Profile index out of range, unused slot or invalid start minute */
+#define RADAR_COUNTER_PROFILES_RSLT_ERR_INVALID \
+    (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0xA0U))
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Named set of all parameter values */
+typedef struct
+{
+    char name[RADAR_COUNTER_PROFILES_NAME_MAXLENGTH]; // empty for an unused slot
+    uint16_t start_minute;                            // minute of the day the profile is applied
+    uint16_t reserved;
+    radar_counter_param_snapshot_t params;
+} radar_counter_profile_t;
+
+/* Profile switch statistics */
+typedef struct
+{
+    int32_t active;           // index of the profile applied last, -1 if none
+    uint32_t switches;        // profiles applied
+    uint32_t failures;        // profiles not applied completely
+    uint32_t last_switch_us;  // duration of the last switch
+    uint32_t max_switch_us;   // longest switch
+    bool time_valid;          // time of day set, schedules are active
+} radar_counter_profiles_stats_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t radar_counter_profiles_init(void);
+bool radar_counter_profiles_get(uint32_t index, radar_counter_profile_t *profile);
+cy_rslt_t radar_counter_profiles_save(uint32_t index, const char *name);
+cy_rslt_t radar_counter_profiles_schedule(uint32_t index, uint16_t start_minute);
+bool radar_counter_profiles_select(uint32_t index);
+void radar_counter_profiles_set_time(uint32_t minute_of_day);
+int32_t radar_counter_profiles_poll(cy_rslt_t *result);
+void radar_counter_profiles_get_stats(radar_counter_profiles_stats_t *stats);
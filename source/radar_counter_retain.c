@@ -0,0 +1,215 @@
+/*****************************************************************************
+** File name: radar_counter_retain.c
+**
+** Description: This file keeps the in/out counts and the parameter values in
+** RAM that is not initialized at startup, so that they survive a reset
+** and counting resumes with them after a warm restart.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stddef.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "radar_counter_retain.h"
+#include "radar_crc.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+#define RADAR_COUNTER_RETAIN_MAGIC (0x52434E54UL) // "RCNT"
+/* Changes whenever the layout of the retained data changes, so data of
+ * another firmware version is not taken over */
+#define RADAR_COUNTER_RETAIN_LAYOUT \
+    ((uint32_t)((sizeof(radar_counter_retain_t) << 16) | RADAR_COUNTER_PARAM_COUNT))
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t layout;
+    uint32_t count_in;
+    uint32_t count_out;
+    radar_counter_param_snapshot_t params;
+    uint32_t crc; // CRC-32 of all preceding fields
+} radar_counter_retain_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Not cleared by the startup code: content is undefined after power-up and
+ * kept across soft, watchdog and reset pin resets */
+CY_NOINIT static radar_counter_retain_t retained;
+static bool retained_valid = false; // retained holds a complete state
+static bool warm_restart = false;   // retained state was valid at startup
+
+/*******************************************************************************
+ * Function Name: radar_counter_retain_crc
+ ********************************************************************************
+ * Summary:
+ *   Computes the CRC of the retained data.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   CRC-32 of all fields in front of the CRC
+ *******************************************************************************/
+static uint32_t radar_counter_retain_crc(void)
+{
+    return radar_crc32(0, &retained, offsetof(radar_counter_retain_t, crc));
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_retain_init
+ ********************************************************************************
+ * Summary:
+ *   Checks whether the retained data survived a reset. Must be called once
+ *   at startup before any other function of this module.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true for a warm restart with valid retained data
+ *******************************************************************************/
+bool radar_counter_retain_init(void)
+{
+    warm_restart = (retained.magic == RADAR_COUNTER_RETAIN_MAGIC) &&
+                   (retained.layout == RADAR_COUNTER_RETAIN_LAYOUT) &&
+                   (retained.crc == radar_counter_retain_crc());
+    retained_valid = warm_restart;
+    if (!warm_restart)
+    {
+        retained.magic = 0U;
+    }
+    return warm_restart;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_retain_is_warm
+ ********************************************************************************
+ * Summary:
+ *   Tells whether the application started with valid retained data.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true for a warm restart
+ *******************************************************************************/
+bool radar_counter_retain_is_warm(void)
+{
+    return warm_restart;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_retain_get
+ ********************************************************************************
+ * Summary:
+ *   Reads the retained counts and parameter values.
+ *
+ * Parameters:
+ *   count_in: retained in count
+ *   count_out: retained out count
+ *   params: retained parameter values
+ *
+ * Return:
+ *   false if no valid data is retained, the outputs are unchanged then
+ *******************************************************************************/
+bool radar_counter_retain_get(uint32_t *count_in,
+                              uint32_t *count_out,
+                              radar_counter_param_snapshot_t *params)
+{
+    bool valid;
+
+    taskENTER_CRITICAL();
+    valid = retained_valid;
+    if (valid)
+    {
+        *count_in = retained.count_in;
+        *count_out = retained.count_out;
+        *params = retained.params;
+    }
+    taskEXIT_CRITICAL();
+    return valid;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_retain_store_counts
+ ********************************************************************************
+ * Summary:
+ *   Updates the retained counts. Counts are only retained once the
+ *   parameter values have been stored, so a warm restart always restores a
+ *   complete state.
+ *
+ * Parameters:
+ *   count_in: total in count
+ *   count_out: total out count
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_retain_store_counts(uint32_t count_in, uint32_t count_out)
+{
+    taskENTER_CRITICAL();
+    if (retained_valid)
+    {
+        retained.count_in = count_in;
+        retained.count_out = count_out;
+        retained.crc = radar_counter_retain_crc();
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_retain_store_params
+ ********************************************************************************
+ * Summary:
+ *   Updates the retained parameter values. The first call after a cold start
+ *   makes the retained data valid, with zero counts.
+ *
+ * Parameters:
+ *   params: parameter values
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_retain_store_params(const radar_counter_param_snapshot_t *params)
+{
+    taskENTER_CRITICAL();
+    if (!retained_valid)
+    {
+        retained.magic = RADAR_COUNTER_RETAIN_MAGIC;
+        retained.layout = RADAR_COUNTER_RETAIN_LAYOUT;
+        retained.count_in = 0U;
+        retained.count_out = 0U;
+        retained_valid = true;
+    }
+    retained.params = *params;
+    retained.crc = radar_counter_retain_crc();
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,43 @@
+/******************************************************************************
+** File name: radar_counter_retain.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_counter_retain.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file for local module */
+#include "radar_counter_params.h"
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+bool radar_counter_retain_init(void);
+bool radar_counter_retain_is_warm(void);
+bool radar_counter_retain_get(uint32_t *count_in,
+                              uint32_t *count_out,
+                              radar_counter_param_snapshot_t *params);
+void radar_counter_retain_store_counts(uint32_t count_in, uint32_t count_out);
+void radar_counter_retain_store_params(const radar_counter_param_snapshot_t *params);
@@ -31,20 +31,77 @@
 #include "cy_retarget_io.h"
 
 /* Header file for local task */
+#include "radar_boot_profile.h"
+#include "radar_clock.h"
+#include "radar_counter_adapt.h"
+#include "radar_counter_health.h"
+#include "radar_counter_params.h"
+#include "radar_counter_profiles.h"
+#include "radar_counter_retain.h"
 #include "radar_counter_task.h"
+#include "radar_counter_terminal_ui.h"
+#include "radar_counter_timing.h"
+#include "radar_event_bus.h"
+#include "radar_format.h"
+#include "radar_journal.h"
+#include "radar_lock.h"
 #include "radar_led_task.h"
+#include "radar_occupancy.h"
+#include "radar_ring_buffer.h"
+#include "radar_trace.h"
+#if defined(RADAR_COUNTER_TRAFFIC_GEN)
+#include "radar_counter_traffic_gen.h"
+#endif
 
 /*******************************************************************************
  * Macros
  ******************************************************************************/
 /* RADAR sensor SPI frequency */
 #define SPI_FREQUENCY (25000000UL)
+/* Size of the buffer for event messages held back while the terminal is in use */
+#define PENDING_OUTPUT_SIZE (1024U)
+/* Settling time of each step of the radar power cycle during recovery */
+#define RADAR_POWER_CYCLE_DELAY_MS (10U)
+
+#if defined(RADAR_COUNTER_TRAFFIC_GEN)
+/* Synthetic traffic generator stands in for the radar data processing */
+#define radar_counter_process(time_ms) radar_traffic_gen_process(time_ms)
+#else
+#define radar_counter_process(time_ms) mtb_radar_sensing_process(&sensing_context, time_ms)
+#endif
 
 /*******************************************************************************
  * Global Variables
  ******************************************************************************/
 mtb_radar_sensing_context_t sensing_context;
-static cy_mutex_t terminal_print_mutex;
+static radar_lock_t terminal_print_mutex;
+static volatile uint32_t print_drops = 0; // event messages lost because the buffer was full
+static volatile bool terminal_muted = false;
+static uint8_t pending_output_storage[PENDING_OUTPUT_SIZE];
+static radar_ring_buffer_t pending_output;
+
+/* Radar hardware */
+static cyhal_spi_t mSPI;
+static mtb_radar_sensing_hw_cfg_t hw_cfg = {.spi_cs = CYBSP_SPI_CS,
+                                            .reset = CYBSP_GPIO11,
+                                            .ldo_en = CYBSP_GPIO5,
+                                            .irq = CYBSP_GPIO10,
+                                            .spi = &mSPI};
+
+/* In/out counts of the library start from zero after a recovery. Counts
+ * reported by the application are the library counts on top of a base
+ * that accumulates the counts reached before each recovery. */
+static uint32_t count_base_in = 0;
+static uint32_t count_base_out = 0;
+static uint32_t last_count_in = 0;
+static uint32_t last_count_out = 0;
+
+/* Sequence number of the next counter event, gaps in records show lost events */
+static uint32_t event_sequence = 0;
+
+/* Event bus sink printing event messages */
+static radar_event_bus_sink_t console_sink;
+static uint8_t console_sink_storage[RADAR_EVENT_BUS_SINK_STORAGE_SIZE(8U)];
 
 /*******************************************************************************
  * Function Name: radar_counter_terminal_mutex_get
@@ -61,7 +118,10 @@ static cy_mutex_t terminal_print_mutex;
  *******************************************************************************/
 static cy_rslt_t radar_counter_terminal_mutex_get(cy_time_t timeout_ms)
 {
-    return (cy_rtos_get_mutex(&terminal_print_mutex, timeout_ms));
+    RADAR_TRACE(RADAR_TRACE_MUTEX_WAIT, timeout_ms);
+    cy_rslt_t result = radar_lock_get(&terminal_print_mutex, timeout_ms);
+    RADAR_TRACE(RADAR_TRACE_MUTEX_TAKE, (result == CY_RSLT_SUCCESS) ? 0U : 1U);
+    return result;
 }
 
 /*******************************************************************************
@@ -78,14 +138,210 @@ static cy_rslt_t radar_counter_terminal_mutex_get(cy_time_t timeout_ms)
  *******************************************************************************/
 static cy_rslt_t radar_counter_terminal_mutex_release(void)
 {
-    return (cy_rtos_set_mutex(&terminal_print_mutex));
+    RADAR_TRACE(RADAR_TRACE_MUTEX_GIVE, 0U);
+    return (radar_lock_release(&terminal_print_mutex));
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_flush_output
+ ********************************************************************************
+ * Summary:
+ *   Prints event messages that were buffered while the terminal was in use.
+ *   Must be called with the terminal mutex held.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_flush_output(void)
+{
+    uint8_t chunk[64];
+    uint32_t length;
+
+    while ((length = radar_ring_buffer_read(&pending_output, chunk, sizeof(chunk))) > 0U)
+    {
+        RADAR_TRACE(RADAR_TRACE_UART_TX_START, length);
+        printf("%.*s", (int)length, (const char *)chunk);
+        RADAR_TRACE(RADAR_TRACE_UART_TX_END, length);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_output_deferred
+ ********************************************************************************
+ * Summary:
+ *   Buffers an event message for the terminal UI task, which prints it
+ *   unless the terminal is muted. Never waits: a message is only lost if the
+ *   buffer is full. Called from the console sink and from the radar counter
+ *   task; the buffer is written in a critical section, since its ring buffer
+ *   only supports one producer.
+ *
+ * Parameters:
+ *   line: message to be printed
+ *   length: length of the message
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_output_deferred(const char *line, int length)
+{
+    if (length <= 0)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    bool buffered = radar_ring_buffer_write(&pending_output, (const uint8_t *)line, (uint32_t)length);
+    if (!buffered)
+    {
+        print_drops++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (buffered && !terminal_muted)
+    {
+        radar_counter_terminal_ui_notify();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_output
+ ********************************************************************************
+ * Summary:
+ *   Prints a message of the radar counter task, or buffers it if the
+ *   terminal is muted or in use. Buffered messages are printed ahead of the
+ *   next message or when the terminal is unmuted. With
+ *   RADAR_SCHED_DEFER_OUTPUT, messages are always buffered and printed by
+ *   the lower priority terminal UI task.
+ *
+ * Parameters:
+ *   line: message to be printed
+ *   length: length of the message
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_output(const char *line, int length)
+{
+    if (length <= 0)
+    {
+        return;
+    }
+
+    /* The terminal mutex is only tried, never waited for: the radar counter
+     * task runs at a higher priority than the tasks holding it. */
+    if (!RADAR_SCHED_DEFER_OUTPUT && !terminal_muted && (radar_counter_terminal_mutex_get(0) == CY_RSLT_SUCCESS))
+    {
+        radar_counter_flush_output();
+        RADAR_TRACE(RADAR_TRACE_UART_TX_START, length);
+        printf("%s", line);
+        RADAR_TRACE(RADAR_TRACE_UART_TX_END, length);
+        radar_counter_terminal_mutex_release();
+    }
+    else
+    {
+        radar_counter_output_deferred(line, length);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_task_format_event
+ ********************************************************************************
+ * Summary:
+ *   Formats the event message of an entrance counter event.
+ *
+ * Parameters:
+ *   event: counter event
+ *   line: destination, RADAR_COUNTER_LINE_MAXLENGTH bytes
+ *   size: size of the destination
+ *
+ * Return:
+ *   length of the message, 0 for events without message
+ *******************************************************************************/
+size_t radar_counter_task_format_event(const radar_counter_event_t *event, char *line, size_t size)
+{
+    const char *description;
+
+    switch (event->event)
+    {
+        // people walking in detected
+        case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
+            description = "Counter IN detected";
+            break;
+        // people walking out detected
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
+            description = "Counter OUT detected";
+            break;
+        // object detected in traffic zone, reminder for social distancing
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
+            description = "Counter occupied detected";
+            break;
+        // no more object detected in traffic zone
+        case MTB_RADAR_SENSING_EVENT_COUNTER_FREE:
+            description = "Counter free detected";
+            break;
+        default:
+            return 0U;
+    }
+
+    /* Format "<seconds>: <description>, IN: <count>, OUT: <count>" with integer arithmetic only */
+    size_t length = radar_format_timestamp(line, size, event->timestamp_ms);
+    length += radar_format_string(line + length, size - length, ": ");
+    length += radar_format_string(line + length, size - length, description);
+    length += radar_format_string(line + length, size - length, ", IN: ");
+    length += radar_format_uint(line + length, size - length, event->in_count);
+    length += radar_format_string(line + length, size - length, ", OUT: ");
+    length += radar_format_uint(line + length, size - length, event->out_count);
+    length += radar_format_string(line + length, size - length, "\r\n");
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_console_sink
+ ********************************************************************************
+ * Summary:
+ *   Event bus sink that formats entrance counter event messages. Once the
+ *   clock is synchronized with the gateway, the timestamps are printed in
+ *   the gateway timebase. The messages are always handed to the terminal UI
+ *   task, so that the UART does not hold up the other sinks of the event
+ *   bus task.
+ *
+ * Parameters:
+ *   event: counter event
+ *   arg: unused
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_console_sink(const radar_counter_event_t *event, void *arg)
+{
+    char line[RADAR_COUNTER_LINE_MAXLENGTH];
+    radar_counter_event_t output = *event;
+    uint64_t reference_us;
+
+    if (radar_clock_reference_us(event->time_us, &reference_us))
+    {
+        output.timestamp_ms = reference_us / 1000U;
+    }
+    size_t length = radar_counter_task_format_event(&output, line, sizeof(line));
+    if (length > 0U)
+    {
+        radar_counter_output_deferred(line, (int)length);
+    }
+#if defined(RADAR_COUNTER_TRAFFIC_GEN)
+    radar_traffic_gen_delivered(event->timestamp_ms);
+#endif
 }
 
 /*******************************************************************************
  * Function Name: radar_counter_callback
  ********************************************************************************
  * Summary:
- *   Callback function that handles entrance counter events
+ *   Callback function that handles entrance counter events: the occupancy
+ *   limit output is updated and the event is published on the event bus,
+ *   which delivers it to the LED, the console and any other sink.
  *
  * Parameters:
  *   context: context object of RadarSensing
@@ -101,54 +357,59 @@ static void radar_counter_callback(mtb_radar_sensing_context_t* context,
                                    mtb_radar_sensing_event_info_t *event_info,
                                    void *data)
 {
-    /* Update LED pattern */
-    radar_led_set_pattern(event);
+    radar_counter_event_t counter_event;
+    uint64_t event_us = radar_clock_us();
+
+    RADAR_TRACE(RADAR_TRACE_CALLBACK_ENTER, event);
 
-    if (radar_counter_terminal_mutex_get(0) == CY_RSLT_SUCCESS)
+    /* Latency from the start of the processing call */
+    (void)radar_counter_timing_event();
+
+    switch (event)
     {
-        /* Print out entrance counter event messages */
-        switch (event)
-        {
-            // people walking in detected
-            case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
-                printf("%.2f: Counter IN detected, IN: %d, OUT: %d\r\n",
-                       (float)event_info->timestamp / 1000,
-                       ((mtb_radar_sensing_counter_event_info_t *)event_info)->in_count,
-                       ((mtb_radar_sensing_counter_event_info_t *)event_info)->out_count);
-                break;
-            // people walking out detected
-            case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
-                printf("%.2f: Counter OUT detected, IN: %d, OUT: %d\r\n",
-                       (float)event_info->timestamp / 1000,
-                       ((mtb_radar_sensing_counter_event_info_t *)event_info)->in_count,
-                       ((mtb_radar_sensing_counter_event_info_t *)event_info)->out_count);
-                break;
-            // object detected in traffic zone, reminder for social distancing
-            case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
-                printf("%.2f: Counter occupied detected, IN: %d, OUT: %d\r\n",
-                       (float)event_info->timestamp / 1000,
-                       ((mtb_radar_sensing_counter_event_info_t *)event_info)->in_count,
-                       ((mtb_radar_sensing_counter_event_info_t *)event_info)->out_count);
-                break;
-            // no more object detected in traffic zone
-            case MTB_RADAR_SENSING_EVENT_COUNTER_FREE:
-                printf("%.2f: Counter free detected, IN: %d, OUT: %d\r\n",
-                       (float)event_info->timestamp / 1000,
-                       ((mtb_radar_sensing_counter_event_info_t *)event_info)->in_count,
-                       ((mtb_radar_sensing_counter_event_info_t *)event_info)->out_count);
-                break;
-            default:
-                break;
-        }
-        radar_counter_terminal_mutex_release();
+        case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
+        case MTB_RADAR_SENSING_EVENT_COUNTER_FREE:
+            break;
+        default:
+            RADAR_TRACE(RADAR_TRACE_CALLBACK_EXIT, event);
+            return;
     }
+
+    const mtb_radar_sensing_counter_event_info_t *counter_info = (mtb_radar_sensing_counter_event_info_t *)event_info;
+    /* The library may restart counting, e.g. after a profile switch */
+    if ((counter_info->in_count < last_count_in) || (counter_info->out_count < last_count_out))
+    {
+        count_base_in += last_count_in;
+        count_base_out += last_count_out;
+    }
+    last_count_in = counter_info->in_count;
+    last_count_out = counter_info->out_count;
+
+    counter_event.time_us = event_us;
+    counter_event.timestamp_ms = event_info->timestamp;
+    counter_event.in_count = count_base_in + last_count_in;
+    counter_event.out_count = count_base_out + last_count_out;
+    counter_event.sequence = event_sequence++;
+    counter_event.event = event;
+
+    /* Occupancy limit output first, it must not wait for any task */
+    radar_occupancy_update(counter_event.in_count, counter_event.out_count, event_us);
+    (void)radar_event_bus_publish(&counter_event);
+
+    /* Keep the counts across a reset */
+    radar_counter_retain_store_counts(counter_event.in_count, counter_event.out_count);
+    RADAR_TRACE(RADAR_TRACE_CALLBACK_EXIT, event);
 }
 
 /*******************************************************************************
  * Function Name: ifx_currenttime
  ********************************************************************************
  * Summary:
- *   Obtains system time in ms
+ *   Obtains system time in ms from the monotonic 64-bit clock, so that it
+ *   does not wrap with the 32-bit tick count and is not limited to tick
+ *   resolution.
  *
  * Parameters:
  *   none
@@ -158,44 +419,23 @@ static void radar_counter_callback(mtb_radar_sensing_context_t* context,
  *******************************************************************************/
 uint64_t ifx_currenttime()
 {
-    return (uint64_t)xTaskGetTickCount() * portTICK_PERIOD_MS;
+    return radar_clock_ms();
 }
 
 /*******************************************************************************
- * Function Name: radar_counter_task
+ * Function Name: radar_counter_hw_init
  ********************************************************************************
  * Summary:
- *   Initializes context object of RadarSensing for entrance counter,
- *   initializes radar device configuration, sets parameters for entrance
- *   counter, registers callback to handle counterevents and
- *   continuously processes data acquired from radar.
+ *   Initializes the GPIOs and the SPI interface connected to the radar.
  *
  * Parameters:
- *   arg: thread
+ *   none
  *
  * Return:
  *   none
  *******************************************************************************/
-void radar_counter_task(cy_thread_arg_t arg)
+static void radar_counter_hw_init(void)
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-
-    /* Initialize mutex for terminal print */
-    result = cy_rtos_init_mutex(&terminal_print_mutex);
-    if (result != CY_RSLT_SUCCESS)
-    {
-        CY_ASSERT(0);
-    }
-
-    /* Declare SPI object */
-    cyhal_spi_t mSPI;
-
-    mtb_radar_sensing_hw_cfg_t hw_cfg = {.spi_cs = CYBSP_SPI_CS,
-                                         .reset = CYBSP_GPIO11,
-                                         .ldo_en = CYBSP_GPIO5,
-                                         .irq = CYBSP_GPIO10,
-                                         .spi = &mSPI};
-
     /* Activate radar reset pin */
     cyhal_gpio_init(hw_cfg.reset, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, true);
 
@@ -226,59 +466,420 @@ void radar_counter_task(cy_thread_arg_t arg)
     {
         CY_ASSERT(0);
     }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_sensing_start
+ ********************************************************************************
+ * Summary:
+ *   Initializes the RadarSensing context object and the radar device,
+ *   registers the counter callback and enables the context object.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the first failing call, MTB_RADAR_SENSING_SUCCESS otherwise
+ *******************************************************************************/
+static cy_rslt_t radar_counter_sensing_start(void)
+{
+    cy_rslt_t result;
 
     /* Initialize RadarSensing context object for presence detection, */
     /* also initialize radar device configuration */
-    if (mtb_radar_sensing_init(&sensing_context, &hw_cfg, MTB_RADAR_SENSING_MASK_COUNTER_EVENTS) !=
-        MTB_RADAR_SENSING_SUCCESS)
+    result = mtb_radar_sensing_init(&sensing_context, &hw_cfg, MTB_RADAR_SENSING_MASK_COUNTER_EVENTS);
+    if (result != MTB_RADAR_SENSING_SUCCESS)
     {
-        printf("ifx_radar_sensing_init error - Radar Wingboard not connected?\n");
-        CY_ASSERT(0);
+        return result;
     }
 
     /* Register callback to handle counter events */
-    if (mtb_radar_sensing_register_callback(&sensing_context, radar_counter_callback, NULL) !=
-        MTB_RADAR_SENSING_SUCCESS)
+    result = mtb_radar_sensing_register_callback(&sensing_context, radar_counter_callback, NULL);
+    if (result != MTB_RADAR_SENSING_SUCCESS)
     {
-        CY_ASSERT(0);
+        return result;
     }
 
     /* Enable context object */
-    if (mtb_radar_sensing_enable(&sensing_context) != MTB_RADAR_SENSING_SUCCESS)
+    return mtb_radar_sensing_enable(&sensing_context);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_configure
+ ********************************************************************************
+ * Summary:
+ *   Configures the RadarSensing library once it is initialized. The first
+ *   time, the parameter snapshot is loaded with the library defaults and
+ *   either the values retained across a reset are restored or the
+ *   parameters of this application are set. Afterwards, the snapshot is
+ *   applied again.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the first failing call, MTB_RADAR_SENSING_SUCCESS otherwise
+ *******************************************************************************/
+static cy_rslt_t radar_counter_configure(void)
+{
+    static const struct
+    {
+        radar_counter_param_id_t id;
+        const char *value;
+    } defaults[] = {
+        {RADAR_COUNTER_PARAM_INSTALLATION,       "side"},
+        {RADAR_COUNTER_PARAM_ORIENTATION,        "landscape"},
+        {RADAR_COUNTER_PARAM_ENTRANCE_WIDTH,     "1.0"},
+        {RADAR_COUNTER_PARAM_TRAFFIC_LIGHT_ZONE, "0.2"},
+    };
+    static bool configured = false;
+    radar_counter_param_snapshot_t retained_params;
+    uint32_t retained_in;
+    uint32_t retained_out;
+    cy_rslt_t result = MTB_RADAR_SENSING_SUCCESS;
+
+    if (configured)
+    {
+        return radar_counter_params_apply();
+    }
+
+    /* Load the parameter snapshot with the library defaults */
+    radar_counter_params_load();
+
+    if (radar_counter_retain_get(&retained_in, &retained_out, &retained_params))
+    {
+        /* Warm restart, only the changed parameters are set */
+        result = radar_counter_params_restore(&retained_params);
+    }
+    else
+    {
+        /* Set parameters for entrance counter */
+        for (uint32_t i = 0; (i < (sizeof(defaults) / sizeof(defaults[0]))) && (result == MTB_RADAR_SENSING_SUCCESS);
+             i++)
+        {
+            result = radar_counter_params_set(&radar_counter_params[defaults[i].id], defaults[i].value);
+        }
+    }
+    configured = (result == MTB_RADAR_SENSING_SUCCESS);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_switch_profile
+ ********************************************************************************
+ * Summary:
+ *   Applies a profile requested by command or schedule and prints the
+ *   duration of the switch. Called between processing calls.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_switch_profile(void)
+{
+    radar_counter_profile_t profile;
+    radar_counter_profiles_stats_t stats;
+    char line[RADAR_COUNTER_LINE_MAXLENGTH];
+    cy_rslt_t result;
+
+    int32_t index = radar_counter_profiles_poll(&result);
+    if ((index < 0) || !radar_counter_profiles_get((uint32_t)index, &profile))
+    {
+        return;
+    }
+    radar_counter_profiles_get_stats(&stats);
+
+    size_t length = radar_format_string(line, sizeof(line), "Profile ");
+    length += radar_format_string(line + length, sizeof(line) - length, profile.name);
+    length += radar_format_string(line + length,
+                                  sizeof(line) - length,
+                                  (result == MTB_RADAR_SENSING_SUCCESS) ? " applied in " : " failed after ");
+    length += radar_format_uint(line + length, sizeof(line) - length, stats.last_switch_us);
+    length += radar_format_string(line + length, sizeof(line) - length, " us\r\n");
+    radar_counter_output(line, (int)length);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_recover
+ ********************************************************************************
+ * Summary:
+ *   Re-initializes the radar after a processing error or stall: the radar is
+ *   power cycled through its LDO and reset pins, the RadarSensing context is
+ *   initialized again and all parameters are restored from the snapshot.
+ *   In/out counts continue from their values before the fault. Attempts are
+ *   repeated until the radar is back. The parameter lock is only held while
+ *   the library is torn down and set up again, parameters changed in
+ *   between are applied with the snapshot.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_recover(void)
+{
+    bool recovered = false;
+
+    /* Counts restart from zero in the library, continue on top of them */
+    count_base_in += last_count_in;
+    count_base_out += last_count_out;
+    last_count_in = 0;
+    last_count_out = 0;
+
+    while (!recovered)
+    {
+        /* Parameter changes from the terminal UI are only stored while the
+         * library is down, the lock is not held over the delays */
+        radar_counter_params_lock();
+        radar_counter_params_set_online(false);
+        (void)mtb_radar_sensing_disable(&sensing_context);
+        mtb_radar_sensing_deinit(&sensing_context);
+        radar_counter_params_unlock();
+
+        /* Power cycle the radar */
+        cyhal_gpio_write(hw_cfg.reset, false);
+        cyhal_gpio_write(hw_cfg.ldo_en, false);
+        vTaskDelay(pdMS_TO_TICKS(RADAR_POWER_CYCLE_DELAY_MS));
+        cyhal_gpio_write(hw_cfg.ldo_en, true);
+        vTaskDelay(pdMS_TO_TICKS(RADAR_POWER_CYCLE_DELAY_MS));
+        cyhal_gpio_write(hw_cfg.reset, true);
+        vTaskDelay(pdMS_TO_TICKS(RADAR_POWER_CYCLE_DELAY_MS));
+
+        /* Re-apply the snapshot including the changes stored meanwhile */
+        radar_counter_params_lock();
+        cy_rslt_t result = radar_counter_sensing_start();
+        if (result == MTB_RADAR_SENSING_SUCCESS)
+        {
+            result = radar_counter_configure();
+        }
+        recovered = (result == MTB_RADAR_SENSING_SUCCESS);
+        radar_counter_params_set_online(recovered);
+        radar_counter_params_unlock();
+
+        radar_counter_health_recovery_attempt(recovered, ifx_currenttime());
+        if (!recovered)
+        {
+            vTaskDelay(pdMS_TO_TICKS(RADAR_COUNTER_HEALTH_RETRY_DELAY_MS));
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_wait_period
+ ********************************************************************************
+ * Summary:
+ *   Waits for the next processing period. In the fixed rate loop, periods
+ *   start at multiples of MTB_RADAR_SENSING_PROCESS_DELAY after wake_time
+ *   regardless of the processing time. A period that ends after the next
+ *   boundary is an overrun, handled by the RADAR_SCHED_CATCHUP policy.
+ *
+ * Parameters:
+ *   wake_time: start of the current period, advanced to the next one
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_wait_period(TickType_t *wake_time)
+{
+#if (RADAR_SCHED_LOOP == RADAR_SCHED_LOOP_FIXED_RATE)
+    const TickType_t period = MTB_RADAR_SENSING_PROCESS_DELAY;
+    TickType_t elapsed = xTaskGetTickCount() - *wake_time;
+
+    if (elapsed >= period)
+    {
+        /* Period boundaries passed while processing */
+        TickType_t missed = elapsed / period;
+        TickType_t skipped = missed;
+#if (RADAR_SCHED_CATCHUP == RADAR_SCHED_CATCHUP_BURST)
+        skipped = (missed > RADAR_SCHED_CATCHUP_MAX_BURST) ? (missed - RADAR_SCHED_CATCHUP_MAX_BURST) : 0U;
+#endif
+        *wake_time += skipped * period;
+        radar_counter_timing_overrun((uint32_t)skipped);
+    }
+    /* Returns at once for periods still to be caught up */
+    vTaskDelayUntil(wake_time, period);
+#else
+    (void)wake_time;
+    vTaskDelay(MTB_RADAR_SENSING_PROCESS_DELAY);
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_boot_report
+ ********************************************************************************
+ * Summary:
+ *   Prints the boot profile and the counts counting resumes with. The lines
+ *   go through radar_counter_output like event messages, so the radar
+ *   counter task never waits for the terminal.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_counter_boot_report(void)
+{
+    char line[RADAR_COUNTER_LINE_MAXLENGTH];
+    size_t length;
+
+    for (uint32_t i = 0U; (length = radar_boot_profile_format_line(i, line, sizeof(line))) > 0U; i++)
+    {
+        radar_counter_output(line, (int)length);
+    }
+
+    length = radar_format_string(line, sizeof(line), radar_counter_retain_is_warm() ? "Warm" : "Cold");
+    length += radar_format_string(line + length, sizeof(line) - length, " start, IN: ");
+    length += radar_format_uint(line + length, sizeof(line) - length, count_base_in);
+    length += radar_format_string(line + length, sizeof(line) - length, ", OUT: ");
+    length += radar_format_uint(line + length, sizeof(line) - length, count_base_out);
+    length += radar_format_string(line + length, sizeof(line) - length, "\r\n\r\n");
+    radar_counter_output(line, (int)length);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_task
+ ********************************************************************************
+ * Summary:
+ *   Initializes context object of RadarSensing for entrance counter,
+ *   initializes radar device configuration, sets parameters for entrance
+ *   counter, registers callback to handle counterevents and
+ *   continuously processes data acquired from radar. Processing errors and
+ *   stalls are recovered by re-initializing the radar. After a warm restart,
+ *   counts and parameters retained across the reset are restored.
+ *
+ * Parameters:
+ *   arg: thread
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_task(cy_thread_arg_t arg)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    bool boot_profile_printed = false;
+
+    /* Initialize mutex for terminal print */
+    result = radar_lock_init(&terminal_print_mutex, "terminal");
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+    radar_ring_buffer_init(&pending_output, pending_output_storage, sizeof(pending_output_storage));
+    result = radar_counter_params_init();
+    if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_SCHEDULER);
 
-    /* Set parameters for entrance counter */
-    if (mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_installation", "side") !=
-        MTB_RADAR_SENSING_SUCCESS)
+    /* Deliver counter events to the LEDs, the console and the sensitivity
+     * adaptation */
+    result = radar_led_subscribe();
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = radar_event_bus_subscribe(&console_sink,
+                                           "console",
+                                           RADAR_EVENT_BUS_FILTER_ALL,
+                                           radar_counter_console_sink,
+                                           NULL,
+                                           console_sink_storage,
+                                           sizeof(console_sink_storage));
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = radar_counter_adapt_init();
+    }
+    if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
-    if (mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_orientation", "landscape") !=
-        MTB_RADAR_SENSING_SUCCESS)
+
+    /* Counting continues from the retained counts after a warm restart */
+    radar_counter_param_snapshot_t retained_params;
+    (void)radar_counter_retain_get(&count_base_in, &count_base_out, &retained_params);
+    /* Sequence numbers continue after the newest journal record */
+    event_sequence = radar_journal_get_next_sequence();
+    result = radar_occupancy_init(count_base_in, count_base_out);
+    if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
-    if (mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_entrance_width", "1.0") !=
-        MTB_RADAR_SENSING_SUCCESS)
+
+    radar_counter_hw_init();
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_RADAR_HW);
+
+    result = radar_counter_sensing_start();
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_SENSING);
+    if (result == MTB_RADAR_SENSING_SUCCESS)
+    {
+        result = radar_counter_configure();
+    }
+    radar_boot_profile_mark(RADAR_BOOT_STAGE_PARAMS);
+    if (result != MTB_RADAR_SENSING_SUCCESS)
+    {
+        printf("ifx_radar_sensing_init error - Radar Wingboard not connected?\r\n");
+    }
+    if (radar_counter_profiles_init() != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
-    if (mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_traffic_light_zone", "0.2") !=
-        MTB_RADAR_SENSING_SUCCESS)
+
+#if defined(RADAR_COUNTER_TRAFFIC_GEN)
+    /* Route synthetic events to the same callback as radar events */
+    const radar_traffic_gen_config_t traffic_gen_config = RADAR_TRAFFIC_GEN_CONFIG_DEFAULT;
+    radar_traffic_gen_init(&traffic_gen_config);
+    radar_traffic_gen_register_callback(&sensing_context, radar_counter_callback, NULL);
+#endif
+
+    /* Supervise processing from here on */
+    if (radar_counter_health_init() != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
+    radar_counter_timing_init((uint32_t)((MTB_RADAR_SENSING_PROCESS_DELAY * 1000000ULL) / configTICK_RATE_HZ),
+                              RADAR_SCHED_PROCESS_DEADLINE_US);
+    TickType_t wake_time = xTaskGetTickCount();
+    if (result != MTB_RADAR_SENSING_SUCCESS)
+    {
+        radar_counter_health_process_error(result, ifx_currenttime());
+    }
+
     for (;;)
     {
+        if (radar_counter_health_recovery_requested())
+        {
+            radar_counter_recover();
+            radar_counter_timing_resync();
+            wake_time = xTaskGetTickCount();
+        }
+        radar_counter_switch_profile();
+
         /* Process data acquired from radar every 2ms */
-        if (mtb_radar_sensing_process(&sensing_context, ifx_currenttime()) != MTB_RADAR_SENSING_SUCCESS)
+        uint64_t time_ms = ifx_currenttime();
+        radar_counter_timing_process_start();
+        RADAR_TRACE(RADAR_TRACE_PROCESS_START, 0U);
+        result = radar_counter_process(time_ms);
+        RADAR_TRACE(RADAR_TRACE_PROCESS_END, (result == MTB_RADAR_SENSING_SUCCESS) ? 0U : 1U);
+        radar_counter_timing_process_end();
+        if (result == MTB_RADAR_SENSING_SUCCESS)
         {
-            printf("mtb_radar_sensing_process error\r\n");
-            CY_ASSERT(0);
+            radar_counter_health_process_ok(time_ms);
+            if (!boot_profile_printed)
+            {
+                radar_boot_profile_mark(RADAR_BOOT_STAGE_FIRST_PROCESS);
+                radar_counter_boot_report();
+                boot_profile_printed = true;
+            }
         }
-        vTaskDelay(MTB_RADAR_SENSING_PROCESS_DELAY);
+        else
+        {
+            radar_counter_health_process_error(result, time_ms);
+        }
+        radar_counter_wait_period(&wake_time);
     }
 }
 
@@ -286,23 +887,108 @@ void radar_counter_task(cy_thread_arg_t arg)
  * Function Name: radar_counter_task_set_mute
  ********************************************************************************
  * Summary:
- *   Temporarily disables console output.
+ *   Temporarily holds back event messages, e.g. while the user is editing a
+ *   setting. Messages are buffered while muted and printed when unmuted.
+ *   Returns the previous state, so that output printed within a muted
+ *   interaction restores it instead of unmuting:
+ *     bool muted = radar_counter_task_set_mute(true);
+ *     ...
+ *     (void)radar_counter_task_set_mute(muted);
  *
  * Parameters:
- *   mute: true if muted. Care should be taken to match every
- *   radar_counter_task_set_mute(true) call with a call to
- *   radar_counter_task_set_mute(false). Failure to do so is likely to result
- *   in unpredictable behavior.
+ *   mute: true if muted
+ *
+ * Return:
+ *   true if muted before the call
+ *******************************************************************************/
+bool radar_counter_task_set_mute(bool mute)
+{
+    bool muted = terminal_muted;
+
+    terminal_muted = mute;
+    if (!mute)
+    {
+        radar_counter_task_flush_output();
+    }
+    return muted;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_task_lock_terminal
+ ********************************************************************************
+ * Summary:
+ *   Reserves the terminal for the calling task, e.g. while the terminal UI
+ *   prints. Messages of the radar counter task are buffered meanwhile
+ *   instead of being printed into the middle of that output. The lock is
+ *   recursive.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_task_lock_terminal(void)
+{
+    (void)radar_counter_terminal_mutex_get(CY_RTOS_NEVER_TIMEOUT);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_task_unlock_terminal
+ ********************************************************************************
+ * Summary:
+ *   Releases the terminal reserved by radar_counter_task_lock_terminal.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_task_unlock_terminal(void)
+{
+    (void)radar_counter_terminal_mutex_release();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_task_flush_output
+ ********************************************************************************
+ * Summary:
+ *   Prints buffered event messages unless the terminal is muted.
+ *
+ * Parameters:
+ *   none
  *
  * Return:
  *   none
  *******************************************************************************/
-void radar_counter_task_set_mute(bool mute)
+void radar_counter_task_flush_output(void)
 {
-    if (mute)
+    if (terminal_muted || (radar_ring_buffer_count(&pending_output) == 0U))
     {
-        radar_counter_terminal_mutex_get(CY_RTOS_NEVER_TIMEOUT);
         return;
     }
-    radar_counter_terminal_mutex_release();
+    if (radar_counter_terminal_mutex_get(CY_RTOS_NEVER_TIMEOUT) == CY_RSLT_SUCCESS)
+    {
+        radar_counter_flush_output();
+        radar_counter_terminal_mutex_release();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_task_get_print_drops
+ ********************************************************************************
+ * Summary:
+ *   Returns the number of event messages that were lost because the buffer
+ *   for held back messages was full.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of lost event messages
+ *******************************************************************************/
+uint32_t radar_counter_task_get_print_drops(void)
+{
+    return print_drops;
 }
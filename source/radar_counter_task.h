@@ -33,6 +33,10 @@
 /* Header file for library */
 #include "mtb_radar_sensing.h"
 
+/* Header file for local module */
+#include "radar_event_bus.h"
+#include "radar_sched_profile.h"
+
 /*******************************************************************************
  * Macros
  *******************************************************************************/
@@ -41,7 +45,9 @@
 /* Radar counter task stack */
 #define RADAR_COUNTER_TASK_STACK_SIZE (1024 * 4)
 /* Radar counter task priority */
-#define RADAR_COUNTER_TASK_PRIORITY (CY_RTOS_PRIORITY_NORMAL)
+#define RADAR_COUNTER_TASK_PRIORITY (RADAR_SCHED_PRIORITY_PROCESSING)
+/* Maximum length of an event message */
+#define RADAR_COUNTER_LINE_MAXLENGTH (80)
 
 /*******************************************************************************
  * Global Variables
@@ -52,4 +58,10 @@ extern mtb_radar_sensing_context_t sensing_context;
  * Functions
  *******************************************************************************/
 void radar_counter_task(cy_thread_arg_t arg);
-void radar_counter_task_set_mute(bool mute);
+bool radar_counter_task_set_mute(bool mute);
+void radar_counter_task_flush_output(void);
+void radar_counter_task_lock_terminal(void);
+void radar_counter_task_unlock_terminal(void);
+uint32_t radar_counter_task_get_print_drops(void);
+size_t radar_counter_task_format_event(const radar_counter_event_t *event, char *line, size_t size);
+uint64_t ifx_currenttime(void);
@@ -24,7 +24,8 @@
 */
 
 /* Header file from system */
-#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* Header file includes */
 #include "cy_retarget_io.h"
@@ -32,21 +33,76 @@
 #include "cyhal.h"
 
 /* Header file for local task */
+#include "radar_bench.h"
+#include "radar_clock.h"
+#include "radar_counter_adapt.h"
+#include "radar_counter_health.h"
+#include "radar_counter_params.h"
+#include "radar_counter_profiles.h"
 #include "radar_counter_task.h"
 #include "radar_counter_terminal_ui.h"
+#include "radar_counter_timing.h"
+#include "radar_event_bus.h"
+#include "radar_format.h"
+#include "radar_history.h"
+#include "radar_journal.h"
+#include "radar_line_edit.h"
+#include "radar_lock.h"
+#include "radar_occupancy.h"
+#include "radar_ring_buffer.h"
+#include "radar_trace.h"
 
 /*******************************************************************************
  * Constants
  *******************************************************************************/
-#define IFX_RADAR_SENSING_VALUE_MAXLENGTH 256
+#define IFX_RADAR_SENSING_VALUE_MAXLENGTH 32
+/* Size of the receive buffer, must be a power of two */
+#define TERMINAL_UI_RX_BUFFER_SIZE (64U)
+/* Maximum length of a value entered by the user, including terminator */
+#define TERMINAL_UI_LINE_MAXLENGTH (32)
+/* Size of the buffer collecting echo characters */
+#define TERMINAL_UI_ECHO_SIZE (32U)
+/* Transmission time of one UART character (start, 8 data and stop bit) */
+#define TERMINAL_UI_CHAR_US (10000000U / CY_RETARGET_IO_BAUDRATE)
+
+/* States of the terminal UI */
+typedef enum
+{
+    TERMINAL_UI_STATE_IDLE,    // waiting for a command key
+    TERMINAL_UI_STATE_SELECT,  // waiting for the selection of a choice
+    TERMINAL_UI_STATE_READLINE // reading a value
+} terminal_ui_state_t;
+
+/* Context of the setting being edited */
+typedef struct
+{
+    terminal_ui_state_t state;
+    const radar_counter_param_t *param;
+    void (*complete)(void); // called when the entered line is complete
+    char line[TERMINAL_UI_LINE_MAXLENGTH];
+    radar_line_edit_t edit;
+    uint64_t line_end_us; // radar_clock_us() when the line end was received
+} terminal_ui_context_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static terminal_ui_context_t ui = {.state = TERMINAL_UI_STATE_IDLE};
+static uint8_t ui_rx_storage[TERMINAL_UI_RX_BUFFER_SIZE];
+static radar_ring_buffer_t ui_rx_buffer;
+static cy_semaphore_t ui_rx_semaphore;         // signaled when keys were received
+static volatile uint32_t ui_rx_overruns = 0;   // keys lost because the receive buffer was full
+static volatile uint64_t ui_rx_line_end_us = 0; // radar_clock_us() when the last line end was received
+static uint8_t ui_echo[TERMINAL_UI_ECHO_SIZE]; // echo characters collected for one write
+static uint32_t ui_echo_length = 0;
 
 /*******************************************************************************
  * Function Name: terminal_ui_menu
  ********************************************************************************
  * Summary:
  *   This function prints the available parameters configurable for entrance
- *   counter application. The existing values of the parameters are also
- *   displayed with their units (if any).
+ *   counter application. The existing values of the parameters are taken
+ *   from the parameter snapshot and displayed with their units (if any).
  *
  * Parameters:
  *   none
@@ -57,51 +113,20 @@
 static void terminal_ui_menu(void)
 {
     char value[IFX_RADAR_SENSING_VALUE_MAXLENGTH];
-    radar_counter_task_set_mute(true);
+    radar_counter_param_snapshot_t snapshot;
+
+    radar_counter_params_get_snapshot(&snapshot);
+    bool muted = radar_counter_task_set_mute(true);
     /* Print main menu */
     printf("Select a setting to configure\r\n");
-    mtb_radar_sensing_get_parameter(&sensing_context,
-                                    "radar_counter_installation",
-                                    value,
-                                    IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-    printf("'i': installation (%s)\r\n", value);
-    mtb_radar_sensing_get_parameter(&sensing_context,
-                                    "radar_counter_orientation",
-                                    value,
-                                    IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-    printf("'o': orientation (%s)\r\n", value);
-    mtb_radar_sensing_get_parameter(&sensing_context,
-                                    "radar_counter_ceiling_height",
-                                    value,
-                                    IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-    printf("'h': ceiling height (%s)\r\n", value);
-    mtb_radar_sensing_get_parameter(&sensing_context,
-                                    "radar_counter_entrance_width",
-                                    value,
-                                    IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-    printf("'w': entrance width (%s)\r\n", value);
-    mtb_radar_sensing_get_parameter(&sensing_context,
-                                    "radar_counter_sensitivity",
-                                    value,
-                                    IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-    printf("'s': sensitivity (%s)\r\n", value);
-    mtb_radar_sensing_get_parameter(&sensing_context,
-                                    "radar_counter_traffic_light_zone",
-                                    value,
-                                    IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-    printf("'t': traffic light zone (%s)\r\n", value);
-    mtb_radar_sensing_get_parameter(&sensing_context,
-                                    "radar_counter_reverse",
-                                    value,
-                                    IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-    printf("'r': reverse (%s)\n", value);
-    mtb_radar_sensing_get_parameter(&sensing_context,
-                                    "radar_counter_min_person_height",
-                                    value,
-                                    IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-    printf("'m': min person height (%s)\n", value);
-    printf("\n");
-    radar_counter_task_set_mute(false);
+    for (int i = 0; i < RADAR_COUNTER_PARAM_COUNT; i++)
+    {
+        const radar_counter_param_t *param = &radar_counter_params[i];
+        (void)radar_counter_params_format(param, snapshot.value[i], value, sizeof(value));
+        printf("'%c': %s (%s%s)\r\n", param->key, param->label, value, param->unit);
+    }
+    printf("\r\n");
+    (void)radar_counter_task_set_mute(muted);
 }
 
 /*******************************************************************************
@@ -119,98 +144,173 @@ static void terminal_ui_menu(void)
  *******************************************************************************/
 static void terminal_ui_info(void)
 {
-    printf("Press '?' to list all radar counter settings\r\n");
+    printf("Press '?' to list all radar counter settings, 'd' for diagnostics, 'j' for the event journal,\r\n"
+           "'x' to export the event history, 'T' to dump the trace, 'p' for profiles,\r\n"
+           "'a' for the sensitivity adaptation, 'y' for the time sync, 'l' for the occupancy limit,\r\n"
+           "'b' for the benchmark\r\n");
 }
 
 /*******************************************************************************
- * Function Name: terminal_ui_readline
+ * Function Name: terminal_ui_lock_histogram
  ********************************************************************************
  * Summary:
- *   This function reads values entered by a user and prints it.
+ *   This function prints a wait or hold time histogram of a lock on one line.
  *
  * Parameters:
- *   uart_ptr: UART object
- *   line: value to be read
- *   maxlength: maximum number of characters to be read
+ *   label: histogram name
+ *   histogram: counts of the bins
  *
  * Return:
  *   none
  *******************************************************************************/
-static void terminal_ui_readline(void *obj_ptr, char *line, int maxlength)
+static void terminal_ui_lock_histogram(const char *label, const uint32_t *histogram)
 {
-    radar_counter_task_set_mute(true);
-
-    if (maxlength <= 0)
-    {
-        return;
-    }
-
-    int i = 0;
-    uint8_t rx_value = 0;
-    while ((rx_value != '\r') && (--maxlength > 0))
+    printf("    %s:", label);
+    for (uint32_t i = 0; i < RADAR_LOCK_BINS; i++)
     {
-        cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_value, 0);
-        cyhal_uart_putc(&cy_retarget_io_uart_obj, rx_value);
-        if (isspace(rx_value))
+        if (i < (RADAR_LOCK_BINS - 1U))
         {
-            continue;
+            printf(" <%lu us %lu,", (unsigned long)radar_lock_bin_limits_us[i], (unsigned long)histogram[i]);
+        }
+        else
+        {
+            printf(" more %lu\r\n", (unsigned long)histogram[i]);
         }
-        line[i++] = rx_value;
     }
-    cyhal_uart_putc(&cy_retarget_io_uart_obj, '\n');
-    line[i] = '\0';
-
-    radar_counter_task_set_mute(false);
 }
 
 /*******************************************************************************
- * Function Name: terminal_ui_getselection
+ * Function Name: terminal_ui_diagnostics
  ********************************************************************************
  * Summary:
- *   This function prints choices for certain entrance counter parameters
- *   and obtains user selection for those choices.
+ *   This function prints the health statistics of the radar processing and
+ *   the timing of the processing loop.
  *
  * Parameters:
- *   obj_ptr: UART object
- *   choices: available choices for parameters that is to be printed
- *   num_choices: maximum number of choices
+ *   none
  *
  * Return:
- *   Character associated with user selection
+ *   none
  *******************************************************************************/
-static char *terminal_ui_getselection(void *obj_ptr, char *choices[], int num_choices)
+static void terminal_ui_diagnostics(void)
 {
-    radar_counter_task_set_mute(true);
+    radar_counter_health_stats_t stats;
+    radar_counter_timing_stats_t timing;
+    radar_occupancy_stats_t room;
+    radar_journal_stats_t journal;
 
-    int i;
-    for (i = 0; i < num_choices; i++)
-    {
-        printf("\t'%c': %s\r\n", '1' + i, choices[i]);
-    }
+    radar_counter_health_get_stats(&stats);
+    bool muted = radar_counter_task_set_mute(true);
+    printf("Processing errors: %lu (last 0x%08lx)\r\n",
+           (unsigned long)stats.process_errors,
+           (unsigned long)stats.last_error);
+    printf("Stalls: %lu\r\n", (unsigned long)stats.stalls);
+    printf("Recoveries: %lu, failed attempts: %lu\r\n",
+           (unsigned long)stats.recoveries,
+           (unsigned long)stats.recovery_failures);
+    printf("Time to recover: last %lu ms, max %lu ms\r\n",
+           (unsigned long)stats.last_recovery_ms,
+           (unsigned long)stats.max_recovery_ms);
 
-    uint8_t rx_value;
-    do
+    radar_counter_timing_get_stats(&timing);
+    printf("Processing periods: %lu, min %lu us, max %lu us\r\n",
+           (unsigned long)timing.periods,
+           (unsigned long)((timing.periods > 0U) ? timing.period_min_us : 0U),
+           (unsigned long)timing.period_max_us);
+    printf("Processing call: max %lu us, deadline misses %lu\r\n",
+           (unsigned long)timing.process_max_us,
+           (unsigned long)timing.deadline_misses);
+    printf("Event callback latency: max %lu us\r\n", (unsigned long)timing.event_latency_max_us);
+    printf("Overruns: %lu, skipped periods: %lu\r\n",
+           (unsigned long)timing.overruns,
+           (unsigned long)timing.skipped_periods);
+    printf("Period jitter histogram:\r\n");
+    for (uint32_t i = 0; i < RADAR_COUNTER_TIMING_BINS; i++)
     {
-        if (cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_value, 0) != CY_RSLT_SUCCESS)
+        if (i < (RADAR_COUNTER_TIMING_BINS - 1U))
         {
-            radar_counter_task_set_mute(false);
-            return NULL;
+            printf("  < %5lu us: %lu\r\n",
+                   (unsigned long)radar_counter_timing_bin_limits_us[i],
+                   (unsigned long)timing.histogram[i]);
         }
-    } 
-    while (isspace(rx_value));
+        else
+        {
+            printf("  >=%5lu us: %lu\r\n",
+                   (unsigned long)radar_counter_timing_bin_limits_us[i - 1U],
+                   (unsigned long)timing.histogram[i]);
+        }
+    }
 
-    i = rx_value - '1';
-    if ((i < 0) || (i >= num_choices))
+    radar_occupancy_get_stats(&room);
+    printf("Occupancy: %lu of %lu, %s, output switched %lu times\r\n",
+           (unsigned long)room.occupancy,
+           (unsigned long)room.limit,
+           room.full ? "full" : "free",
+           (unsigned long)room.switches);
+    printf("Callback to output edge: last %lu us, max %lu us\r\n",
+           (unsigned long)room.latency_last_us,
+           (unsigned long)room.latency_max_us);
+    printf("Event bus: %lu dropped\r\n", (unsigned long)radar_event_bus_get_drops());
+    for (uint32_t i = 0; i < radar_event_bus_get_sink_count(); i++)
     {
-        printf("not updated\r\n");
-        radar_counter_task_set_mute(false);
-        return NULL;
+        radar_event_bus_sink_stats_t sink_stats;
+        const char *name = radar_event_bus_get_sink_stats(i, &sink_stats);
+        printf("  %-8s delivered %lu, dropped %lu, max queued %lu\r\n",
+               name,
+               (unsigned long)sink_stats.delivered,
+               (unsigned long)sink_stats.dropped,
+               (unsigned long)sink_stats.max_depth);
     }
-    printf("selected '%c': %s\r\n", rx_value, choices[i]);
+    printf("Event messages lost: %lu\r\n", (unsigned long)radar_counter_task_get_print_drops());
+    printf("Locks:\r\n");
+    for (uint32_t i = 0; i < radar_lock_get_count(); i++)
+    {
+        radar_lock_stats_t lock_stats;
+        const char *name = radar_lock_get_stats(i, &lock_stats);
+        printf("  %-8s attempts %lu, failures %lu (last held by %s), max wait %lu us, max hold %lu us\r\n",
+               name,
+               (unsigned long)lock_stats.attempts,
+               (unsigned long)lock_stats.failures,
+               (lock_stats.failure_owner != NULL) ? lock_stats.failure_owner : "-",
+               (unsigned long)lock_stats.wait_max_us,
+               (unsigned long)lock_stats.hold_max_us);
+        terminal_ui_lock_histogram("wait", lock_stats.wait_histogram);
+        terminal_ui_lock_histogram("hold", lock_stats.hold_histogram);
+    }
+    radar_journal_get_stats(&journal);
+    printf("Journal: %lu records in %lu pages, sequence %lu to %lu, %lu pending\r\n",
+           (unsigned long)journal.records,
+           (unsigned long)journal.pages,
+           (unsigned long)journal.first_sequence,
+           (unsigned long)(journal.next_sequence - 1U),
+           (unsigned long)journal.pending);
+    printf("Journal writes: %lu pages, %lu errors, %lu records dropped, scan %lu us\r\n",
+           (unsigned long)journal.page_writes,
+           (unsigned long)journal.write_errors,
+           (unsigned long)journal.dropped,
+           (unsigned long)journal.scan_us);
+    printf("\r\n");
+    (void)radar_counter_task_set_mute(muted);
+}
 
-    radar_counter_task_set_mute(false);
-    
-    return choices[i];
+/*******************************************************************************
+ * Function Name: terminal_ui_start_readline
+ ********************************************************************************
+ * Summary:
+ *   This function starts reading a line, which is passed to a completion
+ *   function once enter is pressed.
+ *
+ * Parameters:
+ *   complete: function executing the entered line in ui.line
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_start_readline(void (*complete)(void))
+{
+    ui.complete = complete;
+    radar_line_edit_init(&ui.edit, ui.line, sizeof(ui.line));
+    ui.state = TERMINAL_UI_STATE_READLINE;
 }
 
 /*******************************************************************************
@@ -239,116 +339,957 @@ static void terminal_ui_print_result(cy_rslt_t result)
 }
 
 /*******************************************************************************
- * Function Name: radar_counter_terminal_ui
+ * Function Name: terminal_ui_param_complete
  ********************************************************************************
  * Summary:
- *   Continuously checks if a key has been pressed to configure entrance
- *   counter parameters. Displays a status message according to the user
- *   input/selection.
+ *   This function configures the value entered for a parameter.
  *
  * Parameters:
- *   arg: thread
+ *   none
  *
  * Return:
  *   none
  *******************************************************************************/
-void radar_counter_terminal_ui(cy_thread_arg_t arg)
+static void terminal_ui_param_complete(void)
 {
-    char *selected_option = "";
-    char value[IFX_RADAR_SENSING_VALUE_MAXLENGTH];
-    uint8_t rx_value = 0;
+    cy_rslt_t result = radar_counter_params_set(ui.param, ui.line);
+    if (result == RADAR_COUNTER_PARAMS_RSLT_ERR_INVALID_VALUE)
+    {
+        printf("out of range [%s-%s]%s, not updated\r\n", ui.param->min_text, ui.param->max_text, ui.param->unit);
+    }
+    else
+    {
+        terminal_ui_print_result(result);
+    }
+}
 
-    terminal_ui_menu();
+/*******************************************************************************
+ * Function Name: terminal_ui_journal_record
+ ********************************************************************************
+ * Summary:
+ *   This function prints a journal record as the hexadecimal bytes of its
+ *   binary encoding, so that it can be decoded and verified on a host.
+ *
+ * Parameters:
+ *   record: record read from the journal
+ *   arg: unused
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_journal_record(const radar_event_record_t *record, void *arg)
+{
+    uint8_t buffer[RADAR_EVENT_RECORD_SIZE];
+    char line[3U + (2U * RADAR_EVENT_RECORD_SIZE) + 3U] = "J ";
+    static const char hex[] = "0123456789abcdef";
+    size_t length = 2U;
+
+    (void)radar_event_record_encode(record, buffer, sizeof(buffer));
+    for (uint32_t i = 0; i < RADAR_EVENT_RECORD_SIZE; i++)
+    {
+        line[length++] = hex[buffer[i] >> 4];
+        line[length++] = hex[buffer[i] & 0x0FU];
+    }
+    line[length++] = '\r';
+    line[length++] = '\n';
+    line[length] = '\0';
+    printf("%s", line);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_journal_complete
+ ********************************************************************************
+ * Summary:
+ *   This function prints the journal records starting at the entered
+ *   sequence number.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_journal_complete(void)
+{
+    char *end;
+    unsigned long since = strtoul(ui.line, &end, 10);
+
+    if ((ui.edit.length == 0U) || (*end != '\0'))
+    {
+        printf("invalid sequence number\r\n");
+        return;
+    }
+    uint32_t count = radar_journal_read((uint32_t)since, terminal_ui_journal_record, NULL);
+    printf("%lu records\r\n", (unsigned long)count);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_journal
+ ********************************************************************************
+ * Summary:
+ *   This function asks for the first sequence number of the journal records
+ *   to be printed.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_journal(void)
+{
+    radar_journal_stats_t journal;
+
+    radar_journal_get_stats(&journal);
+    printf("Enter first sequence number [%lu-%lu], press enter\r\n",
+           (unsigned long)journal.first_sequence,
+           (unsigned long)(journal.next_sequence - 1U));
+    terminal_ui_start_readline(terminal_ui_journal_complete);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_history_complete
+ ********************************************************************************
+ * Summary:
+ *   This function exports the event history from the entered sequence
+ *   number on and compares its size with the event messages of the console.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_history_complete(void)
+{
+    radar_history_stats_t stats;
+    char *end;
+    unsigned long since = strtoul(ui.line, &end, 10);
+
+    if ((ui.edit.length == 0U) || (*end != '\0'))
+    {
+        printf("invalid sequence number\r\n");
+        return;
+    }
+    radar_history_export((uint32_t)since, &stats);
+    if (stats.bytes > 0U)
+    {
+        uint32_t ratio = (uint32_t)(((uint64_t)stats.text_bytes * 10U) / stats.bytes);
+        printf("History: %lu records in %lu chunks, %lu bytes, %lu bytes as text (%lu.%lux)\r\n",
+               (unsigned long)stats.records,
+               (unsigned long)stats.chunks,
+               (unsigned long)stats.bytes,
+               (unsigned long)stats.text_bytes,
+               (unsigned long)(ratio / 10U),
+               (unsigned long)(ratio % 10U));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_history
+ ********************************************************************************
+ * Summary:
+ *   This function asks for the first sequence number of the event history
+ *   to be exported.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_history(void)
+{
+    printf("Enter first sequence number to export, press enter\r\n");
+    terminal_ui_start_readline(terminal_ui_history_complete);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_parse_time
+ ********************************************************************************
+ * Summary:
+ *   This function parses a time of day "HH:MM".
+ *
+ * Parameters:
+ *   text: time
+ *   minute: minute of the day
+ *
+ * Return:
+ *   false if the text is not a valid time
+ *******************************************************************************/
+static bool terminal_ui_parse_time(const char *text, uint16_t *minute)
+{
+    char *end;
+    unsigned long hours = strtoul(text, &end, 10);
+
+    if ((end == text) || (*end != ':') || (hours > 23U))
+    {
+        return false;
+    }
+    text = end + 1;
+    unsigned long minutes = strtoul(text, &end, 10);
+    if ((end == text) || (*end != '\0') || (minutes > 59U))
+    {
+        return false;
+    }
+    *minute = (uint16_t)((hours * 60U) + minutes);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_profiles_complete
+ ********************************************************************************
+ * Summary:
+ *   This function executes the entered profile command:
+ *     "<n>"              apply profile n
+ *     "s<n>[=<name>]"    save the current settings as profile n
+ *     "<n>@HH:MM"        apply profile n every day at HH:MM, "<n>@-" never
+ *     "time=HH:MM"       set the time of day used by the schedules
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_profiles_complete(void)
+{
+    const char *text = ui.line;
+    char *end;
+    uint16_t minute;
+
+    if (strncmp(text, "time=", 5U) == 0)
+    {
+        if (terminal_ui_parse_time(text + 5, &minute))
+        {
+            radar_counter_profiles_set_time(minute);
+            printf("OK\r\n");
+        }
+        else
+        {
+            printf("invalid time\r\n");
+        }
+        return;
+    }
+
+    bool save = (text[0] == 's');
+    unsigned long number = strtoul(save ? (text + 1) : text, &end, 10);
+    if ((end == (save ? (text + 1) : text)) || (number < 1U) || (number > RADAR_COUNTER_PROFILES_MAX))
+    {
+        printf("invalid profile\r\n");
+        return;
+    }
+    uint32_t index = (uint32_t)number - 1U;
+
+    if (save && ((*end == '\0') || (*end == '=')))
+    {
+        cy_rslt_t result = radar_counter_profiles_save(index, (*end == '=') ? (end + 1) : NULL);
+        printf((result == CY_RSLT_SUCCESS) ? "OK\r\n" : "ERROR\r\n");
+    }
+    else if (!save && (*end == '@'))
+    {
+        if (strcmp(end + 1, "-") == 0)
+        {
+            minute = RADAR_COUNTER_PROFILES_UNSCHEDULED;
+        }
+        else if (!terminal_ui_parse_time(end + 1, &minute))
+        {
+            printf("invalid time\r\n");
+            return;
+        }
+        cy_rslt_t result = radar_counter_profiles_schedule(index, minute);
+        printf((result == CY_RSLT_SUCCESS) ? "OK\r\n" : "ERROR\r\n");
+    }
+    else if (!save && (*end == '\0'))
+    {
+        printf(radar_counter_profiles_select(index) ? "OK\r\n" : "unused profile\r\n");
+    }
+    else
+    {
+        printf("invalid command\r\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_profiles
+ ********************************************************************************
+ * Summary:
+ *   This function lists the configuration profiles and asks for a profile
+ *   command.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_profiles(void)
+{
+    radar_counter_profile_t profile;
+    radar_counter_profiles_stats_t stats;
 
-    /* Check if a key was pressed */
-    while (cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_value, 0) == CY_RSLT_SUCCESS)
+    radar_counter_profiles_get_stats(&stats);
+    printf("Profiles (%lu switches, last %lu us, max %lu us, failed %lu%s):\r\n",
+           (unsigned long)stats.switches,
+           (unsigned long)stats.last_switch_us,
+           (unsigned long)stats.max_switch_us,
+           (unsigned long)stats.failures,
+           stats.time_valid ? "" : ", time not set");
+    for (uint32_t i = 0; i < RADAR_COUNTER_PROFILES_MAX; i++)
     {
-        switch ((char)rx_value)
+        if (!radar_counter_profiles_get(i, &profile))
+        {
+            printf("  %lu: unused\r\n", (unsigned long)(i + 1U));
+        }
+        else if (profile.start_minute == RADAR_COUNTER_PROFILES_UNSCHEDULED)
+        {
+            printf("  %lu: %s%s\r\n", (unsigned long)(i + 1U), profile.name, (stats.active == (int32_t)i) ? " *" : "");
+        }
+        else
         {
-            // menu
-            case '?':
-                terminal_ui_menu();
-                break;
-            case 'i':
-            {
-                printf("Select counter installation:\r\n");
-                char *counter_choices[] = {"ceiling", "side"};
-                selected_option = terminal_ui_getselection(&cy_retarget_io_uart_obj,
-                                                        counter_choices,
-                                                        sizeof(counter_choices) / sizeof(char *));
-                if (selected_option != NULL)
-                {
-                    terminal_ui_print_result(mtb_radar_sensing_set_parameter(&sensing_context,
-                                                                            "radar_counter_installation",
-                                                                            selected_option));
-                }
-                break;
-            }
-            case 'o':
-            {
-                printf("Select counter orientation:\r\n");
-                char *orientation_choices[] = {"landscape", "portrait"};
-                selected_option = terminal_ui_getselection(&cy_retarget_io_uart_obj,
-                                                        orientation_choices,
-                                                        sizeof(orientation_choices) / sizeof(char *));
-                if (selected_option != NULL)
-                {
-                    terminal_ui_print_result(mtb_radar_sensing_set_parameter(&sensing_context,
-                                                                            "radar_counter_orientation",
-                                                                            selected_option));
-                }
-                break;
-            }
-            case 'h':
-                printf("Enter counter ceiling height [0.0-3.0]m, press enter\r\n");
-                terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-                terminal_ui_print_result(
-                    mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_ceiling_height", value));
-                break;
-            case 'w':
-                printf("Enter counter entrance width [0.0-3.0]m, press enter\r\n");
-                terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-                terminal_ui_print_result(
-                    mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_entrance_width", value));
-                break;
-            case 's':
-                printf("Set sensitivity: [0.0 - 1.0]\r\n");
-                terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-                terminal_ui_print_result(
-                    mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_sensitivity", value));
-                break;
-            case 't':
-                printf("Enter counter traffic light zone [0.0-1.0]m, press enter\r\n");
-                terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-                terminal_ui_print_result(
-                    mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_traffic_light_zone", value));
-                break;
-            case 'r':
-            {
-                printf("Select counter reverse:\r\n");
-                char *reverse_choices[] = {"true", "false"};
-                char *selected = terminal_ui_getselection(&cy_retarget_io_uart_obj,
-                                                        reverse_choices,
-                                                        sizeof(reverse_choices) / sizeof(char *));
-                if (selected != NULL)
-                {
-                    terminal_ui_print_result(
-                        mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_reverse", selected));
-                }
-                break;
-            }
-            case 'm':
-                printf("Enter counter min person height [0.0-2.0]m, press enter\r\n");
-                terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_RADAR_SENSING_VALUE_MAXLENGTH);
-                terminal_ui_print_result(
-                    mtb_radar_sensing_set_parameter(&sensing_context, "radar_counter_min_person_height", value));
-                break;
-            default:
-                terminal_ui_info();
+            printf("  %lu: %s at %02u:%02u%s\r\n",
+                   (unsigned long)(i + 1U),
+                   profile.name,
+                   (unsigned)(profile.start_minute / 60U),
+                   (unsigned)(profile.start_minute % 60U),
+                   (stats.active == (int32_t)i) ? " *" : "");
         }
-        rx_value = 0;
     }
-    printf("Exiting terminal ui\r\n");
-    /* Exit current thread (suspend) */
-    (void)cy_rtos_exit_thread();
+    printf("Enter <n> to apply, s<n>[=name] to save the settings, <n>@HH:MM to schedule,\r\n"
+           "time=HH:MM to set the time, press enter\r\n");
+    terminal_ui_start_readline(terminal_ui_profiles_complete);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_adapt_complete
+ ********************************************************************************
+ * Summary:
+ *   This function enables or disables the sensitivity adaptation.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_adapt_complete(void)
+{
+    if ((strcmp(ui.line, "0") == 0) || (strcmp(ui.line, "1") == 0))
+    {
+        radar_counter_adapt_enable(ui.line[0] == '1');
+        printf("OK\r\n");
+    }
+    else
+    {
+        printf("not updated\r\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_adapt
+ ********************************************************************************
+ * Summary:
+ *   This function prints the window statistics and the logged changes of
+ *   the sensitivity adaptation and asks whether to enable it.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_adapt(void)
+{
+    radar_counter_adapt_stats_t stats;
+    radar_counter_adapt_change_t log[RADAR_COUNTER_ADAPT_LOG_LENGTH];
+    const radar_counter_param_t *param = &radar_counter_params[RADAR_COUNTER_PARAM_SENSITIVITY];
+    char old_value[IFX_RADAR_SENSING_VALUE_MAXLENGTH];
+    char new_value[IFX_RADAR_SENSING_VALUE_MAXLENGTH];
+    char timestamp[24];
+
+    radar_counter_adapt_get_stats(&stats);
+    printf("Sensitivity adaptation %s, %lu changes, %lu rate limited\r\n",
+           stats.enabled ? "enabled" : "disabled",
+           (unsigned long)stats.changes,
+           (unsigned long)stats.rate_limited);
+    printf("Window: IN %lu, OUT %lu, %lu occupations (%lu without crossing), %lu ms occupied\r\n",
+           (unsigned long)stats.in,
+           (unsigned long)stats.out,
+           (unsigned long)stats.occupations,
+           (unsigned long)stats.false_occupations,
+           (unsigned long)stats.occupied_ms);
+    uint32_t count = radar_counter_adapt_get_log(log, RADAR_COUNTER_ADAPT_LOG_LENGTH);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        (void)radar_counter_params_format(param, log[i].old_value, old_value, sizeof(old_value));
+        (void)radar_counter_params_format(param, log[i].new_value, new_value, sizeof(new_value));
+        (void)radar_format_timestamp(timestamp, sizeof(timestamp), log[i].timestamp_ms);
+        printf("  %s: %s -> %s, %s%s\r\n",
+               timestamp,
+               old_value,
+               new_value,
+               radar_counter_adapt_reason(log[i].reason),
+               (log[i].result == CY_RSLT_SUCCESS) ? "" : ", ERROR");
+    }
+    printf("Enter 1 to enable, 0 to disable, press enter\r\n");
+    terminal_ui_start_readline(terminal_ui_adapt_complete);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_occupancy_complete
+ ********************************************************************************
+ * Summary:
+ *   This function sets the entered occupancy limit.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_occupancy_complete(void)
+{
+    char *end;
+    unsigned long limit = strtoul(ui.line, &end, 10);
+
+    if ((end == ui.line) || (*end != '\0') || (limit < 1U))
+    {
+        printf("invalid limit, not updated\r\n");
+        return;
+    }
+    radar_occupancy_set_limit((uint32_t)limit);
+    printf("OK\r\n");
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_occupancy
+ ********************************************************************************
+ * Summary:
+ *   This function prints the occupancy and asks for a new occupancy limit.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_occupancy(void)
+{
+    radar_occupancy_stats_t room;
+
+    radar_occupancy_get_stats(&room);
+    printf("Occupancy: %lu of %lu, %s\r\n",
+           (unsigned long)room.occupancy,
+           (unsigned long)room.limit,
+           room.full ? "full" : "free");
+    printf("Enter the occupancy limit, press enter\r\n");
+    terminal_ui_start_readline(terminal_ui_occupancy_complete);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_sync_complete
+ ********************************************************************************
+ * Summary:
+ *   This function adds the entered reference time to the estimate of the
+ *   gateway clock and prints "Y <result> <offset us> <drift ppb> <residual us>".
+ *   The reference time is taken by the gateway when it starts sending 'y'
+ *   and is given in milliseconds with up to three decimals. The local time
+ *   is taken when the line end is received, the transmission time of the
+ *   line is added to the reference time.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_sync_complete(void)
+{
+    static const char *const results[] = {"accepted", "rejected", "restarted"};
+    const char *text = ui.line;
+    uint64_t reference_us = 0U;
+    uint32_t scale = 1000U;
+    radar_timesync_t sync;
+    char line[64];
+
+    if (*text == '\0')
+    {
+        return;
+    }
+    for (; (*text >= '0') && (*text <= '9'); text++)
+    {
+        reference_us = (reference_us * 10U) + (uint64_t)(*text - '0');
+    }
+    reference_us *= 1000U;
+    if (*text == '.')
+    {
+        for (text++; (*text >= '0') && (*text <= '9') && (scale > 1U); text++)
+        {
+            scale /= 10U;
+            reference_us += (uint64_t)(*text - '0') * scale;
+        }
+    }
+    if ((text == ui.line) || (*text != '\0'))
+    {
+        printf("invalid time\r\n");
+        return;
+    }
+
+    reference_us += (uint64_t)(ui.edit.length + 2U) * TERMINAL_UI_CHAR_US;
+    radar_timesync_result_t result = radar_clock_sync(ui.line_end_us, reference_us);
+    radar_clock_get_sync(&sync);
+
+    size_t length = radar_format_string(line, sizeof(line), "Y ");
+    length += radar_format_string(line + length, sizeof(line) - length, results[result]);
+    length += radar_format_string(line + length, sizeof(line) - length, " ");
+    length += radar_format_int(line + length, sizeof(line) - length, sync.offset_us);
+    length += radar_format_string(line + length, sizeof(line) - length, " ");
+    length += radar_format_int(line + length, sizeof(line) - length, sync.drift_ppb);
+    length += radar_format_string(line + length, sizeof(line) - length, " ");
+    (void)radar_format_int(line + length, sizeof(line) - length, sync.last_residual_us);
+    printf("%s\r\n", line);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_sync
+ ********************************************************************************
+ * Summary:
+ *   This function prints the state of the time synchronization with the
+ *   gateway and asks for a reference time.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_sync(void)
+{
+    radar_timesync_t sync;
+    uint64_t reference_us;
+    char timestamp[24];
+
+    radar_clock_get_sync(&sync);
+    if (radar_clock_reference_us(radar_clock_us(), &reference_us))
+    {
+        (void)radar_format_timestamp(timestamp, sizeof(timestamp), reference_us / 1000U);
+        printf("Time sync: %s, drift %ld ppb, last residual %ld us\r\n",
+               timestamp,
+               (long)sync.drift_ppb,
+               (long)sync.last_residual_us);
+    }
+    else
+    {
+        printf("Time sync: not synchronized\r\n");
+    }
+    printf("Samples %lu accepted, %lu rejected, %lu restarts\r\n",
+           (unsigned long)sync.accepted,
+           (unsigned long)sync.rejected,
+           (unsigned long)sync.restarts);
+    printf("Enter the reference time in ms, press enter\r\n");
+    terminal_ui_start_readline(terminal_ui_sync_complete);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_start_edit
+ ********************************************************************************
+ * Summary:
+ *   This function prints the prompt of a parameter and waits for either the
+ *   selection of one of its choices or the entry of a value.
+ *
+ * Parameters:
+ *   param: parameter to be configured
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_start_edit(const radar_counter_param_t *param)
+{
+    ui.param = param;
+    if (param->type == RADAR_COUNTER_PARAM_TYPE_CHOICE)
+    {
+        printf("Select counter %s:\r\n", param->label);
+        for (int i = 0; i < param->num_choices; i++)
+        {
+            printf("\t'%c': %s\r\n", '1' + i, param->choices[i]);
+        }
+        ui.state = TERMINAL_UI_STATE_SELECT;
+    }
+    else
+    {
+        printf("Enter counter %s [%s-%s]%s, press enter\r\n",
+               param->label,
+               param->min_text,
+               param->max_text,
+               param->unit);
+        terminal_ui_start_readline(terminal_ui_param_complete);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_selection_input
+ ********************************************************************************
+ * Summary:
+ *   This function handles a key pressed while a choice is being selected and
+ *   configures the selected choice.
+ *
+ * Parameters:
+ *   rx_value: key pressed
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_selection_input(uint8_t rx_value)
+{
+    int i = radar_line_edit_choice(rx_value, ui.param->num_choices);
+
+    if (i == RADAR_LINE_EDIT_CHOICE_IGNORE)
+    {
+        return;
+    }
+    if (i == RADAR_LINE_EDIT_CHOICE_INVALID)
+    {
+        printf("not updated\r\n");
+    }
+    else
+    {
+        printf("selected '%c': %s\r\n", rx_value, ui.param->choices[i]);
+        terminal_ui_print_result(radar_counter_params_set(ui.param, ui.param->choices[i]));
+    }
+    ui.state = TERMINAL_UI_STATE_IDLE;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_flush_echo
+ ********************************************************************************
+ * Summary:
+ *   This function writes the collected echo characters to the terminal with
+ *   a single UART write.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_flush_echo(void)
+{
+    size_t length = ui_echo_length;
+
+    if (length > 0U)
+    {
+        RADAR_TRACE(RADAR_TRACE_UART_TX_START, length);
+        (void)cyhal_uart_write(&cy_retarget_io_uart_obj, ui_echo, &length);
+        RADAR_TRACE(RADAR_TRACE_UART_TX_END, length);
+        ui_echo_length = 0;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_echo
+ ********************************************************************************
+ * Summary:
+ *   This function collects characters to be echoed to the terminal.
+ *
+ * Parameters:
+ *   text: characters to be echoed
+ *   length: number of characters
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_echo(const char *text, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (ui_echo_length == sizeof(ui_echo))
+        {
+            terminal_ui_flush_echo();
+        }
+        ui_echo[ui_echo_length++] = (uint8_t)text[i];
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_readline_input
+ ********************************************************************************
+ * Summary:
+ *   This function handles a key pressed while a value is being entered:
+ *   the key is passed to the line editor (radar_line_edit.c) and its echo
+ *   is collected. Once enter is pressed, the line is executed, or rejected
+ *   if characters were dropped because it was too long.
+ *
+ * Parameters:
+ *   rx_value: key pressed
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_readline_input(uint8_t rx_value)
+{
+    char echo[RADAR_LINE_EDIT_ECHO_MAXLENGTH];
+    uint32_t echo_length;
+
+    radar_line_edit_result_t result = radar_line_edit_input(&ui.edit, rx_value, echo, &echo_length);
+    terminal_ui_echo(echo, echo_length);
+    if (result == RADAR_LINE_EDIT_CONTINUE)
+    {
+        return;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    ui.line_end_us = ui_rx_line_end_us;
+    Cy_SysLib_ExitCriticalSection(state);
+    terminal_ui_flush_echo();
+    if (result == RADAR_LINE_EDIT_TOO_LONG)
+    {
+        printf("input too long, max %d characters\r\n", TERMINAL_UI_LINE_MAXLENGTH - 1);
+    }
+    else
+    {
+        ui.complete();
+    }
+    ui.state = TERMINAL_UI_STATE_IDLE;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_command_input
+ ********************************************************************************
+ * Summary:
+ *   This function handles a key pressed while no setting is being edited.
+ *
+ * Parameters:
+ *   rx_value: key pressed
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_command_input(uint8_t rx_value)
+{
+    const radar_counter_param_t *param;
+
+    if ((char)rx_value == '?')
+    {
+        terminal_ui_menu();
+    }
+    else if ((char)rx_value == 'd')
+    {
+        terminal_ui_diagnostics();
+    }
+    else if ((char)rx_value == 'j')
+    {
+        terminal_ui_journal();
+    }
+    else if ((char)rx_value == 'x')
+    {
+        terminal_ui_history();
+    }
+    else if ((char)rx_value == 'T')
+    {
+        radar_trace_dump();
+    }
+    else if ((char)rx_value == 'p')
+    {
+        terminal_ui_profiles();
+    }
+    else if ((char)rx_value == 'a')
+    {
+        terminal_ui_adapt();
+    }
+    else if ((char)rx_value == 'y')
+    {
+        terminal_ui_sync();
+    }
+    else if ((char)rx_value == 'l')
+    {
+        terminal_ui_occupancy();
+    }
+    else if ((char)rx_value == 'b')
+    {
+        radar_bench_target_run();
+    }
+    else if ((param = radar_counter_params_find_key((char)rx_value)) != NULL)
+    {
+        terminal_ui_start_edit(param);
+    }
+    else
+    {
+        terminal_ui_info();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_input
+ ********************************************************************************
+ * Summary:
+ *   This function feeds a received key into the terminal UI state machine.
+ *   Event messages are held back from the first key of an interaction until
+ *   the setting has been configured, and printed afterwards.
+ *
+ * Parameters:
+ *   rx_value: key pressed
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_input(uint8_t rx_value)
+{
+    (void)radar_counter_task_set_mute(true);
+
+    switch (ui.state)
+    {
+        case TERMINAL_UI_STATE_SELECT:
+            terminal_ui_selection_input(rx_value);
+            break;
+        case TERMINAL_UI_STATE_READLINE:
+            terminal_ui_readline_input(rx_value);
+            break;
+        case TERMINAL_UI_STATE_IDLE:
+        default:
+            terminal_ui_command_input(rx_value);
+            break;
+    }
+
+    if (ui.state == TERMINAL_UI_STATE_IDLE)
+    {
+        (void)radar_counter_task_set_mute(false);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_uart_event
+ ********************************************************************************
+ * Summary:
+ *   UART interrupt handler. Moves all received keys into the receive buffer
+ *   and wakes the terminal UI task once per interrupt.
+ *
+ * Parameters:
+ *   callback_arg: unused
+ *   event: UART events that occurred
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_uart_event(void *callback_arg, cyhal_uart_event_t event)
+{
+    uint8_t rx_value;
+    uint32_t received = 0;
+
+    if ((event & CYHAL_UART_IRQ_RX_NOT_EMPTY) == 0U)
+    {
+        return;
+    }
+
+    while ((cyhal_uart_readable(&cy_retarget_io_uart_obj) > 0U) &&
+           (cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_value, 0) == CY_RSLT_SUCCESS))
+    {
+        if (!radar_ring_buffer_put(&ui_rx_buffer, rx_value))
+        {
+            ui_rx_overruns++;
+        }
+        else if ((rx_value == '\r') || (rx_value == '\n'))
+        {
+            /* Reception time of a time sync line */
+            ui_rx_line_end_us = radar_clock_us();
+        }
+        received++;
+    }
+
+    if (received > 0U)
+    {
+        RADAR_TRACE(RADAR_TRACE_UART_RX, received);
+        (void)cy_rtos_set_semaphore(&ui_rx_semaphore, true);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_terminal_ui_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the receive buffer of the terminal UI and enables the UART
+ *   receive interrupt. Must be called after retarget-io is initialized and
+ *   before the terminal UI task is started.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the initialization
+ *******************************************************************************/
+cy_rslt_t radar_counter_terminal_ui_init(void)
+{
+    radar_ring_buffer_init(&ui_rx_buffer, ui_rx_storage, sizeof(ui_rx_storage));
+
+    cy_rslt_t result = cy_rtos_init_semaphore(&ui_rx_semaphore, 1, 0);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj, terminal_ui_uart_event, NULL);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj,
+                            CYHAL_UART_IRQ_RX_NOT_EMPTY,
+                            TERMINAL_UI_UART_INTR_PRIORITY,
+                            true);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_terminal_ui_notify
+ ********************************************************************************
+ * Summary:
+ *   Wakes the terminal UI task, e.g. to print event messages that were held
+ *   back while the terminal was in use.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_terminal_ui_notify(void)
+{
+    (void)cy_rtos_set_semaphore(&ui_rx_semaphore, false);
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_terminal_ui
+ ********************************************************************************
+ * Summary:
+ *   Sleeps until keys are received or held back event messages are pending,
+ *   then feeds the keys into the terminal UI state machine. Echo characters
+ *   of a batch of keys are written at once, all UI output with the terminal
+ *   reserved. Buffered event messages are printed whenever no setting is
+ *   being edited.
+ *
+ * Parameters:
+ *   arg: thread
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_terminal_ui(cy_thread_arg_t arg)
+{
+    uint8_t rx_value = 0;
+
+    radar_counter_task_lock_terminal();
+    terminal_ui_menu();
+    radar_counter_task_unlock_terminal();
+
+    for (;;)
+    {
+        (void)cy_rtos_get_semaphore(&ui_rx_semaphore, CY_RTOS_NEVER_TIMEOUT, false);
+
+        /* Keep messages of the radar counter task out of the UI output */
+        radar_counter_task_lock_terminal();
+        while (radar_ring_buffer_get(&ui_rx_buffer, &rx_value))
+        {
+            terminal_ui_input(rx_value);
+        }
+        terminal_ui_flush_echo();
+        radar_counter_task_unlock_terminal();
+
+        /* Print event messages that were held back while the terminal was busy */
+        radar_counter_task_flush_output();
+    }
 }
@@ -35,9 +35,13 @@
 /* Stack size for radar counter terminal ui */
 #define RADAR_COUNTER_TERMINAL_UI_TASK_STACK_SIZE (2048)
 /* Task priority for radar counter terminal ui */
-#define RADAR_COUNTER_TERMINAL_UI_TASK_PRIORITY (CY_RTOS_PRIORITY_BELOWNORMAL)
+#define RADAR_COUNTER_TERMINAL_UI_TASK_PRIORITY (RADAR_SCHED_PRIORITY_TERMINAL_UI)
+/* Priority of the UART receive interrupt */
+#define TERMINAL_UI_UART_INTR_PRIORITY (7U)
 
 /*******************************************************************************
  * Functions
  *******************************************************************************/
+cy_rslt_t radar_counter_terminal_ui_init(void);
+void radar_counter_terminal_ui_notify(void);
 void radar_counter_terminal_ui(cy_thread_arg_t arg);
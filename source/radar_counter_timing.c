@@ -0,0 +1,228 @@
+/*****************************************************************************
+** File name: radar_counter_timing.c
+**
+** Description: This file measures the period jitter and the duration of the
+** radar processing calls with the high resolution clock.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdbool.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Header file for local module */
+#include "radar_clock.h"
+#include "radar_counter_timing.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+const uint32_t radar_counter_timing_bin_limits_us[RADAR_COUNTER_TIMING_BINS - 1U] = {
+    50U, 100U, 250U, 500U, 1000U, 2000U, 5000U};
+
+static radar_counter_timing_stats_t timing_stats;
+static uint32_t timing_nominal_us = 0;  // expected period
+static uint32_t timing_deadline_us = 0; // longest acceptable processing call
+static uint64_t timing_start_us = 0;    // start of the current call
+static bool timing_started = false;     // a previous call was measured
+
+/*******************************************************************************
+ * Function Name: radar_counter_timing_init
+ ********************************************************************************
+ * Summary:
+ *   Sets the expected timing of the processing loop and clears the
+ *   statistics.
+ *
+ * Parameters:
+ *   nominal_period_us: expected time between the start of two calls
+ *   deadline_us: longest acceptable processing call
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_timing_init(uint32_t nominal_period_us, uint32_t deadline_us)
+{
+    taskENTER_CRITICAL();
+    timing_nominal_us = nominal_period_us;
+    timing_deadline_us = deadline_us;
+    timing_stats = (radar_counter_timing_stats_t){.period_min_us = UINT32_MAX};
+    timing_started = false;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_timing_process_start
+ ********************************************************************************
+ * Summary:
+ *   Records the start of a processing call and the period since the start
+ *   of the previous one.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_timing_process_start(void)
+{
+    uint64_t now_us = radar_clock_us();
+
+    if (timing_started)
+    {
+        uint32_t period_us = (uint32_t)(now_us - timing_start_us);
+        uint32_t deviation_us = (period_us > timing_nominal_us) ? (period_us - timing_nominal_us) :
+                                                                  (timing_nominal_us - period_us);
+        uint32_t bin = 0;
+
+        while ((bin < (RADAR_COUNTER_TIMING_BINS - 1U)) && (deviation_us >= radar_counter_timing_bin_limits_us[bin]))
+        {
+            bin++;
+        }
+
+        taskENTER_CRITICAL();
+        timing_stats.periods++;
+        timing_stats.histogram[bin]++;
+        if (period_us < timing_stats.period_min_us)
+        {
+            timing_stats.period_min_us = period_us;
+        }
+        if (period_us > timing_stats.period_max_us)
+        {
+            timing_stats.period_max_us = period_us;
+        }
+        taskEXIT_CRITICAL();
+    }
+    timing_start_us = now_us;
+    timing_started = true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_timing_process_end
+ ********************************************************************************
+ * Summary:
+ *   Records the end of a processing call and checks its deadline.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_timing_process_end(void)
+{
+    uint32_t process_us = (uint32_t)(radar_clock_us() - timing_start_us);
+
+    taskENTER_CRITICAL();
+    if (process_us > timing_stats.process_max_us)
+    {
+        timing_stats.process_max_us = process_us;
+    }
+    if (process_us > timing_deadline_us)
+    {
+        timing_stats.deadline_misses++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_timing_event
+ ********************************************************************************
+ * Summary:
+ *   Records the latency of an event callback from the start of the
+ *   processing call that detected the event.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   microseconds since the start of the processing call
+ *******************************************************************************/
+uint32_t radar_counter_timing_event(void)
+{
+    uint32_t latency_us = (uint32_t)(radar_clock_us() - timing_start_us);
+
+    taskENTER_CRITICAL();
+    if (latency_us > timing_stats.event_latency_max_us)
+    {
+        timing_stats.event_latency_max_us = latency_us;
+    }
+    taskEXIT_CRITICAL();
+    return latency_us;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_timing_overrun
+ ********************************************************************************
+ * Summary:
+ *   Records a period of the fixed rate loop that ended after the next
+ *   period boundary.
+ *
+ * Parameters:
+ *   skipped_periods: periods dropped by the catch-up policy
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_timing_overrun(uint32_t skipped_periods)
+{
+    taskENTER_CRITICAL();
+    timing_stats.overruns++;
+    timing_stats.skipped_periods += skipped_periods;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_timing_resync
+ ********************************************************************************
+ * Summary:
+ *   Starts period measurement anew after an intended pause of the loop,
+ *   e.g. a recovery, so that the pause is not counted as jitter.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_timing_resync(void)
+{
+    timing_started = false;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_timing_get_stats
+ ********************************************************************************
+ * Summary:
+ *   Copies the timing statistics.
+ *
+ * Parameters:
+ *   stats: copy of the statistics
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_counter_timing_get_stats(radar_counter_timing_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = timing_stats;
+    taskEXIT_CRITICAL();
+}
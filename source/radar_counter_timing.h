@@ -0,0 +1,68 @@
+/******************************************************************************
+** File name: radar_counter_timing.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_counter_timing.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Number of bins of the period jitter histogram */
+#define RADAR_COUNTER_TIMING_BINS (8U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Timing statistics of the processing loop */
+typedef struct
+{
+    uint32_t periods;                              // measured periods
+    uint32_t period_min_us;
+    uint32_t period_max_us;
+    uint32_t histogram[RADAR_COUNTER_TIMING_BINS]; // periods by deviation from the nominal period
+    uint32_t process_max_us;                       // longest processing call
+    uint32_t deadline_misses;                      // calls longer than the deadline
+    uint32_t event_latency_max_us;                 // longest time from call start to event callback
+    uint32_t overruns;                             // periods that ended after the next period boundary
+    uint32_t skipped_periods;                      // periods dropped by the catch-up policy
+} radar_counter_timing_stats_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Upper limits of the histogram bins, the last bin has no limit */
+extern const uint32_t radar_counter_timing_bin_limits_us[RADAR_COUNTER_TIMING_BINS - 1U];
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_counter_timing_init(uint32_t nominal_period_us, uint32_t deadline_us);
+void radar_counter_timing_process_start(void);
+void radar_counter_timing_process_end(void);
+uint32_t radar_counter_timing_event(void);
+void radar_counter_timing_overrun(uint32_t skipped_periods);
+void radar_counter_timing_resync(void);
+void radar_counter_timing_get_stats(radar_counter_timing_stats_t *stats);
@@ -0,0 +1,462 @@
+/*****************************************************************************
+** File name: radar_counter_traffic_gen.c
+**
+** Description: This file implements a synthetic traffic generator that stands
+** in for the radar in order to load test the counter event path.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#if defined(RADAR_COUNTER_TRAFFIC_GEN)
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+
+/* Header file for local task */
+#include "radar_counter_task.h"
+#include "radar_counter_traffic_gen.h"
+#include "radar_event_bus.h"
+#include "radar_led_task.h"
+
+/*******************************************************************************
+ * Constants
+ *******************************************************************************/
+#define TRAFFIC_GEN_FLOW_IN  (0U)
+#define TRAFFIC_GEN_FLOW_OUT (1U)
+#define TRAFFIC_GEN_NEVER    (UINT64_MAX)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static radar_traffic_gen_config_t gen_config;
+static mtb_radar_sensing_callback_t gen_callback = NULL;
+static mtb_radar_sensing_context_t *gen_context = NULL;
+static void *gen_data = NULL;
+
+static uint32_t gen_random_state;    // xorshift32 state
+static uint32_t gen_rate;            // crossings per second of the current step
+static uint64_t gen_next_us[2];      // next arrival of the IN and OUT flows
+static uint32_t gen_burst_remaining; // crossings left in the current group
+static bool gen_occupied = false;    // traffic light zone state
+static uint64_t gen_free_us;         // time at which the zone becomes free
+static uint32_t gen_in_count = 0;
+static uint32_t gen_out_count = 0;
+static bool gen_done = false;
+
+/* Statistics of the current rate step */
+static uint64_t step_start_ms;
+static uint32_t step_crossings;
+static uint32_t step_events;
+static uint32_t step_print_drops;
+static uint32_t step_led_overrides;
+static uint32_t step_bus_drops;
+static uint32_t step_sink_drops;
+
+/* Delivery statistics of the current rate step, updated by the event bus task */
+static uint32_t step_delivered;
+static uint64_t step_delay_sum_ms;
+static uint32_t step_delay_max_ms;
+static uint32_t max_sustained_rate = 0;
+
+/*******************************************************************************
+ * Function Name: traffic_gen_random
+ ********************************************************************************
+ * Summary:
+ *   Returns the next value of a xorshift32 pseudo random sequence.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   pseudo random number
+ *******************************************************************************/
+static uint32_t traffic_gen_random(void)
+{
+    gen_random_state ^= gen_random_state << 13;
+    gen_random_state ^= gen_random_state >> 17;
+    gen_random_state ^= gen_random_state << 5;
+    return gen_random_state;
+}
+
+/*******************************************************************************
+ * Function Name: traffic_gen_exponential_us
+ ********************************************************************************
+ * Summary:
+ *   Draws an exponentially distributed inter-arrival time, which makes the
+ *   arrivals a Poisson process.
+ *
+ * Parameters:
+ *   mean_us: mean inter-arrival time in microseconds
+ *
+ * Return:
+ *   inter-arrival time in microseconds
+ *******************************************************************************/
+static uint64_t traffic_gen_exponential_us(uint32_t mean_us)
+{
+    /* Uniform value in (0, 1] */
+    float u = (float)((traffic_gen_random() >> 8) + 1U) / 16777216.0f;
+    return (uint64_t)(-logf(u) * (float)mean_us);
+}
+
+/*******************************************************************************
+ * Function Name: traffic_gen_start_step
+ ********************************************************************************
+ * Summary:
+ *   Resets step statistics and schedules the first arrivals for the
+ *   current rate.
+ *
+ * Parameters:
+ *   time_ms: start of the step
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void traffic_gen_start_step(uint64_t time_ms)
+{
+    uint64_t now_us = time_ms * 1000U;
+
+    step_start_ms = time_ms;
+    step_crossings = 0;
+    step_events = 0;
+    step_print_drops = radar_counter_task_get_print_drops();
+    step_led_overrides = radar_led_get_overrides();
+    step_bus_drops = radar_event_bus_get_drops();
+    step_sink_drops = radar_event_bus_get_sink_drops();
+    taskENTER_CRITICAL();
+    step_delivered = 0;
+    step_delay_sum_ms = 0;
+    step_delay_max_ms = 0;
+    taskEXIT_CRITICAL();
+
+    switch (gen_config.mode)
+    {
+        case RADAR_TRAFFIC_GEN_MODE_BIDIRECTIONAL:
+            gen_next_us[TRAFFIC_GEN_FLOW_IN] = now_us + traffic_gen_exponential_us(2000000U / gen_rate);
+            gen_next_us[TRAFFIC_GEN_FLOW_OUT] = now_us + traffic_gen_exponential_us(2000000U / gen_rate);
+            break;
+        case RADAR_TRAFFIC_GEN_MODE_BURST:
+            gen_burst_remaining = gen_config.burst_size;
+            gen_next_us[TRAFFIC_GEN_FLOW_IN] =
+                now_us + traffic_gen_exponential_us((gen_config.burst_size * 1000000U) / gen_rate);
+            gen_next_us[TRAFFIC_GEN_FLOW_OUT] = TRAFFIC_GEN_NEVER;
+            break;
+        case RADAR_TRAFFIC_GEN_MODE_POISSON:
+        default:
+            gen_next_us[TRAFFIC_GEN_FLOW_IN] = now_us + traffic_gen_exponential_us(1000000U / gen_rate);
+            gen_next_us[TRAFFIC_GEN_FLOW_OUT] = TRAFFIC_GEN_NEVER;
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: traffic_gen_advance
+ ********************************************************************************
+ * Summary:
+ *   Schedules the next arrival of a flow after an arrival was emitted.
+ *
+ * Parameters:
+ *   flow: flow whose arrival was emitted
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void traffic_gen_advance(uint32_t flow)
+{
+    switch (gen_config.mode)
+    {
+        case RADAR_TRAFFIC_GEN_MODE_BIDIRECTIONAL:
+            gen_next_us[flow] += traffic_gen_exponential_us(2000000U / gen_rate);
+            break;
+        case RADAR_TRAFFIC_GEN_MODE_BURST:
+            if (gen_burst_remaining > 1U)
+            {
+                gen_burst_remaining--;
+                gen_next_us[flow] += (uint64_t)gen_config.burst_spacing_ms * 1000U;
+            }
+            else
+            {
+                gen_burst_remaining = gen_config.burst_size;
+                gen_next_us[flow] += traffic_gen_exponential_us((gen_config.burst_size * 1000000U) / gen_rate);
+            }
+            break;
+        case RADAR_TRAFFIC_GEN_MODE_POISSON:
+        default:
+            gen_next_us[flow] += traffic_gen_exponential_us(1000000U / gen_rate);
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: traffic_gen_emit
+ ********************************************************************************
+ * Summary:
+ *   Delivers one synthetic event to the registered callback. The event
+ *   carries its scheduled arrival as timestamp, from which the console sink
+ *   measures the delay, see radar_traffic_gen_delivered.
+ *
+ * Parameters:
+ *   event: counter event
+ *   arrival_us: scheduled arrival time of the event
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void traffic_gen_emit(mtb_radar_sensing_event_t event, uint64_t arrival_us)
+{
+    mtb_radar_sensing_counter_event_info_t info;
+    uint64_t arrival_ms = arrival_us / 1000U;
+
+    info.event_info.timestamp = arrival_ms;
+    info.in_count = gen_in_count;
+    info.out_count = gen_out_count;
+
+    gen_callback(gen_context, event, (mtb_radar_sensing_event_info_t *)&info, gen_data);
+    step_events++;
+}
+
+/*******************************************************************************
+ * Function Name: traffic_gen_finish_step
+ ********************************************************************************
+ * Summary:
+ *   Prints the report of a rate step and moves on to the next rate. After
+ *   the last step the maximum sustained rate is reported and the generator
+ *   stops.
+ *
+ * Parameters:
+ *   time_ms: end of the step
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void traffic_gen_finish_step(uint64_t time_ms)
+{
+    uint32_t print_drops = radar_counter_task_get_print_drops() - step_print_drops;
+    uint32_t led_overrides = radar_led_get_overrides() - step_led_overrides;
+    uint32_t bus_drops = radar_event_bus_get_drops() - step_bus_drops;
+    uint32_t sink_drops = radar_event_bus_get_sink_drops() - step_sink_drops;
+
+    taskENTER_CRITICAL();
+    uint32_t delivered = step_delivered;
+    uint64_t delay_sum_ms = step_delay_sum_ms;
+    uint32_t delay_max_ms = step_delay_max_ms;
+    taskEXIT_CRITICAL();
+
+    uint32_t delay_avg_ms = (delivered > 0U) ? (uint32_t)(delay_sum_ms / delivered) : 0U;
+    /* A step whose events never reached the console is not sustained either */
+    bool sustained = (print_drops == 0U) && (bus_drops == 0U) && (sink_drops == 0U) &&
+                     ((delivered > 0U) || (step_events == 0U)) && (delay_max_ms <= gen_config.max_delay_ms);
+
+    if (sustained)
+    {
+        max_sustained_rate = gen_rate;
+    }
+
+    printf("traffic gen: rate %lu/s, crossings %lu, events %lu, delivered %lu, delay avg %lu ms max %lu ms, "
+           "bus drops %lu, sink drops %lu, print drops %lu, led overrides %lu, %s\r\n",
+           (unsigned long)gen_rate,
+           (unsigned long)step_crossings,
+           (unsigned long)step_events,
+           (unsigned long)delivered,
+           (unsigned long)delay_avg_ms,
+           (unsigned long)delay_max_ms,
+           (unsigned long)bus_drops,
+           (unsigned long)sink_drops,
+           (unsigned long)print_drops,
+           (unsigned long)led_overrides,
+           sustained ? "sustained" : "overloaded");
+
+    gen_rate += gen_config.rate_step;
+    if ((gen_rate > gen_config.rate_max) || (gen_config.rate_step == 0U))
+    {
+        printf("traffic gen: max sustained rate %lu/s\r\n", (unsigned long)max_sustained_rate);
+        gen_done = true;
+        return;
+    }
+    traffic_gen_start_step(time_ms);
+}
+
+/*******************************************************************************
+ * Function Name: radar_traffic_gen_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the synthetic traffic generator.
+ *
+ * Parameters:
+ *   config: load test configuration
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_traffic_gen_init(const radar_traffic_gen_config_t *config)
+{
+    gen_config = *config;
+    if (gen_config.rate_start == 0U)
+    {
+        gen_config.rate_start = 1U;
+    }
+    if (gen_config.burst_size == 0U)
+    {
+        gen_config.burst_size = 1U;
+    }
+    gen_random_state = (gen_config.seed != 0U) ? gen_config.seed : 1U;
+    gen_rate = gen_config.rate_start;
+    gen_occupied = false;
+    gen_in_count = 0;
+    gen_out_count = 0;
+    gen_done = false;
+    max_sustained_rate = 0;
+    traffic_gen_start_step(ifx_currenttime());
+}
+
+/*******************************************************************************
+ * Function Name: radar_traffic_gen_register_callback
+ ********************************************************************************
+ * Summary:
+ *   Registers the callback that receives the synthetic counter events.
+ *
+ * Parameters:
+ *   context: context object passed to the callback
+ *   callback: counter event callback
+ *   data: user data passed to the callback
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_traffic_gen_register_callback(mtb_radar_sensing_context_t *context,
+                                         mtb_radar_sensing_callback_t callback,
+                                         void *data)
+{
+    gen_context = context;
+    gen_callback = callback;
+    gen_data = data;
+}
+
+/*******************************************************************************
+ * Function Name: radar_traffic_gen_delivered
+ ********************************************************************************
+ * Summary:
+ *   Records the delay between the scheduled arrival of a synthetic event and
+ *   its delivery by the console sink, which includes the time spent in the
+ *   event bus queues. Called from the event bus task.
+ *
+ * Parameters:
+ *   arrival_ms: scheduled arrival, the timestamp reported with the event
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_traffic_gen_delivered(uint64_t arrival_ms)
+{
+    uint64_t now_ms = ifx_currenttime();
+    uint32_t delay_ms = (now_ms > arrival_ms) ? (uint32_t)(now_ms - arrival_ms) : 0U;
+
+    taskENTER_CRITICAL();
+    step_delivered++;
+    step_delay_sum_ms += delay_ms;
+    if (delay_ms > step_delay_max_ms)
+    {
+        step_delay_max_ms = delay_ms;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_traffic_gen_process
+ ********************************************************************************
+ * Summary:
+ *   Stand-in for mtb_radar_sensing_process. Emits all crossings that are due
+ *   at the given time together with the occupied/free events of the traffic
+ *   light zone.
+ *
+ * Parameters:
+ *   time_ms: current time in ms
+ *
+ * Return:
+ *   MTB_RADAR_SENSING_SUCCESS
+ *******************************************************************************/
+cy_rslt_t radar_traffic_gen_process(uint64_t time_ms)
+{
+    uint64_t now_us = time_ms * 1000U;
+    uint32_t emitted = 0;
+
+    if ((gen_callback == NULL) || gen_done)
+    {
+        return MTB_RADAR_SENSING_SUCCESS;
+    }
+
+    while (emitted < RADAR_TRAFFIC_GEN_MAX_EVENTS_PER_PROCESS)
+    {
+        uint32_t flow = (gen_next_us[TRAFFIC_GEN_FLOW_OUT] < gen_next_us[TRAFFIC_GEN_FLOW_IN])
+                        ? TRAFFIC_GEN_FLOW_OUT
+                        : TRAFFIC_GEN_FLOW_IN;
+        uint64_t arrival_us = gen_next_us[flow];
+        if (arrival_us > now_us)
+        {
+            break;
+        }
+
+        /* Zone cleared before this arrival */
+        if (gen_occupied && (gen_free_us <= arrival_us))
+        {
+            traffic_gen_emit(MTB_RADAR_SENSING_EVENT_COUNTER_FREE, gen_free_us);
+            gen_occupied = false;
+        }
+        if (!gen_occupied)
+        {
+            traffic_gen_emit(MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED, arrival_us);
+            gen_occupied = true;
+        }
+
+        /* Single flow modes draw the direction of each crossing */
+        bool in = (gen_config.mode == RADAR_TRAFFIC_GEN_MODE_BIDIRECTIONAL)
+                  ? (flow == TRAFFIC_GEN_FLOW_IN)
+                  : ((traffic_gen_random() % 100U) < gen_config.in_percent);
+        if (in)
+        {
+            gen_in_count++;
+            traffic_gen_emit(MTB_RADAR_SENSING_EVENT_COUNTER_IN, arrival_us);
+        }
+        else
+        {
+            gen_out_count++;
+            traffic_gen_emit(MTB_RADAR_SENSING_EVENT_COUNTER_OUT, arrival_us);
+        }
+        step_crossings++;
+        emitted++;
+
+        gen_free_us = arrival_us + ((uint64_t)gen_config.dwell_ms * 1000U);
+        traffic_gen_advance(flow);
+    }
+
+    if (gen_occupied && (gen_free_us <= now_us) && (emitted < RADAR_TRAFFIC_GEN_MAX_EVENTS_PER_PROCESS))
+    {
+        traffic_gen_emit(MTB_RADAR_SENSING_EVENT_COUNTER_FREE, gen_free_us);
+        gen_occupied = false;
+    }
+
+    if ((time_ms - step_start_ms) >= gen_config.step_duration_ms)
+    {
+        traffic_gen_finish_step(time_ms);
+    }
+
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+#endif /* defined(RADAR_COUNTER_TRAFFIC_GEN) */
@@ -0,0 +1,91 @@
+/******************************************************************************
+** File name: radar_counter_traffic_gen.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_counter_traffic_gen.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file includes */
+#include "cy_result.h"
+
+/* Header file for library */
+#include "mtb_radar_sensing.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Maximum number of events emitted by a single process call. Arrivals beyond
+ * this limit stay pending and show up as queueing delay. */
+#define RADAR_TRAFFIC_GEN_MAX_EVENTS_PER_PROCESS (32U)
+
+/* Default load test: Poisson crossings ramped from 1/s to 50/s */
+#define RADAR_TRAFFIC_GEN_CONFIG_DEFAULT            \
+    {                                               \
+        .mode = RADAR_TRAFFIC_GEN_MODE_POISSON,     \
+        .rate_start = 1U,                           \
+        .rate_step = 1U,                            \
+        .rate_max = 50U,                            \
+        .step_duration_ms = 10000U,                 \
+        .in_percent = 50U,                          \
+        .burst_size = 4U,                           \
+        .burst_spacing_ms = 300U,                   \
+        .dwell_ms = 500U,                           \
+        .max_delay_ms = 10U,                        \
+        .seed = 0x1234567U                          \
+    }
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Arrival patterns of the synthetic traffic */
+typedef enum
+{
+    RADAR_TRAFFIC_GEN_MODE_POISSON,      /* single flow, Poisson arrivals */
+    RADAR_TRAFFIC_GEN_MODE_BURST,        /* Poisson arrivals of groups of people */
+    RADAR_TRAFFIC_GEN_MODE_BIDIRECTIONAL /* independent IN and OUT Poisson flows */
+} radar_traffic_gen_mode_t;
+
+/* Load test configuration */
+typedef struct
+{
+    radar_traffic_gen_mode_t mode;
+    uint32_t rate_start;       /* crossings per second of the first step */
+    uint32_t rate_step;        /* rate increment between steps */
+    uint32_t rate_max;         /* rate of the last step */
+    uint32_t step_duration_ms; /* duration of each rate step */
+    uint32_t in_percent;       /* share of IN crossings (POISSON and BURST) */
+    uint32_t burst_size;       /* crossings per group (BURST) */
+    uint32_t burst_spacing_ms; /* spacing of crossings within a group (BURST) */
+    uint32_t dwell_ms;         /* zone reported free this long after the last crossing */
+    uint32_t max_delay_ms;     /* highest delivery delay of a sustained step */
+    uint32_t seed;             /* random generator seed */
+} radar_traffic_gen_config_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_traffic_gen_init(const radar_traffic_gen_config_t *config);
+void radar_traffic_gen_register_callback(mtb_radar_sensing_context_t *context,
+                                         mtb_radar_sensing_callback_t callback,
+                                         void *data);
+void radar_traffic_gen_delivered(uint64_t arrival_ms);
+cy_rslt_t radar_traffic_gen_process(uint64_t time_ms);
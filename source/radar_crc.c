@@ -0,0 +1,63 @@
+/*****************************************************************************
+** File name: radar_crc.c
+**
+** Description: This file implements the CRC-32 used to check data kept
+** across resets and data exchanged with a host.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_crc.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* CRC of every 4 bit value, small enough to keep in flash */
+static const uint32_t crc32_nibble_table[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU};
+
+/*******************************************************************************
+ * Function Name: radar_crc32
+ ********************************************************************************
+ * Summary:
+ *   Computes the CRC-32 of a block of data.
+ *
+ * Parameters:
+ *   crc: CRC of the preceding data, 0 for the first block
+ *   data: data
+ *   length: number of bytes
+ *
+ * Return:
+ *   CRC of all data up to the end of this block
+ *******************************************************************************/
+uint32_t radar_crc32(uint32_t crc, const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (length-- > 0U)
+    {
+        crc ^= *bytes++;
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0FU];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0FU];
+    }
+    return ~crc;
+}
@@ -0,0 +1,36 @@
+/******************************************************************************
+** File name: radar_crc.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_crc.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+/* CRC-32 (IEEE 802.3, as used by zlib). Start with crc = 0; the CRC of data
+ * split into several parts is computed by passing the previous result. */
+uint32_t radar_crc32(uint32_t crc, const void *data, size_t length);
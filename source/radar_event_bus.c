@@ -0,0 +1,433 @@
+/*****************************************************************************
+** File name: radar_event_bus.c
+**
+** Description: This file implements the event bus that delivers counter events
+** from the sensing callback to the registered sinks. Publishing is
+** constant-time; filtering and delivery run in the dispatch task.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_clock.h"
+#include "radar_event_bus.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Queues are byte ring buffers of power of two size holding whole events */
+_Static_assert((sizeof(radar_counter_event_t) & (sizeof(radar_counter_event_t) - 1U)) == 0U,
+               "event size must be a power of two");
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static radar_event_bus_sink_t *bus_sinks[RADAR_EVENT_BUS_MAX_SINKS];
+static volatile uint32_t bus_sink_count = 0;
+static uint8_t bus_queue_storage[RADAR_EVENT_BUS_QUEUE_LENGTH * sizeof(radar_counter_event_t)];
+static radar_ring_buffer_t bus_queue;        // published events, written by the sensing callback only
+static cy_semaphore_t bus_semaphore;         // signals published events
+static volatile uint32_t bus_drops = 0;      // events lost because the bus queue was full
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_filter
+ ********************************************************************************
+ * Summary:
+ *   Maps an event to its filter bit.
+ *
+ * Parameters:
+ *   event: event type
+ *
+ * Return:
+ *   filter bit, 0 for events no sink can subscribe to
+ *******************************************************************************/
+static uint32_t radar_event_bus_filter(mtb_radar_sensing_event_t event)
+{
+    switch (event)
+    {
+        case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
+            return RADAR_EVENT_BUS_FILTER_IN;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
+            return RADAR_EVENT_BUS_FILTER_OUT;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
+            return RADAR_EVENT_BUS_FILTER_OCCUPIED;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_FREE:
+            return RADAR_EVENT_BUS_FILTER_FREE;
+        default:
+            return 0U;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the bus queue. Must be called before the dispatch task is
+ *   created and before any sink subscribes.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the initialization
+ *******************************************************************************/
+cy_rslt_t radar_event_bus_init(void)
+{
+    radar_ring_buffer_init(&bus_queue, bus_queue_storage, sizeof(bus_queue_storage));
+    return cy_rtos_init_semaphore(&bus_semaphore, 1, 0);
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_subscribe
+ ********************************************************************************
+ * Summary:
+ *   Registers a sink. Events that pass the filter are queued for the sink
+ *   and passed to its handler in the dispatch task. Sinks cannot be
+ *   removed.
+ *
+ * Parameters:
+ *   sink: sink object, must stay valid
+ *   name: name shown in the statistics
+ *   filter: RADAR_EVENT_BUS_FILTER_* bits of the events to receive
+ *   handler: function called for each event
+ *   arg: argument passed to the handler
+ *   storage: queue storage of RADAR_EVENT_BUS_SINK_STORAGE_SIZE(n) bytes,
+ *            n a power of two
+ *   storage_size: size of the queue storage
+ *
+ * Return:
+ *   RADAR_EVENT_BUS_RSLT_ERR_NO_SINK if all sink slots are in use,
+ *   CY_RSLT_SUCCESS otherwise
+ *******************************************************************************/
+cy_rslt_t radar_event_bus_subscribe(radar_event_bus_sink_t *sink,
+                                    const char *name,
+                                    uint32_t filter,
+                                    radar_event_bus_handler_t handler,
+                                    void *arg,
+                                    uint8_t *storage,
+                                    uint32_t storage_size)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    sink->name = name;
+    sink->filter = filter;
+    sink->handler = handler;
+    sink->arg = arg;
+    sink->stats = (radar_event_bus_sink_stats_t){0};
+    radar_ring_buffer_init(&sink->queue, storage, storage_size);
+
+    taskENTER_CRITICAL();
+    if (bus_sink_count < RADAR_EVENT_BUS_MAX_SINKS)
+    {
+        bus_sinks[bus_sink_count] = sink;
+        bus_sink_count++;
+    }
+    else
+    {
+        result = RADAR_EVENT_BUS_RSLT_ERR_NO_SINK;
+    }
+    taskEXIT_CRITICAL();
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_publish
+ ********************************************************************************
+ * Summary:
+ *   Queues an event for dispatch. Takes the same time regardless of the
+ *   number of sinks. Must only be called from the sensing callback.
+ *
+ * Parameters:
+ *   event: event to publish
+ *
+ * Return:
+ *   false if the bus queue was full and the event was dropped
+ *******************************************************************************/
+bool radar_event_bus_publish(const radar_counter_event_t *event)
+{
+    if (!radar_ring_buffer_write(&bus_queue, (const uint8_t *)event, sizeof(*event)))
+    {
+        bus_drops++;
+        return false;
+    }
+    (void)cy_rtos_set_semaphore(&bus_semaphore, false);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_get_sink_count
+ ********************************************************************************
+ * Summary:
+ *   Gets the number of registered sinks.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of sinks
+ *******************************************************************************/
+uint32_t radar_event_bus_get_sink_count(void)
+{
+    return bus_sink_count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_get_sink_stats
+ ********************************************************************************
+ * Summary:
+ *   Copies the statistics of a sink.
+ *
+ * Parameters:
+ *   index: sink index, less than radar_event_bus_get_sink_count()
+ *   stats: copy of the statistics
+ *
+ * Return:
+ *   name of the sink
+ *******************************************************************************/
+const char *radar_event_bus_get_sink_stats(uint32_t index, radar_event_bus_sink_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = bus_sinks[index]->stats;
+    taskEXIT_CRITICAL();
+    return bus_sinks[index]->name;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_get_drops
+ ********************************************************************************
+ * Summary:
+ *   Gets the number of events dropped because the bus queue was full.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of dropped events
+ *******************************************************************************/
+uint32_t radar_event_bus_get_drops(void)
+{
+    return bus_drops;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_get_sink_drops
+ ********************************************************************************
+ * Summary:
+ *   Gets the number of events dropped because a sink queue was full, summed
+ *   over all sinks.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of dropped sink events
+ *******************************************************************************/
+uint32_t radar_event_bus_get_sink_drops(void)
+{
+    uint32_t drops = 0;
+    uint32_t sink_count = bus_sink_count;
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < sink_count; i++)
+    {
+        drops += bus_sinks[i]->stats.dropped;
+    }
+    taskEXIT_CRITICAL();
+    return drops;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_to_record
+ ********************************************************************************
+ * Summary:
+ *   Converts a counter event into the binary record used by logs, telemetry
+ *   and storage. Once the clock is synchronized with the gateway, the
+ *   timestamp is converted into the gateway timebase and flagged.
+ *
+ * Parameters:
+ *   event: counter event
+ *   record: record
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_event_bus_to_record(const radar_counter_event_t *event, radar_event_record_t *record)
+{
+    switch (event->event)
+    {
+        case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
+            record->type = RADAR_EVENT_RECORD_TYPE_IN;
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
+            record->type = RADAR_EVENT_RECORD_TYPE_OUT;
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
+            record->type = RADAR_EVENT_RECORD_TYPE_OCCUPIED;
+            break;
+        default:
+            record->type = RADAR_EVENT_RECORD_TYPE_FREE;
+            break;
+    }
+    record->sensor_id = RADAR_COUNTER_SENSOR_ID;
+    record->sequence = event->sequence;
+    record->flags = 0U;
+    if (radar_clock_reference_us(event->time_us, &record->timestamp_us))
+    {
+        record->flags |= RADAR_EVENT_RECORD_FLAG_SYNCED;
+    }
+    record->in_count = event->in_count;
+    record->out_count = event->out_count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_from_record
+ ********************************************************************************
+ * Summary:
+ *   Converts a binary record back into a counter event, e.g. to print records
+ *   read from storage like live events.
+ *
+ * Parameters:
+ *   record: record
+ *   event: counter event
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_event_bus_from_record(const radar_event_record_t *record, radar_counter_event_t *event)
+{
+    switch (record->type)
+    {
+        case RADAR_EVENT_RECORD_TYPE_IN:
+            event->event = MTB_RADAR_SENSING_EVENT_COUNTER_IN;
+            break;
+        case RADAR_EVENT_RECORD_TYPE_OUT:
+            event->event = MTB_RADAR_SENSING_EVENT_COUNTER_OUT;
+            break;
+        case RADAR_EVENT_RECORD_TYPE_OCCUPIED:
+            event->event = MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED;
+            break;
+        default:
+            event->event = MTB_RADAR_SENSING_EVENT_COUNTER_FREE;
+            break;
+    }
+    event->sequence = record->sequence;
+    event->time_us = record->timestamp_us;
+    event->timestamp_ms = record->timestamp_us / 1000U;
+    event->in_count = record->in_count;
+    event->out_count = record->out_count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_fan_out
+ ********************************************************************************
+ * Summary:
+ *   Moves the published events into the queues of the sinks whose filter
+ *   they pass. A full sink queue drops the event for that sink only.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_event_bus_fan_out(void)
+{
+    radar_counter_event_t event;
+
+    while (radar_ring_buffer_read(&bus_queue, (uint8_t *)&event, sizeof(event)) == sizeof(event))
+    {
+        uint32_t filter = radar_event_bus_filter(event.event);
+        uint32_t sink_count = bus_sink_count;
+
+        for (uint32_t i = 0; i < sink_count; i++)
+        {
+            radar_event_bus_sink_t *sink = bus_sinks[i];
+            if ((sink->filter & filter) == 0U)
+            {
+                continue;
+            }
+
+            bool queued = radar_ring_buffer_write(&sink->queue, (const uint8_t *)&event, sizeof(event));
+            uint32_t depth = radar_ring_buffer_count(&sink->queue) / sizeof(event);
+            taskENTER_CRITICAL();
+            if (!queued)
+            {
+                sink->stats.dropped++;
+            }
+            if (depth > sink->stats.max_depth)
+            {
+                sink->stats.max_depth = depth;
+            }
+            taskEXIT_CRITICAL();
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_deliver
+ ********************************************************************************
+ * Summary:
+ *   Passes the queued events of every sink to its handler.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_event_bus_deliver(void)
+{
+    radar_counter_event_t event;
+    uint32_t sink_count = bus_sink_count;
+
+    for (uint32_t i = 0; i < sink_count; i++)
+    {
+        radar_event_bus_sink_t *sink = bus_sinks[i];
+        while (radar_ring_buffer_read(&sink->queue, (uint8_t *)&event, sizeof(event)) == sizeof(event))
+        {
+            sink->handler(&event, sink->arg);
+            taskENTER_CRITICAL();
+            sink->stats.delivered++;
+            taskEXIT_CRITICAL();
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_bus_task
+ ********************************************************************************
+ * Summary:
+ *   Dispatch task: waits for published events and delivers them to the
+ *   sinks.
+ *
+ * Parameters:
+ *   arg: thread
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_event_bus_task(cy_thread_arg_t arg)
+{
+    for (;;)
+    {
+        (void)cy_rtos_get_semaphore(&bus_semaphore, CY_RTOS_NEVER_TIMEOUT, false);
+        radar_event_bus_fan_out();
+        radar_event_bus_deliver();
+    }
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+** File name: radar_event_bus.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_event_bus.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+#include "cyabs_rtos.h"
+
+/* Header file for library */
+#include "mtb_radar_sensing.h"
+
+/* Header file for local module */
+#include "radar_event_record.h"
+#include "radar_ring_buffer.h"
+#include "radar_sched_profile.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Event bus dispatch task name */
+#define RADAR_EVENT_BUS_TASK_NAME "RADAR EVENT BUS TASK"
+/* Event bus dispatch task stack size */
+#define RADAR_EVENT_BUS_TASK_STACK_SIZE (2048)
+/* Event bus dispatch task priority */
+#define RADAR_EVENT_BUS_TASK_PRIORITY (RADAR_SCHED_PRIORITY_EVENT_BUS)
+
+/* Maximum number of sinks */
+#define RADAR_EVENT_BUS_MAX_SINKS (6U)
+/* Events published but not yet dispatched, a power of two */
+#define RADAR_EVENT_BUS_QUEUE_LENGTH (16U)
+
+/* Sink filters, combined with | */
+#define RADAR_EVENT_BUS_FILTER_IN       (1UL << 0)
+#define RADAR_EVENT_BUS_FILTER_OUT      (1UL << 1)
+#define RADAR_EVENT_BUS_FILTER_OCCUPIED (1UL << 2)
+#define RADAR_EVENT_BUS_FILTER_FREE     (1UL << 3)
+#define RADAR_EVENT_BUS_FILTER_ALL                                                      \
+    (RADAR_EVENT_BUS_FILTER_IN | RADAR_EVENT_BUS_FILTER_OUT | RADAR_EVENT_BUS_FILTER_OCCUPIED | \
+     RADAR_EVENT_BUS_FILTER_FREE)
+
+/* No free sink slot */
+#define RADAR_EVENT_BUS_RSLT_ERR_NO_SINK \
+    (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x90U))
+
+/* Sensor id put into event records, unique per door */
+#ifndef RADAR_COUNTER_SENSOR_ID
+#define RADAR_COUNTER_SENSOR_ID (0U)
+#endif
+
+/* Size of the queue storage of a sink holding length events */
+#define RADAR_EVENT_BUS_SINK_STORAGE_SIZE(length) ((length) * sizeof(radar_counter_event_t))
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Counter event as delivered to the sinks */
+typedef struct
+{
+    uint64_t time_us;          // radar_clock_us() at detection
+    uint64_t timestamp_ms;     // timestamp reported by RadarSensing
+    uint32_t in_count;         // total in count
+    uint32_t out_count;        // total out count
+    uint32_t sequence;         // counts all events detected since startup
+    mtb_radar_sensing_event_t event;
+} radar_counter_event_t;
+
+/* Handler of a sink, called from the dispatch task */
+typedef void (*radar_event_bus_handler_t)(const radar_counter_event_t *event, void *arg);
+
+/* Sink statistics */
+typedef struct
+{
+    uint32_t delivered; // events passed to the handler
+    uint32_t dropped;   // events lost because the sink queue was full
+    uint32_t max_depth; // highest number of queued events
+} radar_event_bus_sink_stats_t;
+
+/* Sink, allocated by the subscriber */
+typedef struct
+{
+    const char *name;
+    uint32_t filter;
+    radar_event_bus_handler_t handler;
+    void *arg;
+    radar_ring_buffer_t queue;
+    radar_event_bus_sink_stats_t stats;
+} radar_event_bus_sink_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t radar_event_bus_init(void);
+cy_rslt_t radar_event_bus_subscribe(radar_event_bus_sink_t *sink,
+                                    const char *name,
+                                    uint32_t filter,
+                                    radar_event_bus_handler_t handler,
+                                    void *arg,
+                                    uint8_t *storage,
+                                    uint32_t storage_size);
+bool radar_event_bus_publish(const radar_counter_event_t *event);
+uint32_t radar_event_bus_get_sink_count(void);
+const char *radar_event_bus_get_sink_stats(uint32_t index, radar_event_bus_sink_stats_t *stats);
+uint32_t radar_event_bus_get_drops(void);
+uint32_t radar_event_bus_get_sink_drops(void);
+void radar_event_bus_to_record(const radar_counter_event_t *event, radar_event_record_t *record);
+void radar_event_bus_from_record(const radar_event_record_t *record, radar_counter_event_t *event);
+void radar_event_bus_task(cy_thread_arg_t arg);
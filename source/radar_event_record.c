@@ -0,0 +1,217 @@
+/*****************************************************************************
+** File name: radar_event_record.c
+**
+** Description: This file encodes and decodes the binary counter event record
+** shared by the firmware and host tools.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_crc.h"
+#include "radar_event_record.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Offsets of the fields of an encoded record */
+#define RECORD_OFFSET_VERSION   (0U)
+#define RECORD_OFFSET_TYPE      (1U)
+#define RECORD_OFFSET_SENSOR_ID (2U)
+#define RECORD_OFFSET_SEQUENCE  (4U)
+#define RECORD_OFFSET_TIMESTAMP (8U)
+#define RECORD_OFFSET_IN_COUNT  (16U)
+#define RECORD_OFFSET_OUT_COUNT (20U)
+#define RECORD_OFFSET_FLAGS     (24U)
+#define RECORD_OFFSET_CRC       (28U)
+
+/*******************************************************************************
+ * Function Name: record_put
+ ********************************************************************************
+ * Summary:
+ *   Stores a value little endian.
+ *
+ * Parameters:
+ *   buffer: destination
+ *   value: value
+ *   size: number of bytes
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void record_put(uint8_t *buffer, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        buffer[i] = (uint8_t)(value >> (8U * i));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: record_get
+ ********************************************************************************
+ * Summary:
+ *   Loads a little endian value.
+ *
+ * Parameters:
+ *   buffer: source
+ *   size: number of bytes
+ *
+ * Return:
+ *   value
+ *******************************************************************************/
+static uint64_t record_get(const uint8_t *buffer, size_t size)
+{
+    uint64_t value = 0;
+
+    for (size_t i = size; i > 0U; i--)
+    {
+        value = (value << 8) | buffer[i - 1U];
+    }
+    return value;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_record_encode
+ ********************************************************************************
+ * Summary:
+ *   Encodes a record.
+ *
+ * Parameters:
+ *   record: record to encode
+ *   buffer: destination
+ *   size: size of the destination
+ *
+ * Return:
+ *   RADAR_EVENT_RECORD_SIZE, 0 if the destination is too small
+ *******************************************************************************/
+size_t radar_event_record_encode(const radar_event_record_t *record, uint8_t *buffer, size_t size)
+{
+    if (size < RADAR_EVENT_RECORD_SIZE)
+    {
+        return 0U;
+    }
+
+    record_put(&buffer[RECORD_OFFSET_VERSION], RADAR_EVENT_RECORD_VERSION, 1U);
+    record_put(&buffer[RECORD_OFFSET_TYPE], (uint64_t)record->type, 1U);
+    record_put(&buffer[RECORD_OFFSET_SENSOR_ID], record->sensor_id, 2U);
+    record_put(&buffer[RECORD_OFFSET_SEQUENCE], record->sequence, 4U);
+    record_put(&buffer[RECORD_OFFSET_TIMESTAMP], record->timestamp_us, 8U);
+    record_put(&buffer[RECORD_OFFSET_IN_COUNT], record->in_count, 4U);
+    record_put(&buffer[RECORD_OFFSET_OUT_COUNT], record->out_count, 4U);
+    record_put(&buffer[RECORD_OFFSET_FLAGS], record->flags, 4U);
+    record_put(&buffer[RECORD_OFFSET_CRC], radar_crc32(0U, buffer, RECORD_OFFSET_CRC), 4U);
+    return RADAR_EVENT_RECORD_SIZE;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_record_decode
+ ********************************************************************************
+ * Summary:
+ *   Checks and decodes a record.
+ *
+ * Parameters:
+ *   buffer: encoded record
+ *   length: number of bytes available
+ *   record: decoded record, only valid with RADAR_EVENT_RECORD_OK
+ *
+ * Return:
+ *   result of the checks
+ *******************************************************************************/
+radar_event_record_status_t radar_event_record_decode(const uint8_t *buffer,
+                                                      size_t length,
+                                                      radar_event_record_t *record)
+{
+    if (length < RADAR_EVENT_RECORD_SIZE)
+    {
+        return RADAR_EVENT_RECORD_ERR_LENGTH;
+    }
+    if (buffer[RECORD_OFFSET_VERSION] != RADAR_EVENT_RECORD_VERSION)
+    {
+        return RADAR_EVENT_RECORD_ERR_VERSION;
+    }
+    if ((uint32_t)record_get(&buffer[RECORD_OFFSET_CRC], 4U) != radar_crc32(0U, buffer, RECORD_OFFSET_CRC))
+    {
+        return RADAR_EVENT_RECORD_ERR_CRC;
+    }
+
+    record->type = (radar_event_record_type_t)buffer[RECORD_OFFSET_TYPE];
+    record->sensor_id = (uint16_t)record_get(&buffer[RECORD_OFFSET_SENSOR_ID], 2U);
+    record->sequence = (uint32_t)record_get(&buffer[RECORD_OFFSET_SEQUENCE], 4U);
+    record->timestamp_us = record_get(&buffer[RECORD_OFFSET_TIMESTAMP], 8U);
+    record->in_count = (uint32_t)record_get(&buffer[RECORD_OFFSET_IN_COUNT], 4U);
+    record->out_count = (uint32_t)record_get(&buffer[RECORD_OFFSET_OUT_COUNT], 4U);
+    record->flags = (uint32_t)record_get(&buffer[RECORD_OFFSET_FLAGS], 4U);
+    return RADAR_EVENT_RECORD_OK;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_record_tracker_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the sequence number tracking of a sensor.
+ *
+ * Parameters:
+ *   tracker: tracking state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_event_record_tracker_init(radar_event_record_tracker_t *tracker)
+{
+    tracker->started = false;
+    tracker->next_sequence = 0U;
+    tracker->gaps = 0U;
+    tracker->lost = 0U;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_record_track
+ ********************************************************************************
+ * Summary:
+ *   Checks the sequence number of the next record of a sensor. Sequence
+ *   numbers wrap at 2^32. A record older than expected, e.g. a duplicate,
+ *   restarts tracking without counting a gap.
+ *
+ * Parameters:
+ *   tracker: tracking state
+ *   record: next record
+ *
+ * Return:
+ *   number of records missing in front of this one
+ *******************************************************************************/
+uint32_t radar_event_record_track(radar_event_record_tracker_t *tracker, const radar_event_record_t *record)
+{
+    uint32_t missing = 0U;
+
+    if (tracker->started)
+    {
+        uint32_t distance = record->sequence - tracker->next_sequence;
+        /* Distances in the upper half are records from the past */
+        if ((distance > 0U) && (distance < 0x80000000UL))
+        {
+            missing = distance;
+            tracker->gaps++;
+            tracker->lost += missing;
+        }
+    }
+    tracker->started = true;
+    tracker->next_sequence = record->sequence + 1U;
+    return missing;
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+** File name: radar_event_record.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_event_record.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* This header and radar_event_record.c only depend on the C standard library
+ * and radar_crc.c, so host tools can use them to decode records. */
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Version of the record layout below */
+#define RADAR_EVENT_RECORD_VERSION (1U)
+/* Size of an encoded record in bytes */
+#define RADAR_EVENT_RECORD_SIZE (32U)
+/* Timestamp in the timebase of the gateway reference clock instead of the
+ * time since startup of the sensor */
+#define RADAR_EVENT_RECORD_FLAG_SYNCED (1UL << 0)
+
+/* Encoded record, all fields little endian:
+ *
+ * offset size field
+ *      0    1 version
+ *      1    1 type (radar_event_record_type_t)
+ *      2    2 sensor id
+ *      4    4 sequence number
+ *      8    8 timestamp in microseconds
+ *     16    4 in count
+ *     20    4 out count
+ *     24    4 flags (RADAR_EVENT_RECORD_FLAG_*), 0 in older records
+ *     28    4 CRC-32 of bytes 0 to 27
+ */
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Event types, independent of the RadarSensing library enumeration */
+typedef enum
+{
+    RADAR_EVENT_RECORD_TYPE_IN = 1,
+    RADAR_EVENT_RECORD_TYPE_OUT = 2,
+    RADAR_EVENT_RECORD_TYPE_OCCUPIED = 3,
+    RADAR_EVENT_RECORD_TYPE_FREE = 4
+} radar_event_record_type_t;
+
+/* Decoded record */
+typedef struct
+{
+    radar_event_record_type_t type;
+    uint16_t sensor_id;
+    uint32_t sequence;
+    uint64_t timestamp_us;
+    uint32_t in_count;
+    uint32_t out_count;
+    uint32_t flags;
+} radar_event_record_t;
+
+/* Result of decoding a record */
+typedef enum
+{
+    RADAR_EVENT_RECORD_OK,
+    RADAR_EVENT_RECORD_ERR_LENGTH,  // fewer than RADAR_EVENT_RECORD_SIZE bytes
+    RADAR_EVENT_RECORD_ERR_VERSION, // unknown layout version
+    RADAR_EVENT_RECORD_ERR_CRC      // corrupted record
+} radar_event_record_status_t;
+
+/* Sequence number tracking of one sensor */
+typedef struct
+{
+    bool started;           // a record was tracked
+    uint32_t next_sequence; // expected sequence number
+    uint32_t gaps;          // number of gaps
+    uint32_t lost;          // records missing in all gaps
+} radar_event_record_tracker_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+size_t radar_event_record_encode(const radar_event_record_t *record, uint8_t *buffer, size_t size);
+radar_event_record_status_t radar_event_record_decode(const uint8_t *buffer,
+                                                      size_t length,
+                                                      radar_event_record_t *record);
+void radar_event_record_tracker_init(radar_event_record_tracker_t *tracker);
+uint32_t radar_event_record_track(radar_event_record_tracker_t *tracker, const radar_event_record_t *record);
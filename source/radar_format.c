@@ -0,0 +1,268 @@
+/*****************************************************************************
+** File name: radar_format.c
+**
+** Description: This file implements integer-only formatting of numbers and
+** timestamps for terminal output, so that no floating point printf support
+** is needed.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_format.h"
+
+/*******************************************************************************
+ * Function Name: radar_format_digits
+ ********************************************************************************
+ * Summary:
+ *   Writes a number with a minimum number of digits, padded with zeros.
+ *
+ * Parameters:
+ *   buffer: destination
+ *   size: size of the destination
+ *   value: number
+ *   min_digits: minimum number of digits
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+static size_t radar_format_digits(char *buffer, size_t size, uint64_t value, int min_digits)
+{
+    char digits[20];
+    int count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while ((value != 0U) || (count < min_digits));
+
+    size_t length = 0;
+    if (size == 0U)
+    {
+        return 0;
+    }
+    while ((count > 0) && (length < (size - 1U)))
+    {
+        buffer[length++] = digits[--count];
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: radar_format_string
+ ********************************************************************************
+ * Summary:
+ *   Copies a string.
+ *
+ * Parameters:
+ *   buffer: destination
+ *   size: size of the destination
+ *   text: string to be copied
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+size_t radar_format_string(char *buffer, size_t size, const char *text)
+{
+    size_t length = 0;
+
+    if (size == 0U)
+    {
+        return 0;
+    }
+    while ((text[length] != '\0') && (length < (size - 1U)))
+    {
+        buffer[length] = text[length];
+        length++;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: radar_format_uint
+ ********************************************************************************
+ * Summary:
+ *   Writes an unsigned decimal number.
+ *
+ * Parameters:
+ *   buffer: destination
+ *   size: size of the destination
+ *   value: number
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+size_t radar_format_uint(char *buffer, size_t size, uint64_t value)
+{
+    return radar_format_digits(buffer, size, value, 1);
+}
+
+/*******************************************************************************
+ * Function Name: radar_format_int
+ ********************************************************************************
+ * Summary:
+ *   Writes a signed decimal number.
+ *
+ * Parameters:
+ *   buffer: destination
+ *   size: size of the destination
+ *   value: number
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+size_t radar_format_int(char *buffer, size_t size, int64_t value)
+{
+    if (value >= 0)
+    {
+        return radar_format_digits(buffer, size, (uint64_t)value, 1);
+    }
+
+    size_t length = radar_format_string(buffer, size, "-");
+    return length + radar_format_digits(buffer + length, size - length, (uint64_t)0 - (uint64_t)value, 1);
+}
+
+/*******************************************************************************
+ * Function Name: radar_format_timestamp
+ ********************************************************************************
+ * Summary:
+ *   Writes a time in ms as seconds with two decimals, rounded to the
+ *   nearest centisecond, e.g. 12345 ms as "12.35".
+ *
+ * Parameters:
+ *   buffer: destination
+ *   size: size of the destination
+ *   time_ms: time in ms
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+size_t radar_format_timestamp(char *buffer, size_t size, uint64_t time_ms)
+{
+    uint64_t centiseconds = (time_ms + 5U) / 10U;
+
+    size_t length = radar_format_digits(buffer, size, centiseconds / 100U, 1);
+    length += radar_format_string(buffer + length, size - length, ".");
+    length += radar_format_digits(buffer + length, size - length, centiseconds % 100U, 2);
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: radar_format_fixed
+ ********************************************************************************
+ * Summary:
+ *   Writes a number given in thousandths with trailing zero decimals
+ *   removed, keeping at least one decimal, e.g. 1250 as "1.25" and 500 as
+ *   "0.5".
+ *
+ * Parameters:
+ *   buffer: destination
+ *   size: size of the destination
+ *   thousandths: number in thousandths
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+size_t radar_format_fixed(char *buffer, size_t size, int32_t thousandths)
+{
+    size_t length = 0;
+    uint32_t magnitude = (uint32_t)thousandths;
+
+    if (thousandths < 0)
+    {
+        length = radar_format_string(buffer, size, "-");
+        magnitude = 0U - magnitude;
+    }
+
+    uint32_t fraction = magnitude % 1000U;
+    int decimals = 3;
+    while ((decimals > 1) && ((fraction % 10U) == 0U))
+    {
+        fraction /= 10U;
+        decimals--;
+    }
+
+    length += radar_format_digits(buffer + length, size - length, magnitude / 1000U, 1);
+    length += radar_format_string(buffer + length, size - length, ".");
+    length += radar_format_digits(buffer + length, size - length, fraction, decimals);
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: radar_format_parse_fixed
+ ********************************************************************************
+ * Summary:
+ *   Converts a decimal number like "1", "1.25" or ".5" into thousandths, the
+ *   inverse of radar_format_fixed. Digits beyond the third decimal place are
+ *   ignored. Numbers whose integer part exceeds (INT32_MAX - 999) / 1000 are
+ *   rejected, so that the result always fits into an int32_t.
+ *
+ * Parameters:
+ *   text: decimal number
+ *   thousandths: number in thousandths
+ *
+ * Return:
+ *   true if text is a valid number
+ *******************************************************************************/
+bool radar_format_parse_fixed(const char *text, int32_t *thousandths)
+{
+    int32_t integer = 0;
+    int32_t fraction = 0;
+    int32_t scale = 100;
+    bool negative = false;
+    bool digits = false;
+
+    if (*text == '-')
+    {
+        negative = true;
+        text++;
+    }
+    for (; (*text >= '0') && (*text <= '9'); text++)
+    {
+        integer = (integer * 10) + (*text - '0');
+        if (integer > ((INT32_MAX - 999) / 1000))
+        {
+            return false;
+        }
+        digits = true;
+    }
+    if (*text == '.')
+    {
+        for (text++; (*text >= '0') && (*text <= '9'); text++)
+        {
+            fraction += (*text - '0') * scale;
+            scale /= 10;
+            digits = true;
+        }
+    }
+    if (!digits || (*text != '\0'))
+    {
+        return false;
+    }
+
+    *thousandths = (integer * 1000) + fraction;
+    if (negative)
+    {
+        *thousandths = -*thousandths;
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+** File name: radar_format.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_format.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+/* All functions write at most size - 1 characters followed by a terminating
+ * null character and return the number of characters written. They can be
+ * chained by advancing the buffer by the returned length. */
+size_t radar_format_string(char *buffer, size_t size, const char *text);
+size_t radar_format_uint(char *buffer, size_t size, uint64_t value);
+size_t radar_format_int(char *buffer, size_t size, int64_t value);
+size_t radar_format_timestamp(char *buffer, size_t size, uint64_t time_ms);
+size_t radar_format_fixed(char *buffer, size_t size, int32_t thousandths);
+
+/* Inverse of radar_format_fixed, false if text is no number or out of the
+ * int32_t range. */
+bool radar_format_parse_fixed(const char *text, int32_t *thousandths);
@@ -0,0 +1,179 @@
+/*****************************************************************************
+** File name: radar_history.c
+**
+** Description: This file implements the export of the event journal as compressed
+** chunks: timestamps and counts are delta encoded as varints, and each
+** chunk is checked with a CRC-32 and sent as a base64 line.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdio.h>
+
+/* Header file for local module */
+#include "radar_counter_task.h"
+#include "radar_event_bus.h"
+#include "radar_history.h"
+#include "radar_journal.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Chunk line: "X " prefix, base64 of the largest chunk, CR LF and terminator */
+#define HISTORY_LINE_MAXLENGTH (2U + (((RADAR_HISTORY_CHUNK_MAXSIZE + 2U) / 3U) * 4U) + 3U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* State of an export in progress */
+typedef struct
+{
+    radar_history_chunk_t chunk;
+    radar_history_stats_t *stats;
+} history_export_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Export state and line buffer, too large for the terminal UI stack */
+static history_export_t history_export;
+static char history_line[HISTORY_LINE_MAXLENGTH];
+
+/*******************************************************************************
+ * Function Name: history_send_chunk
+ ********************************************************************************
+ * Summary:
+ *   Sends a finished chunk as "X <base64>" line.
+ *
+ * Parameters:
+ *   export: export state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void history_send_chunk(history_export_t *export)
+{
+    static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const uint8_t *data = export->chunk.buffer;
+    size_t size = radar_history_chunk_finish(&export->chunk);
+    size_t length = 0;
+
+    history_line[length++] = 'X';
+    history_line[length++] = ' ';
+    for (size_t i = 0; i < size; i += 3U)
+    {
+        uint32_t group = (uint32_t)data[i] << 16;
+        if ((i + 1U) < size)
+        {
+            group |= (uint32_t)data[i + 1U] << 8;
+        }
+        if ((i + 2U) < size)
+        {
+            group |= data[i + 2U];
+        }
+        history_line[length++] = base64[(group >> 18) & 0x3FU];
+        history_line[length++] = base64[(group >> 12) & 0x3FU];
+        history_line[length++] = ((i + 1U) < size) ? base64[(group >> 6) & 0x3FU] : '=';
+        history_line[length++] = ((i + 2U) < size) ? base64[group & 0x3FU] : '=';
+    }
+    history_line[length++] = '\r';
+    history_line[length++] = '\n';
+    history_line[length] = '\0';
+    printf("%s", history_line);
+
+    export->stats->chunks++;
+    export->stats->bytes += (uint32_t)length;
+}
+
+/*******************************************************************************
+ * Function Name: history_export_record
+ ********************************************************************************
+ * Summary:
+ *   Journal reader that adds a record to the current chunk and sends the
+ *   chunk once it is full. Also counts the length of the event message that
+ *   the console prints for the same event.
+ *
+ * Parameters:
+ *   record: record read from the journal
+ *   arg: export state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void history_export_record(const radar_event_record_t *record, void *arg)
+{
+    history_export_t *export = (history_export_t *)arg;
+    radar_counter_event_t event;
+    char line[RADAR_COUNTER_LINE_MAXLENGTH];
+
+    /* The first record of a chunk always fits */
+    if ((export->stats->records == 0U) || !radar_history_chunk_add(&export->chunk, record))
+    {
+        if (export->stats->records > 0U)
+        {
+            history_send_chunk(export);
+        }
+        radar_history_chunk_init(&export->chunk, record);
+        (void)radar_history_chunk_add(&export->chunk, record);
+    }
+    export->stats->records++;
+
+    radar_event_bus_from_record(record, &event);
+    export->stats->text_bytes += (uint32_t)radar_counter_task_format_event(&event, line, sizeof(line));
+}
+
+/*******************************************************************************
+ * Function Name: radar_history_export
+ ********************************************************************************
+ * Summary:
+ *   Sends the journal records from a sequence number on as chunk lines,
+ *   followed by "X END <records> <next sequence>". A host that receives a
+ *   chunk with a wrong CRC resumes the export at the sequence number
+ *   following the last good chunk.
+ *
+ * Parameters:
+ *   since_sequence: first sequence number to send
+ *   stats: export statistics
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_history_export(uint32_t since_sequence, radar_history_stats_t *stats)
+{
+    stats->records = 0U;
+    stats->chunks = 0U;
+    stats->bytes = 0U;
+    stats->text_bytes = 0U;
+    history_export.stats = stats;
+
+    (void)radar_journal_read(since_sequence, history_export_record, &history_export);
+    if (stats->records > 0U)
+    {
+        history_send_chunk(&history_export);
+    }
+
+    int length = printf("X END %lu %lu\r\n",
+                        (unsigned long)stats->records,
+                        (unsigned long)((stats->records > 0U) ? history_export.chunk.next_sequence : since_sequence));
+    if (length > 0)
+    {
+        stats->bytes += (uint32_t)length;
+    }
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+** File name: radar_history.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_history.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Header file for local module */
+#include "radar_event_record.h"
+
+/* The chunk functions in radar_history_chunk.c only depend on the C
+ * standard library and radar_crc.c, so the encoding can be run on the host. */
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Version of the chunk layout below */
+#define RADAR_HISTORY_VERSION (1U)
+/* Maximum number of records per chunk */
+#define RADAR_HISTORY_CHUNK_RECORDS (32U)
+/* Maximum encoded size of a chunk header, a record and the CRC */
+#define RADAR_HISTORY_HEADER_MAXSIZE (2U + 5U + 10U + 5U + 5U)
+#define RADAR_HISTORY_RECORD_MAXSIZE (1U + 5U + 10U + 5U + 5U)
+/* Size of a chunk buffer that holds any chunk */
+#define RADAR_HISTORY_CHUNK_MAXSIZE \
+    (RADAR_HISTORY_HEADER_MAXSIZE + (RADAR_HISTORY_CHUNK_RECORDS * RADAR_HISTORY_RECORD_MAXSIZE) + 4U)
+
+/* Encoded chunk, varint is unsigned LEB128, zigzag maps signed to unsigned:
+ *
+ * field                 encoding
+ * version               1 byte
+ * number of records     1 byte
+ * first sequence        varint
+ * base timestamp ms     varint
+ * base in count         varint
+ * base out count        varint
+ * records               see below
+ * CRC-32                4 bytes little endian, of all preceding bytes
+ *
+ * Each record is encoded relative to the previous one, the first one
+ * relative to the base values and the first sequence number:
+ *
+ * tag                   1 byte: bits 0-2 type, bit 3 sequence gap,
+ *                       bit 4 explicit counts, bit 5 timestamp in the
+ *                       gateway timebase (RADAR_EVENT_RECORD_FLAG_SYNCED)
+ * gap                   varint, only with bit 3: sequence - expected
+ * timestamp delta ms    varint
+ * in count delta        zigzag varint, only with bit 4
+ * out count delta       zigzag varint, only with bit 4
+ *
+ * Without bit 4, an IN record increments the in count, an OUT record the
+ * out count, and OCCUPIED and FREE records keep both counts.
+ *
+ * Timestamp deltas are never negative and all records of a chunk share
+ * the timebase of bit 5: a record with an older timestamp, e.g. after a
+ * reset, or in the other timebase starts a new chunk.
+ */
+#define RADAR_HISTORY_TAG_TYPE_MASK (0x07U)
+#define RADAR_HISTORY_TAG_GAP       (0x08U)
+#define RADAR_HISTORY_TAG_COUNTS    (0x10U)
+#define RADAR_HISTORY_TAG_SYNCED    (0x20U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Chunk being encoded */
+typedef struct
+{
+    uint8_t buffer[RADAR_HISTORY_CHUNK_MAXSIZE];
+    size_t length;
+    uint32_t records;
+    uint32_t next_sequence; // expected sequence number of the next record
+    uint64_t timestamp_ms;  // timestamp of the previous record
+    uint32_t flags;         // RADAR_EVENT_RECORD_FLAG_SYNCED of all records
+    uint32_t in_count;      // counts after the previous record
+    uint32_t out_count;
+} radar_history_chunk_t;
+
+/* Export statistics */
+typedef struct
+{
+    uint32_t records;
+    uint32_t chunks;
+    uint32_t bytes;      // bytes sent, including line framing
+    uint32_t text_bytes; // bytes of the same events as text messages
+} radar_history_stats_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_history_chunk_init(radar_history_chunk_t *chunk, const radar_event_record_t *first);
+bool radar_history_chunk_add(radar_history_chunk_t *chunk, const radar_event_record_t *record);
+size_t radar_history_chunk_finish(radar_history_chunk_t *chunk);
+void radar_history_export(uint32_t since_sequence, radar_history_stats_t *stats);
@@ -0,0 +1,227 @@
+/*****************************************************************************
+** File name: radar_history_chunk.c
+**
+** Description: This file implements the encoding of event records into the
+** compressed chunks of the history export, without any hardware access.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_crc.h"
+#include "radar_history.h"
+
+/*******************************************************************************
+ * Function Name: history_put_varint
+ ********************************************************************************
+ * Summary:
+ *   Appends an unsigned LEB128 varint to the chunk.
+ *
+ * Parameters:
+ *   chunk: chunk
+ *   value: value
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void history_put_varint(radar_history_chunk_t *chunk, uint64_t value)
+{
+    while (value >= 0x80U)
+    {
+        chunk->buffer[chunk->length++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    chunk->buffer[chunk->length++] = (uint8_t)value;
+}
+
+/*******************************************************************************
+ * Function Name: history_zigzag
+ ********************************************************************************
+ * Summary:
+ *   Maps the difference of two counts to an unsigned value, small
+ *   differences of either sign give small values.
+ *
+ * Parameters:
+ *   value: count
+ *   previous: previous count
+ *
+ * Return:
+ *   zigzag encoded difference
+ *******************************************************************************/
+static uint32_t history_zigzag(uint32_t value, uint32_t previous)
+{
+    int32_t delta = (int32_t)(value - previous);
+    return ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+}
+
+/*******************************************************************************
+ * Function Name: history_implied_counts
+ ********************************************************************************
+ * Summary:
+ *   Gets the counts a record has if its tag has no explicit counts.
+ *
+ * Parameters:
+ *   type: record type
+ *   in_count: in count before the record, updated
+ *   out_count: out count before the record, updated
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void history_implied_counts(radar_event_record_type_t type, uint32_t *in_count, uint32_t *out_count)
+{
+    if (type == RADAR_EVENT_RECORD_TYPE_IN)
+    {
+        (*in_count)++;
+    }
+    else if (type == RADAR_EVENT_RECORD_TYPE_OUT)
+    {
+        (*out_count)++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_history_chunk_init
+ ********************************************************************************
+ * Summary:
+ *   Starts a chunk. The base values are chosen so that the first record
+ *   needs no explicit counts.
+ *
+ * Parameters:
+ *   chunk: chunk
+ *   first: first record of the chunk
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_history_chunk_init(radar_history_chunk_t *chunk, const radar_event_record_t *first)
+{
+    chunk->records = 0U;
+    chunk->next_sequence = first->sequence;
+    chunk->timestamp_ms = first->timestamp_us / 1000U;
+    chunk->flags = first->flags & RADAR_EVENT_RECORD_FLAG_SYNCED;
+    chunk->in_count = first->in_count;
+    chunk->out_count = first->out_count;
+    if ((first->type == RADAR_EVENT_RECORD_TYPE_IN) && (chunk->in_count > 0U))
+    {
+        chunk->in_count--;
+    }
+    else if ((first->type == RADAR_EVENT_RECORD_TYPE_OUT) && (chunk->out_count > 0U))
+    {
+        chunk->out_count--;
+    }
+
+    chunk->buffer[0] = RADAR_HISTORY_VERSION;
+    chunk->buffer[1] = 0U; // number of records, set by radar_history_chunk_finish
+    chunk->length = 2U;
+    history_put_varint(chunk, chunk->next_sequence);
+    history_put_varint(chunk, chunk->timestamp_ms);
+    history_put_varint(chunk, chunk->in_count);
+    history_put_varint(chunk, chunk->out_count);
+}
+
+/*******************************************************************************
+ * Function Name: radar_history_chunk_add
+ ********************************************************************************
+ * Summary:
+ *   Appends a record to a chunk. Timestamps are reduced to milliseconds and
+ *   encoded as deltas, so a record older than the previous one, e.g. the
+ *   first record after a reset, or a record in the other timebase does not
+ *   fit and has to start a new chunk, whose base timestamp is absolute.
+ *
+ * Parameters:
+ *   chunk: chunk
+ *   record: record
+ *
+ * Return:
+ *   false if the chunk is full or the record has to start a new chunk
+ *******************************************************************************/
+bool radar_history_chunk_add(radar_history_chunk_t *chunk, const radar_event_record_t *record)
+{
+    uint64_t timestamp_ms = record->timestamp_us / 1000U;
+    uint32_t in_count = chunk->in_count;
+    uint32_t out_count = chunk->out_count;
+    uint8_t tag = (uint8_t)record->type & RADAR_HISTORY_TAG_TYPE_MASK;
+
+    if (chunk->records == RADAR_HISTORY_CHUNK_RECORDS)
+    {
+        return false;
+    }
+    if ((timestamp_ms < chunk->timestamp_ms) ||
+        ((record->flags & RADAR_EVENT_RECORD_FLAG_SYNCED) != chunk->flags))
+    {
+        return false;
+    }
+
+    history_implied_counts(record->type, &in_count, &out_count);
+    if (record->sequence != chunk->next_sequence)
+    {
+        tag |= RADAR_HISTORY_TAG_GAP;
+    }
+    if ((record->in_count != in_count) || (record->out_count != out_count))
+    {
+        tag |= RADAR_HISTORY_TAG_COUNTS;
+    }
+    if (chunk->flags != 0U)
+    {
+        tag |= RADAR_HISTORY_TAG_SYNCED;
+    }
+
+    chunk->buffer[chunk->length++] = tag;
+    if ((tag & RADAR_HISTORY_TAG_GAP) != 0U)
+    {
+        history_put_varint(chunk, record->sequence - chunk->next_sequence);
+    }
+    history_put_varint(chunk, timestamp_ms - chunk->timestamp_ms);
+    if ((tag & RADAR_HISTORY_TAG_COUNTS) != 0U)
+    {
+        history_put_varint(chunk, history_zigzag(record->in_count, chunk->in_count));
+        history_put_varint(chunk, history_zigzag(record->out_count, chunk->out_count));
+    }
+
+    chunk->records++;
+    chunk->next_sequence = record->sequence + 1U;
+    chunk->timestamp_ms = timestamp_ms;
+    chunk->in_count = record->in_count;
+    chunk->out_count = record->out_count;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_history_chunk_finish
+ ********************************************************************************
+ * Summary:
+ *   Completes a chunk with the number of records and the CRC.
+ *
+ * Parameters:
+ *   chunk: chunk
+ *
+ * Return:
+ *   length of the encoded chunk
+ *******************************************************************************/
+size_t radar_history_chunk_finish(radar_history_chunk_t *chunk)
+{
+    chunk->buffer[1] = (uint8_t)chunk->records;
+    uint32_t crc = radar_crc32(0U, chunk->buffer, chunk->length);
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        chunk->buffer[chunk->length++] = (uint8_t)(crc >> (8U * i));
+    }
+    return chunk->length;
+}
@@ -0,0 +1,567 @@
+/*****************************************************************************
+** File name: radar_journal.c
+**
+** Description: This file implements an append-only journal of binary event records
+** in the emulated EEPROM region of the flash. Records are collected in
+** RAM and written one flash row at a time by the journal task.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "radar_clock.h"
+#include "radar_crc.h"
+#include "radar_event_bus.h"
+#include "radar_journal.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+#define JOURNAL_PAGE_MAGIC (0x4C4E524AUL) // "JRNL"
+#define JOURNAL_PAGE_SIZE (CY_FLASH_SIZEOF_ROW)
+/* Records queued for the journal by the event bus */
+#define JOURNAL_SINK_LENGTH (8U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Flash row. The CRC is the commit marker: a row whose write was cut short
+ * by a reset or power loss fails the CRC check and is ignored. */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t page_number;  // increments with every page written
+    uint32_t record_count;
+    uint8_t records[RADAR_JOURNAL_RECORDS_PER_PAGE * RADAR_EVENT_RECORD_SIZE];
+    uint8_t reserved[JOURNAL_PAGE_SIZE - 16U - (RADAR_JOURNAL_RECORDS_PER_PAGE * RADAR_EVENT_RECORD_SIZE)];
+    uint32_t crc;          // CRC-32 of all preceding bytes
+} radar_journal_page_t;
+
+_Static_assert(sizeof(radar_journal_page_t) == JOURNAL_PAGE_SIZE, "journal page must fill a flash row");
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Journal rows in the emulated EEPROM region, erased by programming. The
+ * compiler sees a constant array of zeros, so the rows are only read through
+ * journal_rows: loaded from a volatile pointer, the address is opaque and
+ * reads of programmed rows cannot be folded, e.g. with link time
+ * optimization. */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(JOURNAL_PAGE_SIZE)
+static const uint8_t journal_flash[RADAR_JOURNAL_PAGES * JOURNAL_PAGE_SIZE] = {0};
+static const uint8_t *volatile const journal_rows = journal_flash;
+
+static cyhal_flash_t journal_flash_obj;
+static radar_event_bus_sink_t journal_sink;
+static uint8_t journal_sink_storage[RADAR_EVENT_BUS_SINK_STORAGE_SIZE(JOURNAL_SINK_LENGTH)];
+
+/* Two page buffers: one is filled by the event bus while the other is
+ * written to flash by the journal task. The buffer indexes and the record
+ * count of the buffer being filled change in critical sections, so that
+ * neither side waits for the other. */
+static radar_journal_page_t journal_buffers[2];
+static uint32_t journal_fill = 0;        // index of the buffer being filled
+static bool journal_full = false;        // the other buffer waits to be written
+static cy_semaphore_t journal_semaphore; // signals a full page
+
+/* Flash state, only changed by the journal task after init */
+static uint32_t journal_head = 0;        // row of the newest valid page
+static uint32_t journal_page_number = 0; // page number of the newest valid page
+static bool journal_empty = true;        // no valid page in flash
+static bool journal_partial = false;     // the head row holds the first records of the next page
+static uint32_t journal_flushed = 0;     // records of the next page to be written already in flash
+static radar_journal_page_t journal_flush_page; // copy of a page that is not full yet
+static radar_journal_stats_t journal_stats;
+
+/*******************************************************************************
+ * Function Name: radar_journal_page
+ ********************************************************************************
+ * Summary:
+ *   Gets a flash row of the journal.
+ *
+ * Parameters:
+ *   row: row index
+ *
+ * Return:
+ *   row contents, read directly from flash
+ *******************************************************************************/
+static const radar_journal_page_t *radar_journal_page(uint32_t row)
+{
+    return (const radar_journal_page_t *)&journal_rows[row * JOURNAL_PAGE_SIZE];
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_page_valid
+ ********************************************************************************
+ * Summary:
+ *   Checks whether a page was written completely.
+ *
+ * Parameters:
+ *   page: page to check
+ *
+ * Return:
+ *   true if the commit marker is valid
+ *******************************************************************************/
+static bool radar_journal_page_valid(const radar_journal_page_t *page)
+{
+    return (page->magic == JOURNAL_PAGE_MAGIC) && (page->record_count <= RADAR_JOURNAL_RECORDS_PER_PAGE) &&
+           (page->crc == radar_crc32(0U, page, offsetof(radar_journal_page_t, crc)));
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_last_sequence
+ ********************************************************************************
+ * Summary:
+ *   Gets the sequence number of the last record of a page.
+ *
+ * Parameters:
+ *   page: valid page with at least one record
+ *   sequence: sequence number
+ *
+ * Return:
+ *   false if the record is corrupted
+ *******************************************************************************/
+static bool radar_journal_last_sequence(const radar_journal_page_t *page, uint32_t *sequence)
+{
+    radar_event_record_t record;
+
+    if (radar_event_record_decode(&page->records[(page->record_count - 1U) * RADAR_EVENT_RECORD_SIZE],
+                                  RADAR_EVENT_RECORD_SIZE,
+                                  &record) != RADAR_EVENT_RECORD_OK)
+    {
+        return false;
+    }
+    *sequence = record.sequence;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_scan
+ ********************************************************************************
+ * Summary:
+ *   Finds the newest valid page and counts the valid pages and records.
+ *   Rows are memory mapped, so the scan only reads the flash.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_journal_scan(void)
+{
+    bool first_found = false;
+    uint32_t first_page_number = 0;
+    uint32_t first_row = 0;
+
+    journal_empty = true;
+    journal_stats.pages = 0;
+    journal_stats.records = 0;
+    for (uint32_t row = 0; row < RADAR_JOURNAL_PAGES; row++)
+    {
+        const radar_journal_page_t *page = radar_journal_page(row);
+        if (!radar_journal_page_valid(page))
+        {
+            continue;
+        }
+        journal_stats.pages++;
+        journal_stats.records += page->record_count;
+        if (journal_empty || ((int32_t)(page->page_number - journal_page_number) > 0))
+        {
+            journal_head = row;
+            journal_page_number = page->page_number;
+            journal_empty = false;
+        }
+        if (!first_found || ((int32_t)(page->page_number - first_page_number) < 0))
+        {
+            first_row = row;
+            first_page_number = page->page_number;
+            first_found = true;
+        }
+    }
+
+    if (!journal_empty)
+    {
+        radar_event_record_t record;
+        const radar_journal_page_t *first = radar_journal_page(first_row);
+        uint32_t last_sequence;
+
+        if ((first->record_count > 0U) &&
+            (radar_event_record_decode(first->records, RADAR_EVENT_RECORD_SIZE, &record) == RADAR_EVENT_RECORD_OK))
+        {
+            journal_stats.first_sequence = record.sequence;
+        }
+        if ((radar_journal_page(journal_head)->record_count > 0U) &&
+            radar_journal_last_sequence(radar_journal_page(journal_head), &last_sequence))
+        {
+            journal_stats.next_sequence = last_sequence + 1U;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_sink
+ ********************************************************************************
+ * Summary:
+ *   Event bus sink that adds an event to the page being filled and hands a
+ *   full page to the journal task. Never touches the flash and never waits
+ *   for the journal task.
+ *
+ * Parameters:
+ *   event: counter event
+ *   arg: unused
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_journal_sink(const radar_counter_event_t *event, void *arg)
+{
+    radar_event_record_t record;
+    uint8_t encoded[RADAR_EVENT_RECORD_SIZE];
+    bool handover = false;
+
+    radar_event_bus_to_record(event, &record);
+    (void)radar_event_record_encode(&record, encoded, sizeof(encoded));
+
+    taskENTER_CRITICAL();
+    radar_journal_page_t *page = &journal_buffers[journal_fill];
+    if (page->record_count == RADAR_JOURNAL_RECORDS_PER_PAGE)
+    {
+        /* Both buffers are full, the flash is too slow */
+        journal_stats.dropped++;
+    }
+    else
+    {
+        memcpy(&page->records[page->record_count * RADAR_EVENT_RECORD_SIZE], encoded, sizeof(encoded));
+        page->record_count++;
+        if ((page->record_count == RADAR_JOURNAL_RECORDS_PER_PAGE) && !journal_full)
+        {
+            journal_full = true;
+            journal_fill ^= 1U;
+            journal_buffers[journal_fill].record_count = 0U;
+            handover = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (handover)
+    {
+        (void)cy_rtos_set_semaphore(&journal_semaphore, false);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_write
+ ********************************************************************************
+ * Summary:
+ *   Writes a page into the row after the newest page, overwriting the
+ *   oldest page once the journal is full, or rewrites the newest page with
+ *   more records.
+ *
+ * Parameters:
+ *   page: page with records, the header is filled in here
+ *   rewrite: true to replace the newest page, which holds the first records
+ *            of this page
+ *
+ * Return:
+ *   true if the page was written
+ *******************************************************************************/
+static bool radar_journal_write(radar_journal_page_t *page, bool rewrite)
+{
+    uint32_t row = journal_empty ? 0U : (rewrite ? journal_head : ((journal_head + 1U) % RADAR_JOURNAL_PAGES));
+    const radar_journal_page_t *overwritten = radar_journal_page(row);
+    bool overwrite_valid = radar_journal_page_valid(overwritten);
+    uint32_t overwritten_records = overwrite_valid ? overwritten->record_count : 0U;
+
+    page->magic = JOURNAL_PAGE_MAGIC;
+    page->page_number = rewrite ? journal_page_number : (journal_page_number + 1U);
+    memset(page->records + (page->record_count * RADAR_EVENT_RECORD_SIZE),
+           0xFF,
+           (RADAR_JOURNAL_RECORDS_PER_PAGE - page->record_count) * RADAR_EVENT_RECORD_SIZE);
+    memset(page->reserved, 0xFF, sizeof(page->reserved));
+    page->crc = radar_crc32(0U, page, offsetof(radar_journal_page_t, crc));
+
+    if (cyhal_flash_write(&journal_flash_obj, (uint32_t)(uintptr_t)overwritten, (const uint32_t *)page) !=
+        CY_RSLT_SUCCESS)
+    {
+        journal_stats.write_errors++;
+        return false;
+    }
+    Cy_SysLib_ClearFlashCacheAndBuffer();
+
+    uint32_t last_sequence;
+    journal_head = row;
+    journal_page_number = page->page_number;
+    journal_empty = false;
+
+    taskENTER_CRITICAL();
+    journal_stats.page_writes++;
+    if (!overwrite_valid)
+    {
+        journal_stats.pages++;
+    }
+    journal_stats.records += page->record_count - overwritten_records;
+    if (radar_journal_last_sequence(page, &last_sequence))
+    {
+        journal_stats.next_sequence = last_sequence + 1U;
+    }
+    taskEXIT_CRITICAL();
+
+    /* A rewritten page starts with the same record, the oldest one stays */
+    if (rewrite)
+    {
+        return true;
+    }
+
+    /* The oldest record is now in the row after the head */
+    if (overwrite_valid)
+    {
+        const radar_journal_page_t *oldest = radar_journal_page((row + 1U) % RADAR_JOURNAL_PAGES);
+        radar_event_record_t record;
+        if (radar_journal_page_valid(oldest) && (oldest->record_count > 0U) &&
+            (radar_event_record_decode(oldest->records, RADAR_EVENT_RECORD_SIZE, &record) == RADAR_EVENT_RECORD_OK))
+        {
+            journal_stats.first_sequence = record.sequence;
+        }
+    }
+    else if (journal_stats.pages == 1U)
+    {
+        radar_event_record_t record;
+        if (radar_event_record_decode(page->records, RADAR_EVENT_RECORD_SIZE, &record) == RADAR_EVENT_RECORD_OK)
+        {
+            journal_stats.first_sequence = record.sequence;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_init
+ ********************************************************************************
+ * Summary:
+ *   Scans the journal rows for the newest valid page and subscribes the
+ *   journal to all counter events. Must be called after the event bus is
+ *   initialized and before the journal task is created.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the initialization
+ *******************************************************************************/
+cy_rslt_t radar_journal_init(void)
+{
+    uint64_t start_us = radar_clock_us();
+
+    cy_rslt_t result = cyhal_flash_init(&journal_flash_obj);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cy_rtos_init_semaphore(&journal_semaphore, 1, 0);
+    }
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    radar_journal_scan();
+    journal_stats.scan_us = (uint32_t)(radar_clock_us() - start_us);
+
+    return radar_event_bus_subscribe(&journal_sink,
+                                     "journal",
+                                     RADAR_EVENT_BUS_FILTER_ALL,
+                                     radar_journal_sink,
+                                     NULL,
+                                     journal_sink_storage,
+                                     sizeof(journal_sink_storage));
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_get_next_sequence
+ ********************************************************************************
+ * Summary:
+ *   Gets the sequence number following the newest record in flash, so that
+ *   sequence numbers continue across resets.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   next sequence number, 0 for an empty journal
+ *******************************************************************************/
+uint32_t radar_journal_get_next_sequence(void)
+{
+    return journal_stats.next_sequence;
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_read
+ ********************************************************************************
+ * Summary:
+ *   Reads the records in flash from the oldest to the newest, skipping
+ *   records older than a sequence number. Records not yet written to flash
+ *   are not read.
+ *
+ * Parameters:
+ *   since_sequence: first sequence number to read
+ *   reader: function called for each record
+ *   arg: argument passed to the reader
+ *
+ * Return:
+ *   number of records read
+ *******************************************************************************/
+uint32_t radar_journal_read(uint32_t since_sequence, radar_journal_reader_t reader, void *arg)
+{
+    uint32_t count = 0;
+    uint32_t head = journal_head;
+
+    if (journal_empty)
+    {
+        return 0U;
+    }
+
+    /* Rows are written in ring order, the oldest follows the newest */
+    for (uint32_t i = 1U; i <= RADAR_JOURNAL_PAGES; i++)
+    {
+        const radar_journal_page_t *page = radar_journal_page((head + i) % RADAR_JOURNAL_PAGES);
+        if (!radar_journal_page_valid(page))
+        {
+            continue;
+        }
+        for (uint32_t j = 0; j < page->record_count; j++)
+        {
+            radar_event_record_t record;
+            if ((radar_event_record_decode(&page->records[j * RADAR_EVENT_RECORD_SIZE],
+                                           RADAR_EVENT_RECORD_SIZE,
+                                           &record) == RADAR_EVENT_RECORD_OK) &&
+                ((int32_t)(record.sequence - since_sequence) >= 0))
+            {
+                reader(&record, arg);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_get_stats
+ ********************************************************************************
+ * Summary:
+ *   Copies the journal statistics.
+ *
+ * Parameters:
+ *   stats: copy of the statistics
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_journal_get_stats(radar_journal_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = journal_stats;
+    stats->pending = journal_buffers[journal_fill].record_count;
+    if (journal_full)
+    {
+        stats->pending += RADAR_JOURNAL_RECORDS_PER_PAGE;
+    }
+    stats->pending -= journal_flushed;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_journal_task
+ ********************************************************************************
+ * Summary:
+ *   Writes full pages to flash as they are handed over by the event bus
+ *   sink. Once RADAR_JOURNAL_FLUSH_MS passed without a page write, the
+ *   records of the page being filled that are not in flash yet are written
+ *   too: the page goes into the next row and is rewritten in that row,
+ *   with all its records, at every later flush and once it is full. Under
+ *   low traffic, rows thus still hold RADAR_JOURNAL_RECORDS_PER_PAGE
+ *   records each. A reset or power loss during a rewrite loses the records
+ *   of that row.
+ *
+ * Parameters:
+ *   arg: thread
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_journal_task(cy_thread_arg_t arg)
+{
+    for (;;)
+    {
+        cy_rslt_t result = cy_rtos_get_semaphore(&journal_semaphore, RADAR_JOURNAL_FLUSH_MS, false);
+
+        /* Copy the records of a page that is not full, the sink keeps
+         * adding records behind them during the write */
+        taskENTER_CRITICAL();
+        bool write = journal_full;
+        const radar_journal_page_t *filling = &journal_buffers[journal_fill];
+        bool flush = !write && (result != CY_RSLT_SUCCESS) && (filling->record_count > journal_flushed);
+        if (flush)
+        {
+            journal_flush_page.record_count = filling->record_count;
+            memcpy(journal_flush_page.records, filling->records, filling->record_count * RADAR_EVENT_RECORD_SIZE);
+        }
+        taskEXIT_CRITICAL();
+
+        if (flush && radar_journal_write(&journal_flush_page, journal_partial))
+        {
+            taskENTER_CRITICAL();
+            journal_partial = true;
+            journal_flushed = journal_flush_page.record_count;
+            taskEXIT_CRITICAL();
+        }
+        if (!write)
+        {
+            continue;
+        }
+
+        /* The sink does not touch the full buffer until it is released, so
+         * the flash write does not block the event bus. A page whose first
+         * records were flushed replaces that row. */
+        (void)radar_journal_write(&journal_buffers[journal_fill ^ 1U], journal_partial);
+
+        taskENTER_CRITICAL();
+        journal_partial = false;
+        journal_flushed = 0U;
+        journal_full = false;
+        bool handover = (journal_buffers[journal_fill].record_count == RADAR_JOURNAL_RECORDS_PER_PAGE);
+        if (handover)
+        {
+            /* The other buffer filled up during the write */
+            journal_full = true;
+            journal_fill ^= 1U;
+            journal_buffers[journal_fill].record_count = 0U;
+        }
+        taskEXIT_CRITICAL();
+        if (handover)
+        {
+            (void)cy_rtos_set_semaphore(&journal_semaphore, false);
+        }
+    }
+}
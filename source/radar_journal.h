@@ -0,0 +1,84 @@
+/******************************************************************************
+** File name: radar_journal.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_journal.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+#include "cyabs_rtos.h"
+
+/* Header file for local module */
+#include "radar_event_record.h"
+#include "radar_sched_profile.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Journal task name */
+#define RADAR_JOURNAL_TASK_NAME "RADAR JOURNAL TASK"
+/* Journal task stack size */
+#define RADAR_JOURNAL_TASK_STACK_SIZE (1024)
+/* Journal task priority */
+#define RADAR_JOURNAL_TASK_PRIORITY (RADAR_SCHED_PRIORITY_JOURNAL)
+
+/* Number of flash rows used by the journal, oldest rows are overwritten */
+#define RADAR_JOURNAL_PAGES (32U)
+/* Event records per flash row */
+#define RADAR_JOURNAL_RECORDS_PER_PAGE (15U)
+/* A page that is not full yet is written after this time without a page
+ * write, and rewritten in the same row until it is full */
+#define RADAR_JOURNAL_FLUSH_MS (60000U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Journal statistics */
+typedef struct
+{
+    uint32_t pages;           // valid pages in flash
+    uint32_t records;         // records in flash
+    uint32_t first_sequence;  // oldest record in flash
+    uint32_t next_sequence;   // sequence number after the newest record
+    uint32_t pending;         // records not yet written to flash
+    uint32_t page_writes;     // pages written since startup
+    uint32_t write_errors;    // failed page writes
+    uint32_t dropped;         // records lost because both page buffers were full
+    uint32_t scan_us;         // duration of the recovery scan at startup
+} radar_journal_stats_t;
+
+/* Called for every record read from the journal */
+typedef void (*radar_journal_reader_t)(const radar_event_record_t *record, void *arg);
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t radar_journal_init(void);
+uint32_t radar_journal_get_next_sequence(void);
+uint32_t radar_journal_read(uint32_t since_sequence, radar_journal_reader_t reader, void *arg);
+void radar_journal_get_stats(radar_journal_stats_t *stats);
+void radar_journal_task(cy_thread_arg_t arg);
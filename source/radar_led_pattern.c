@@ -0,0 +1,187 @@
+/*****************************************************************************
+** File name: radar_led_pattern.c
+**
+** Description: This file implements the LED blink patterns of the entrance
+** counter events as a state machine without any hardware access.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_led_pattern.h"
+
+/*******************************************************************************
+ * Function Name: led_pattern_blink
+ ********************************************************************************
+ * Summary:
+ *   Advances a blink pattern by one tick.
+ *
+ * Parameters:
+ *   blink: blink pattern with a pending pattern
+ *   on_time: RADAR_LED_PATTERN_*_ON_TIME
+ *   off_time: RADAR_LED_PATTERN_*_OFF_TIME
+ *   blink_time: RADAR_LED_PATTERN_*_BLINK_TIME
+ *   color: traffic light color
+ *   output: color to write
+ *
+ * Return:
+ *   true if output is to be written
+ *******************************************************************************/
+static bool led_pattern_blink(radar_led_pattern_blink_t *blink,
+                              uint8_t on_time,
+                              uint8_t off_time,
+                              uint8_t blink_time,
+                              uint32_t color,
+                              uint32_t *output)
+{
+    blink->onoff++;
+    if (blink->onoff < on_time)
+    {
+        *output = color;
+        return true;
+    }
+    if (blink->onoff < off_time)
+    {
+        *output = RADAR_LED_OFF;
+        return true;
+    }
+
+    blink->onoff = 0;
+    if (blink->blinks > blink_time)
+    {
+        /* Pattern complete, resume the traffic light color */
+        blink->pending--;
+        blink->blinks = 0;
+        *output = color;
+        return true;
+    }
+
+    /* Repeat blink */
+    blink->blinks++;
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: radar_led_pattern_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the LED pattern: no blink pending, traffic light not set.
+ *
+ * Parameters:
+ *   pattern: LED pattern state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_led_pattern_init(radar_led_pattern_t *pattern)
+{
+    pattern->zone = RADAR_LED_PATTERN_IDLE;
+    pattern->color = RADAR_LED_GREEN;
+    pattern->in = (radar_led_pattern_blink_t){0};
+    pattern->out = (radar_led_pattern_blink_t){0};
+    pattern->overrides = 0U;
+}
+
+/*******************************************************************************
+ * Function Name: radar_led_pattern_event
+ ********************************************************************************
+ * Summary:
+ *   Sets the LED pattern of a counter event. An IN or OUT event replaces a
+ *   blink pattern still in progress; OCCUPIED and FREE set the traffic light
+ *   color.
+ *
+ * Parameters:
+ *   pattern: LED pattern state
+ *   type: counter event
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_led_pattern_event(radar_led_pattern_t *pattern, radar_event_record_type_t type)
+{
+    if (((type == RADAR_EVENT_RECORD_TYPE_IN) || (type == RADAR_EVENT_RECORD_TYPE_OUT)) &&
+        ((pattern->in.pending > 0U) || (pattern->out.pending > 0U)))
+    {
+        pattern->overrides++;
+    }
+
+    switch (type)
+    {
+        case RADAR_EVENT_RECORD_TYPE_IN:
+            pattern->in.pending = 1U;
+            pattern->out = (radar_led_pattern_blink_t){0};
+            break;
+        case RADAR_EVENT_RECORD_TYPE_OUT:
+            pattern->out.pending = 1U;
+            pattern->in = (radar_led_pattern_blink_t){0};
+            break;
+        case RADAR_EVENT_RECORD_TYPE_OCCUPIED:
+            pattern->zone = RADAR_LED_PATTERN_OCCUPIED;
+            pattern->color = RADAR_LED_RED;
+            break;
+        case RADAR_EVENT_RECORD_TYPE_FREE:
+            pattern->zone = RADAR_LED_PATTERN_FREE;
+            pattern->color = RADAR_LED_GREEN;
+            break;
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_led_pattern_step
+ ********************************************************************************
+ * Summary:
+ *   Advances the LED pattern by one LED task tick. An IN pattern takes
+ *   precedence over an OUT pattern, both over the traffic light.
+ *
+ * Parameters:
+ *   pattern: LED pattern state
+ *   color: color to write to the LEDs
+ *
+ * Return:
+ *   true if color is to be written, false if the LEDs keep their state
+ *******************************************************************************/
+bool radar_led_pattern_step(radar_led_pattern_t *pattern, uint32_t *color)
+{
+    if (pattern->in.pending > 0U)
+    {
+        return led_pattern_blink(&pattern->in,
+                                 RADAR_LED_PATTERN_IN_ON_TIME,
+                                 RADAR_LED_PATTERN_IN_OFF_TIME,
+                                 RADAR_LED_PATTERN_IN_BLINK_TIME,
+                                 pattern->color,
+                                 color);
+    }
+    if (pattern->out.pending > 0U)
+    {
+        return led_pattern_blink(&pattern->out,
+                                 RADAR_LED_PATTERN_OUT_ON_TIME,
+                                 RADAR_LED_PATTERN_OUT_OFF_TIME,
+                                 RADAR_LED_PATTERN_OUT_BLINK_TIME,
+                                 pattern->color,
+                                 color);
+    }
+    if (pattern->zone != RADAR_LED_PATTERN_IDLE)
+    {
+        *color = pattern->color;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+** File name: radar_led_pattern.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_led_pattern.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file for local module */
+#include "radar_event_record.h"
+
+/* This header and radar_led_pattern.c only depend on the C standard library:
+ * the LED task feeds events and timer ticks in and writes the returned
+ * colors to the pins, so the blink timeline can be run on the host. */
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* LED colors, combined with | */
+#define RADAR_LED_OFF   (0x00U)
+#define RADAR_LED_RED   (0x01U)
+#define RADAR_LED_GREEN (0x02U)
+#define RADAR_LED_BLUE  (0x04U)
+
+/* Blink timing in LED task ticks: a blink lasts OFF_TIME ticks with the LED
+ * on during the first ON_TIME - 1 ticks, and a pattern consists of
+ * BLINK_TIME + 2 blinks */
+#define RADAR_LED_PATTERN_IN_ON_TIME     (3U)
+#define RADAR_LED_PATTERN_IN_OFF_TIME    (20U)
+#define RADAR_LED_PATTERN_IN_BLINK_TIME  (5U)
+#define RADAR_LED_PATTERN_OUT_ON_TIME    (3U)
+#define RADAR_LED_PATTERN_OUT_OFF_TIME   (50U)
+#define RADAR_LED_PATTERN_OUT_BLINK_TIME (2U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Traffic light state set by OCCUPIED and FREE events */
+typedef enum
+{
+    RADAR_LED_PATTERN_IDLE,     // no zone event yet, the LEDs are not driven
+    RADAR_LED_PATTERN_OCCUPIED, // red
+    RADAR_LED_PATTERN_FREE      // green
+} radar_led_pattern_zone_t;
+
+/* Blink pattern of an IN or OUT event */
+typedef struct
+{
+    uint8_t pending;   // blink patterns still to be shown, 0 or 1
+    uint8_t onoff;     // ticks in the current blink
+    uint8_t blinks;    // blinks shown of the pattern
+} radar_led_pattern_blink_t;
+
+/* LED pattern state */
+typedef struct
+{
+    radar_led_pattern_zone_t zone;
+    uint32_t color;                // traffic light color, also used for blinking
+    radar_led_pattern_blink_t in;
+    radar_led_pattern_blink_t out;
+    uint32_t overrides;            // counter events that cut short a pending blink pattern
+} radar_led_pattern_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_led_pattern_init(radar_led_pattern_t *pattern);
+void radar_led_pattern_event(radar_led_pattern_t *pattern, radar_event_record_type_t type);
+bool radar_led_pattern_step(radar_led_pattern_t *pattern, uint32_t *color);
@@ -23,6 +23,9 @@
 ** ===========================================================================
 */
 
+/* Header file from system */
+#include <string.h>
+
 /* Header file includes */
 #include "cy_retarget_io.h"
 #include "cybsp.h"
@@ -30,108 +33,159 @@
 
 /* Header file for local task */
 #include "radar_counter_task.h"
+#include "radar_event_bus.h"
+#include "radar_led_pattern.h"
 #include "radar_led_task.h"
 
 /*******************************************************************************
  * Macros
  *******************************************************************************/
-/* Pin number designated for LED RED */
-#define LED_RGB_RED (CYBSP_GPIOA0)
-/* Pin number designated for LED GREEN */
-#define LED_RGB_GREEN (CYBSP_GPIOA1)
-/* Pin number designated for LED BLUE */
-#define LED_RGB_BLUE (CYBSP_GPIOA2)
-/* LED off */
-#define LED_STATE_OFF (0U)
-/* LED on */
-#define LED_STATE_ON (1U)
+/* Number of LEDs, bit i of a color is the LED led_pins[i] */
+#define LED_COUNT (3U)
+/* Number of colors, all combinations of the LEDs */
+#define LED_COLORS (1U << LED_COUNT)
+/* Bits of a color that select LEDs */
+#define LED_COLOR_MASK (LED_COLORS - 1U)
 
 /*******************************************************************************
- * Constants
+ * Types
  *******************************************************************************/
-/* LED blink timing */
-#define COUNTER_IN_LED_ON_TIME     (3U)
-#define COUNTER_IN_LED_OFF_TIME    (20U)
-#define COUNTER_OUT_LED_ON_TIME    (3U)
-#define COUNTER_OUT_LED_OFF_TIME   (50U)
-#define COUNTER_IN_LED_BLINK_TIME  (5U)
-#define COUNTER_OUT_LED_BLINK_TIME (2U)
-
-/* List of LED status */
-typedef enum
-{
-    LED_PRESENCE,
-    LED_ABSENCE,
-    LED_COUNTER_IN,
-    LED_COUNTER_OUT,
-    LED_COUNTER_OCCUPIED,
-    LED_COUNTER_FREE,
-    LED_ERROR,
-    LED_OFF
-} led_condition_t;
-
-/* List of LED colors */
-typedef enum
+/* LED pins of one GPIO port, written with one set and one clear access */
+typedef struct
 {
-    LED_NULL = 0x00,
-    LED_RED = 0x01,
-    LED_GREEN = 0x02,
-    LED_BLUE = 0x04
-} LED_COLOR;
+    GPIO_PRT_Type *base;     // port registers
+    uint32_t pins;           // mask of the LED pins of the port
+    uint32_t on[LED_COLORS]; // mask of the pins to switch on, per color
+} led_port_t;
 
 /*******************************************************************************
  * Global Variables
  *******************************************************************************/
-static led_condition_t led_state = LED_OFF; // LED status of different event
-static LED_COLOR led_color = LED_GREEN;     // current LED color
-static uint8_t led_counter_in_num = 0;      // current unprocessed counter IN event number
-static uint8_t led_counter_out_num = 0;     // current unprocessed counter OUT event number
-static uint8_t led_onoff_time_in = 0;       // LED/GPIO on off time counter for IN event
-static uint8_t led_onoff_time_out = 0;      // LED/GPIO on off time counter for OUT event
-static uint8_t led_blink_count_in = 0;      // LED blink counter for IN event
-static uint8_t led_blink_count_out = 0;     // LED blink counter for OUT event
+static radar_led_pattern_t led_pattern; // blink pattern and traffic light state
+static radar_event_bus_sink_t led_sink;  // event bus sink setting the blink pattern
+static uint8_t led_sink_storage[RADAR_EVENT_BUS_SINK_STORAGE_SIZE(4U)];
+static const cyhal_gpio_t led_pins[LED_COUNT] = {LED_RGB_RED, LED_RGB_GREEN, LED_RGB_BLUE}; // by color bit
+static uint32_t led_color = RADAR_LED_OFF; // color written last
+#if RADAR_LED_BRIGHTNESS < 100
+static cyhal_pwm_t led_pwm[LED_COUNT]; // PWM of each LED pin
+#else
+static led_port_t led_ports[LED_COUNT]; // LED pins grouped by port
+static uint32_t led_port_count = 0U;    // used entries of led_ports
+#endif
 
 /*******************************************************************************
- * Function Name: gpio_led_set
+ * Function Name: led_init
  ********************************************************************************
  * Summary:
- *   This function sets GPIOs to activate LED set by the user.
+ *   This function initializes the LED pins with the LEDs off. At full
+ *   brightness, the pins are grouped by port and the pin masks of all colors
+ *   are computed, so that radar_led_write needs one set and one clear
+ *   register access per port; the LEDs of the kit share one port. Below full
+ *   brightness, each pin is driven by a PWM.
  *
  * Parameters:
- *   led_set: LED color
+ *   none
  *
  * Return
  *   none
  *******************************************************************************/
-static void gpio_led_set(uint32_t led_set)
+static void led_init(void)
 {
-    /* Set red LED */
-    if (led_set & LED_RED)
-    {
-        cyhal_gpio_write(LED_RGB_RED, LED_STATE_ON);
-    }
-    else
-    {
-        cyhal_gpio_write(LED_RGB_RED, LED_STATE_OFF);
-    }
-    /* Set green LED */
-    if (led_set & LED_GREEN)
+    cy_rslt_t result;
+
+    for (uint32_t i = 0U; i < LED_COUNT; i++)
     {
-        cyhal_gpio_write(LED_RGB_GREEN, LED_STATE_ON);
+#if RADAR_LED_BRIGHTNESS < 100
+        result = cyhal_pwm_init(&led_pwm[i], led_pins[i], NULL);
+        if (result == CY_RSLT_SUCCESS)
+        {
+            result = cyhal_pwm_set_duty_cycle(&led_pwm[i], 0.0f, RADAR_LED_PWM_FREQUENCY_HZ);
+        }
+        if (result == CY_RSLT_SUCCESS)
+        {
+            result = cyhal_pwm_start(&led_pwm[i]);
+        }
+        if (result != CY_RSLT_SUCCESS)
+        {
+            CY_ASSERT(0);
+        }
+#else
+        result = cyhal_gpio_init(led_pins[i], CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, LED_STATE_OFF);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            CY_ASSERT(0);
+        }
+
+        GPIO_PRT_Type *base = Cy_GPIO_PortToAddr(CYHAL_GET_PORT(led_pins[i]));
+        uint32_t pin = 1UL << CYHAL_GET_PIN(led_pins[i]);
+        uint32_t port = 0U;
+        while ((port < led_port_count) && (led_ports[port].base != base))
+        {
+            port++;
+        }
+        if (port == led_port_count)
+        {
+            led_ports[port].base = base;
+            led_ports[port].pins = 0U;
+            memset(led_ports[port].on, 0, sizeof(led_ports[port].on));
+            led_port_count++;
+        }
+        led_ports[port].pins |= pin;
+        for (uint32_t color = 0U; color < LED_COLORS; color++)
+        {
+            if ((color & (1UL << i)) != 0U)
+            {
+                led_ports[port].on[color] |= pin;
+            }
+        }
+#endif
     }
-    else
+    led_color = RADAR_LED_OFF;
+}
+
+/*******************************************************************************
+ * Function Name: radar_led_write
+ ********************************************************************************
+ * Summary:
+ *   This function sets the LEDs to a color. Nothing is written if the color
+ *   did not change. At full brightness, each port is updated with one clear
+ *   and one set register access, which only affect the LED pins; otherwise
+ *   the duty cycle of the PWM of each changed LED is set. Public for the
+ *   benchmark, see radar_bench_target.c.
+ *
+ * Parameters:
+ *   led_set: LED color
+ *
+ * Return
+ *   none
+ *******************************************************************************/
+void radar_led_write(uint32_t led_set)
+{
+    uint32_t changed = (led_set ^ led_color) & LED_COLOR_MASK;
+
+    if (changed == 0U)
     {
-        cyhal_gpio_write(LED_RGB_GREEN, LED_STATE_OFF);
+        return;
     }
-    /* Set blue LED */
-    if (led_set & LED_BLUE)
+    led_color = led_set;
+
+#if RADAR_LED_BRIGHTNESS < 100
+    for (uint32_t i = 0U; i < LED_COUNT; i++)
     {
-        cyhal_gpio_write(LED_RGB_BLUE, LED_STATE_ON);
+        if ((changed & (1UL << i)) != 0U)
+        {
+            float duty = ((led_set & (1UL << i)) != 0U) ? (float)RADAR_LED_BRIGHTNESS : 0.0f;
+            (void)cyhal_pwm_set_duty_cycle(&led_pwm[i], duty, RADAR_LED_PWM_FREQUENCY_HZ);
+        }
     }
-    else
+#else
+    for (uint32_t port = 0U; port < led_port_count; port++)
     {
-        cyhal_gpio_write(LED_RGB_BLUE, LED_STATE_OFF);
+        uint32_t on = led_ports[port].on[led_set & LED_COLOR_MASK];
+        GPIO_PRT_OUT_CLR(led_ports[port].base) = led_ports[port].pins & ~on;
+        GPIO_PRT_OUT_SET(led_ports[port].base) = on;
     }
+#endif
 }
 
 /*******************************************************************************
@@ -148,39 +202,91 @@ static void gpio_led_set(uint32_t led_set)
  *******************************************************************************/
 void radar_led_set_pattern(mtb_radar_sensing_event_t event)
 {
-    if (event == MTB_RADAR_SENSING_EVENT_COUNTER_IN)
-    {
-        /* Override LED pattern for LED drive mode */
-        led_counter_in_num = 1;
-        led_counter_out_num = 0;
-        led_onoff_time_out = 0;
-        led_blink_count_out = 0;
-    }
-    else if (event == MTB_RADAR_SENSING_EVENT_COUNTER_OUT)
-    {
-        /* Override LED pattern for LED drive mode */
-        led_counter_out_num = 1;
-        led_counter_in_num = 0;
-        led_onoff_time_in = 0;
-        led_blink_count_in = 0;
-    }
-    else if (event == MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED)
+    switch (event)
     {
-        led_state = LED_COUNTER_OCCUPIED;
-        led_color = LED_RED;
-    }
-    else if (event == MTB_RADAR_SENSING_EVENT_COUNTER_FREE)
-    {
-        led_state = LED_COUNTER_FREE;
-        led_color = LED_GREEN;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
+            radar_led_pattern_event(&led_pattern, RADAR_EVENT_RECORD_TYPE_IN);
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
+            radar_led_pattern_event(&led_pattern, RADAR_EVENT_RECORD_TYPE_OUT);
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
+            radar_led_pattern_event(&led_pattern, RADAR_EVENT_RECORD_TYPE_OCCUPIED);
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_FREE:
+            radar_led_pattern_event(&led_pattern, RADAR_EVENT_RECORD_TYPE_FREE);
+            break;
+        default:
+            break;
     }
 }
 
+/*******************************************************************************
+ * Function Name: radar_led_sink
+ ********************************************************************************
+ * Summary:
+ *   Event bus sink that sets the LED blinking pattern.
+ *
+ * Parameters:
+ *   event: counter event
+ *   arg: unused
+ *
+ * Return
+ *   none
+ *******************************************************************************/
+static void radar_led_sink(const radar_counter_event_t *event, void *arg)
+{
+    radar_led_set_pattern(event->event);
+}
+
+/*******************************************************************************
+ * Function Name: radar_led_subscribe
+ ********************************************************************************
+ * Summary:
+ *   Registers the LEDs as event bus sink for all counter events.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return
+ *   Status of the registration
+ *******************************************************************************/
+cy_rslt_t radar_led_subscribe(void)
+{
+    radar_led_pattern_init(&led_pattern);
+    return radar_event_bus_subscribe(&led_sink,
+                                     "led",
+                                     RADAR_EVENT_BUS_FILTER_ALL,
+                                     radar_led_sink,
+                                     NULL,
+                                     led_sink_storage,
+                                     sizeof(led_sink_storage));
+}
+
+/*******************************************************************************
+ * Function Name: radar_led_get_overrides
+ ********************************************************************************
+ * Summary:
+ *   Returns the number of counter events whose LED pattern replaced a blink
+ *   pattern that was still in progress.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return
+ *   number of overridden blink patterns
+ *******************************************************************************/
+uint32_t radar_led_get_overrides(void)
+{
+    return led_pattern.overrides;
+}
+
 /*******************************************************************************
  * Function Name: radar_led_task
  ********************************************************************************
  * Summary:
- *   This function initializes parameters for LED blinking pattern.
+ *   This function initializes the LED pins and advances the LED pattern
+ *   every 2 ms, writing the pins whenever the pattern provides a new color.
  *
  * Parameters:
  *   arg: thread
@@ -190,93 +296,16 @@ void radar_led_set_pattern(mtb_radar_sensing_event_t event)
  *******************************************************************************/
 void radar_led_task(cy_thread_arg_t arg)
 {
-    /* Initialize the three LED ports and set the LEDs' initial state to off*/
-    cy_rslt_t result = cyhal_gpio_init(LED_RGB_RED, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, LED_STATE_OFF);
-    if (result != CY_RSLT_SUCCESS)
-    {
-        CY_ASSERT(0);
-    }
-
-    result = cyhal_gpio_init(LED_RGB_GREEN, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, LED_STATE_OFF);
-    if (result != CY_RSLT_SUCCESS)
-    {
-        CY_ASSERT(0);
-    }
-
-    result = cyhal_gpio_init(LED_RGB_BLUE, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, LED_STATE_OFF);
-    if (result != CY_RSLT_SUCCESS)
-    {
-        CY_ASSERT(0);
-    }
+    /* Initialize the three LED pins and set the LEDs' initial state to off */
+    led_init();
 
     for (;;)
     {
-        /* Process counter IN event */
-        if (led_counter_in_num > 0)
-        {
-            /* Blink LED according to COUNTER_IN_ON_TIME */
-            led_onoff_time_in++;
-            if (led_onoff_time_in < COUNTER_IN_LED_ON_TIME)
-            {
-                gpio_led_set(led_color);
-            }
-            else if (led_onoff_time_in < COUNTER_IN_LED_OFF_TIME)
-            {
-                gpio_led_set(LED_NULL);
-            }
-            else
-            {
-                led_onoff_time_in = 0;
-                if (led_blink_count_in > COUNTER_IN_LED_BLINK_TIME)
-                {
-                    /* Deduct count after a LED blink generated */
-                    led_counter_in_num--;
-                    led_blink_count_in = 0;
-                    /* Resume LED */
-                    gpio_led_set(led_color);
-                }
-                else
-                {
-                    /* Repeat blink */
-                    led_blink_count_in++;
-                }
-            }
-        }
-        /* Process counter OUT event */
-        else if (led_counter_out_num > 0)
-        {
-            /* Blink LED according to COUNTER_OUT_ON_TIME */
-            led_onoff_time_out++;
-            if (led_onoff_time_out < COUNTER_OUT_LED_ON_TIME)
-            {
-                gpio_led_set(led_color);
-            }
-            else if (led_onoff_time_out < COUNTER_OUT_LED_OFF_TIME)
-            {
-                gpio_led_set(LED_NULL);
-            }
-            else
-            {
-                led_onoff_time_out = 0;
-                if (led_blink_count_out > COUNTER_OUT_LED_BLINK_TIME)
-                {
-                    /* Deduct count after a LED blink generated */
-                    led_counter_out_num--;
-                    led_blink_count_out = 0;
-                    /* Resume LED */
-                    gpio_led_set(led_color);
-                }
-                else
-                {
-                    /* Repeat blink */
-                    led_blink_count_out++;
-                }
-            }
-        }
-        /* Process traffic light event */
-        else if ((led_state == LED_COUNTER_OCCUPIED) || (led_state == LED_COUNTER_FREE))
+        uint32_t color;
+
+        if (radar_led_pattern_step(&led_pattern, &color))
         {
-            gpio_led_set(led_color);
+            radar_led_write(color);
         }
         /* Include 2ms delay */
         vTaskDelay(2);
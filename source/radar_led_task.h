@@ -26,10 +26,12 @@
 
 /* Header file includes */
 #include "cyabs_rtos.h"
+#include "cybsp.h"
 #include "cycfg.h"
 
 /* Header file for local task */
 #include "radar_counter_task.h"
+#include "radar_sched_profile.h"
 
 /* Header file for library */
 #include "mtb_radar_sensing.h"
@@ -42,10 +44,36 @@
 /* LED task stack size */
 #define RADAR_LED_TASK_STACK_SIZE (512)
 /* LED task priority */
-#define RADAR_LED_TASK_PRIORITY (CY_RTOS_PRIORITY_BELOWNORMAL)
+#define RADAR_LED_TASK_PRIORITY (RADAR_SCHED_PRIORITY_LED)
+
+/* Pin number designated for LED RED */
+#define LED_RGB_RED (CYBSP_GPIOA0)
+/* Pin number designated for LED GREEN */
+#define LED_RGB_GREEN (CYBSP_GPIOA1)
+/* Pin number designated for LED BLUE */
+#define LED_RGB_BLUE (CYBSP_GPIOA2)
+/* LED off */
+#define LED_STATE_OFF (0U)
+/* LED on */
+#define LED_STATE_ON (1U)
+
+/* LED brightness in percent, e.g. make build RADAR_LED_BRIGHTNESS=30. Below
+ * 100, the LEDs are driven by PWM, which needs a TCPWM line on each LED pin */
+#ifndef RADAR_LED_BRIGHTNESS
+#define RADAR_LED_BRIGHTNESS (100)
+#endif
+/* PWM frequency, high enough not to flicker */
+#define RADAR_LED_PWM_FREQUENCY_HZ (1000U)
+
+#if (RADAR_LED_BRIGHTNESS < 1) || (RADAR_LED_BRIGHTNESS > 100)
+#error "RADAR_LED_BRIGHTNESS must be within 1 and 100"
+#endif
 
 /*******************************************************************************
  * Functions
  *******************************************************************************/
 void radar_led_task(cy_thread_arg_t arg);
 void radar_led_set_pattern(mtb_radar_sensing_event_t event);
+void radar_led_write(uint32_t led_set);
+cy_rslt_t radar_led_subscribe(void);
+uint32_t radar_led_get_overrides(void);
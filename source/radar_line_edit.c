@@ -0,0 +1,146 @@
+/*****************************************************************************
+** File name: radar_line_edit.c
+**
+** Description: This file implements the line input and choice selection of the
+** terminal UI without any UART access.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <ctype.h>
+
+/* Header file for local module */
+#include "radar_line_edit.h"
+
+/*******************************************************************************
+ * Function Name: radar_line_edit_init
+ ********************************************************************************
+ * Summary:
+ *   Starts the input of a new line.
+ *
+ * Parameters:
+ *   edit: line input state
+ *   line: buffer of the line
+ *   size: size of the buffer including the terminator, at least 1
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_line_edit_init(radar_line_edit_t *edit, char *line, uint32_t size)
+{
+    edit->line = line;
+    edit->size = size;
+    edit->length = 0U;
+    edit->overflow = false;
+    line[0] = '\0';
+}
+
+/*******************************************************************************
+ * Function Name: radar_line_edit_input
+ ********************************************************************************
+ * Summary:
+ *   Handles a key pressed while a line is being entered. Printable
+ *   characters are stored and echoed up to the size of the buffer,
+ *   backspace removes the last character and enter completes the line.
+ *   Whitespace and other control characters are ignored. Characters beyond
+ *   the size of the buffer are dropped and the line is reported as too long
+ *   instead of being executed truncated.
+ *
+ * Parameters:
+ *   edit: line input state
+ *   key: key pressed
+ *   echo: RADAR_LINE_EDIT_ECHO_MAXLENGTH characters to be echoed
+ *   echo_length: number of characters in echo
+ *
+ * Return:
+ *   whether the line is complete
+ *******************************************************************************/
+radar_line_edit_result_t radar_line_edit_input(radar_line_edit_t *edit,
+                                               uint8_t key,
+                                               char *echo,
+                                               uint32_t *echo_length)
+{
+    *echo_length = 0U;
+
+    if ((key == '\r') || (key == '\n'))
+    {
+        echo[0] = '\r';
+        echo[1] = '\n';
+        *echo_length = 2U;
+        edit->line[edit->length] = '\0';
+        return edit->overflow ? RADAR_LINE_EDIT_TOO_LONG : RADAR_LINE_EDIT_COMPLETE;
+    }
+
+    if ((key == '\b') || (key == 0x7FU))
+    {
+        if (edit->length > 0U)
+        {
+            edit->length--;
+            echo[0] = '\b';
+            echo[1] = ' ';
+            echo[2] = '\b';
+            *echo_length = 3U;
+        }
+    }
+    else if (isgraph(key))
+    {
+        if (edit->length < (edit->size - 1U))
+        {
+            edit->line[edit->length++] = (char)key;
+            echo[0] = (char)key;
+            *echo_length = 1U;
+        }
+        else
+        {
+            edit->overflow = true;
+        }
+    }
+    return RADAR_LINE_EDIT_CONTINUE;
+}
+
+/*******************************************************************************
+ * Function Name: radar_line_edit_choice
+ ********************************************************************************
+ * Summary:
+ *   Maps the key pressed to select one of a list of choices, numbered from
+ *   '1'.
+ *
+ * Parameters:
+ *   key: key pressed
+ *   num_choices: number of choices, at most 9
+ *
+ * Return:
+ *   index of the choice, RADAR_LINE_EDIT_CHOICE_IGNORE for whitespace,
+ *   RADAR_LINE_EDIT_CHOICE_INVALID for any other key
+ *******************************************************************************/
+int radar_line_edit_choice(uint8_t key, int num_choices)
+{
+    if (isspace(key))
+    {
+        return RADAR_LINE_EDIT_CHOICE_IGNORE;
+    }
+
+    int i = (int)key - '1';
+    if ((i < 0) || (i >= num_choices))
+    {
+        return RADAR_LINE_EDIT_CHOICE_INVALID;
+    }
+    return i;
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+** File name: radar_line_edit.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_line_edit.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* This header and radar_line_edit.c only depend on the C standard library:
+ * the terminal UI feeds received keys in and writes the returned echo, so
+ * the input parsing can be run on the host with any byte sequence. */
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Size of the echo buffer passed to radar_line_edit_input() */
+#define RADAR_LINE_EDIT_ECHO_MAXLENGTH (3U)
+/* Choice key to be ignored, e.g. the line feed after a carriage return */
+#define RADAR_LINE_EDIT_CHOICE_IGNORE (-2)
+/* Choice key that selects none of the choices */
+#define RADAR_LINE_EDIT_CHOICE_INVALID (-1)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Outcome of a key */
+typedef enum
+{
+    RADAR_LINE_EDIT_CONTINUE, // line not complete yet
+    RADAR_LINE_EDIT_COMPLETE, // line complete and terminated
+    RADAR_LINE_EDIT_TOO_LONG  // line complete, but characters were dropped
+} radar_line_edit_result_t;
+
+/* Line being entered */
+typedef struct
+{
+    char *line;        // buffer, terminated once the line is complete
+    uint32_t size;     // size of the buffer including the terminator
+    uint32_t length;   // characters entered
+    bool overflow;     // characters were dropped since the buffer was full
+} radar_line_edit_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_line_edit_init(radar_line_edit_t *edit, char *line, uint32_t size);
+radar_line_edit_result_t radar_line_edit_input(radar_line_edit_t *edit,
+                                               uint8_t key,
+                                               char *echo,
+                                               uint32_t *echo_length);
+int radar_line_edit_choice(uint8_t key, int num_choices);
@@ -0,0 +1,220 @@
+/*****************************************************************************
+** File name: radar_lock.c
+**
+** Description: This file implements mutexes that count acquisition attempts and
+** failures and measure wait and hold times, so that contention on the
+** application locks shows up in the diagnostics.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "radar_clock.h"
+#include "radar_lock.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+const uint32_t radar_lock_bin_limits_us[RADAR_LOCK_BINS - 1U] = {10U, 100U, 1000U, 10000U, 100000U};
+
+static radar_lock_t *locks[RADAR_LOCK_MAX]; // locks with statistics
+static uint32_t lock_count = 0;
+
+/*******************************************************************************
+ * Function Name: radar_lock_bin
+ ********************************************************************************
+ * Summary:
+ *   Gets the histogram bin of a duration.
+ *
+ * Parameters:
+ *   duration_us: duration
+ *
+ * Return:
+ *   bin index
+ *******************************************************************************/
+static uint32_t radar_lock_bin(uint32_t duration_us)
+{
+    uint32_t bin = 0;
+
+    while ((bin < (RADAR_LOCK_BINS - 1U)) && (duration_us >= radar_lock_bin_limits_us[bin]))
+    {
+        bin++;
+    }
+    return bin;
+}
+
+/*******************************************************************************
+ * Function Name: radar_lock_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes a lock and adds it to the locks listed by the diagnostics.
+ *   Locks beyond RADAR_LOCK_MAX work but are not listed.
+ *
+ * Parameters:
+ *   lock: lock
+ *   name: name shown in the diagnostics
+ *
+ * Return:
+ *   Status of the mutex initialization
+ *******************************************************************************/
+cy_rslt_t radar_lock_init(radar_lock_t *lock, const char *name)
+{
+    lock->name = name;
+    lock->owner = NULL;
+    lock->depth = 0;
+    lock->taken_us = 0;
+    lock->stats = (radar_lock_stats_t){0};
+
+    cy_rslt_t result = cy_rtos_init_mutex(&lock->mutex);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        /* Not a FreeRTOS critical section, locks may be created before the
+         * scheduler is started */
+        uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+        if (lock_count < RADAR_LOCK_MAX)
+        {
+            locks[lock_count++] = lock;
+        }
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_lock_get
+ ********************************************************************************
+ * Summary:
+ *   Takes a lock and records the attempt, the time spent waiting and, if
+ *   the lock could not be taken, the task holding it.
+ *
+ * Parameters:
+ *   lock: lock
+ *   timeout_ms: maximum time to wait, 0 to only try
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS if taken, else the error of cy_rtos_get_mutex
+ *******************************************************************************/
+cy_rslt_t radar_lock_get(radar_lock_t *lock, cy_time_t timeout_ms)
+{
+    uint64_t start_us = radar_clock_us();
+    cy_rslt_t result = cy_rtos_get_mutex(&lock->mutex, timeout_ms);
+    uint64_t now_us = radar_clock_us();
+    uint32_t wait_us = (uint32_t)(now_us - start_us);
+
+    taskENTER_CRITICAL();
+    lock->stats.attempts++;
+    lock->stats.wait_histogram[radar_lock_bin(wait_us)]++;
+    if (wait_us > lock->stats.wait_max_us)
+    {
+        lock->stats.wait_max_us = wait_us;
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        if (lock->depth++ == 0U)
+        {
+            lock->owner = xTaskGetCurrentTaskHandle();
+            lock->taken_us = now_us;
+        }
+    }
+    else
+    {
+        lock->stats.failures++;
+        TaskHandle_t owner = lock->owner;
+        lock->stats.failure_owner = (owner != NULL) ? pcTaskGetName(owner) : NULL;
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_lock_release
+ ********************************************************************************
+ * Summary:
+ *   Releases a lock taken by the calling task and records the hold time
+ *   when the outermost recursive get is released.
+ *
+ * Parameters:
+ *   lock: lock
+ *
+ * Return:
+ *   Status of cy_rtos_set_mutex
+ *******************************************************************************/
+cy_rslt_t radar_lock_release(radar_lock_t *lock)
+{
+    uint64_t now_us = radar_clock_us();
+
+    taskENTER_CRITICAL();
+    if ((lock->depth > 0U) && (--lock->depth == 0U))
+    {
+        uint32_t hold_us = (uint32_t)(now_us - lock->taken_us);
+        lock->stats.hold_histogram[radar_lock_bin(hold_us)]++;
+        if (hold_us > lock->stats.hold_max_us)
+        {
+            lock->stats.hold_max_us = hold_us;
+        }
+        lock->owner = NULL;
+    }
+    taskEXIT_CRITICAL();
+
+    return cy_rtos_set_mutex(&lock->mutex);
+}
+
+/*******************************************************************************
+ * Function Name: radar_lock_get_count
+ ********************************************************************************
+ * Summary:
+ *   Gets the number of locks with statistics.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of locks
+ *******************************************************************************/
+uint32_t radar_lock_get_count(void)
+{
+    return lock_count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_lock_get_stats
+ ********************************************************************************
+ * Summary:
+ *   Copies the statistics of a lock.
+ *
+ * Parameters:
+ *   index: lock index, less than radar_lock_get_count()
+ *   stats: copy of the statistics
+ *
+ * Return:
+ *   name of the lock
+ *******************************************************************************/
+const char *radar_lock_get_stats(uint32_t index, radar_lock_stats_t *stats)
+{
+    radar_lock_t *lock = locks[index];
+
+    taskENTER_CRITICAL();
+    *stats = lock->stats;
+    taskEXIT_CRITICAL();
+    return lock->name;
+}
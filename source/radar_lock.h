@@ -0,0 +1,81 @@
+/******************************************************************************
+** File name: radar_lock.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_lock.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+#include "cyabs_rtos.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Maximum number of locks with statistics */
+#define RADAR_LOCK_MAX (4U)
+/* Number of bins of the wait and hold time histograms */
+#define RADAR_LOCK_BINS (6U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Contention statistics of a lock */
+typedef struct
+{
+    uint32_t attempts;                         // calls of radar_lock_get
+    uint32_t failures;                         // calls that timed out
+    uint32_t wait_max_us;                      // longest time spent in radar_lock_get
+    uint32_t hold_max_us;                      // longest time the lock was held
+    uint32_t wait_histogram[RADAR_LOCK_BINS]; // time spent in radar_lock_get
+    uint32_t hold_histogram[RADAR_LOCK_BINS]; // time from get to release
+    const char *failure_owner;                 // task holding the lock at the last failure
+} radar_lock_stats_t;
+
+/* Mutex with contention statistics, recursive like cy_mutex_t */
+typedef struct
+{
+    cy_mutex_t mutex;
+    const char *name;
+    TaskHandle_t owner;  // task holding the lock, NULL if free
+    uint32_t depth;      // recursion depth of the owner
+    uint64_t taken_us;   // time the owner took the lock
+    radar_lock_stats_t stats;
+} radar_lock_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Upper limits of the histogram bins in microseconds, the last bin has none */
+extern const uint32_t radar_lock_bin_limits_us[RADAR_LOCK_BINS - 1U];
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t radar_lock_init(radar_lock_t *lock, const char *name);
+cy_rslt_t radar_lock_get(radar_lock_t *lock, cy_time_t timeout_ms);
+cy_rslt_t radar_lock_release(radar_lock_t *lock);
+uint32_t radar_lock_get_count(void);
+const char *radar_lock_get_stats(uint32_t index, radar_lock_stats_t *stats);
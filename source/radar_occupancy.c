@@ -0,0 +1,162 @@
+/*****************************************************************************
+** File name: radar_occupancy.c
+**
+** Description: This file enforces the occupancy limit of a room by driving an
+** output (door lock or signal) directly from the sensing callback,
+** independent of the LED and console tasks.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "radar_clock.h"
+#include "radar_occupancy.h"
+#include "radar_occupancy_rule.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static radar_occupancy_rule_t occupancy_rule;
+static radar_occupancy_stats_t occupancy;
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_write
+ ********************************************************************************
+ * Summary:
+ *   Drives the output to the state of the limit rule.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void radar_occupancy_write(void)
+{
+    cyhal_gpio_write(RADAR_OCCUPANCY_GPIO,
+                     occupancy_rule.full ? RADAR_OCCUPANCY_ACTIVE_LEVEL : !RADAR_OCCUPANCY_ACTIVE_LEVEL);
+    occupancy.switches++;
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the output for the counts counting starts with.
+ *
+ * Parameters:
+ *   in_count: total in count
+ *   out_count: total out count
+ *
+ * Return:
+ *   Status of the GPIO initialization
+ *******************************************************************************/
+cy_rslt_t radar_occupancy_init(uint32_t in_count, uint32_t out_count)
+{
+    radar_occupancy_rule_init(&occupancy_rule,
+                              RADAR_OCCUPANCY_LIMIT,
+                              RADAR_OCCUPANCY_HYSTERESIS,
+                              in_count,
+                              out_count);
+    return cyhal_gpio_init(RADAR_OCCUPANCY_GPIO,
+                           CYHAL_GPIO_DIR_OUTPUT,
+                           CYHAL_GPIO_DRIVE_STRONG,
+                           occupancy_rule.full ? RADAR_OCCUPANCY_ACTIVE_LEVEL : !RADAR_OCCUPANCY_ACTIVE_LEVEL);
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_update
+ ********************************************************************************
+ * Summary:
+ *   Updates the occupancy from the counts of a counter event and switches
+ *   the output if the limit is reached or left. Called from the sensing
+ *   callback, so the output follows a crossing within the time of one
+ *   GPIO write.
+ *
+ * Parameters:
+ *   in_count: total in count
+ *   out_count: total out count
+ *   event_us: radar_clock_us() at the entry of the callback
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_occupancy_update(uint32_t in_count, uint32_t out_count, uint64_t event_us)
+{
+    taskENTER_CRITICAL();
+    if (radar_occupancy_rule_update(&occupancy_rule, in_count, out_count))
+    {
+        radar_occupancy_write();
+        uint32_t latency_us = (uint32_t)(radar_clock_us() - event_us);
+        occupancy.latency_last_us = latency_us;
+        if (latency_us > occupancy.latency_max_us)
+        {
+            occupancy.latency_max_us = latency_us;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_set_limit
+ ********************************************************************************
+ * Summary:
+ *   Changes the occupancy limit. The output follows at once.
+ *
+ * Parameters:
+ *   limit: occupancy at which the room is full
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_occupancy_set_limit(uint32_t limit)
+{
+    taskENTER_CRITICAL();
+    if (radar_occupancy_rule_set_limit(&occupancy_rule, limit))
+    {
+        radar_occupancy_write();
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_get_stats
+ ********************************************************************************
+ * Summary:
+ *   Copies the occupancy state and the signaling latency.
+ *
+ * Parameters:
+ *   stats: copy of the state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_occupancy_get_stats(radar_occupancy_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = occupancy;
+    stats->occupancy = occupancy_rule.occupancy;
+    stats->limit = occupancy_rule.limit;
+    stats->full = occupancy_rule.full;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+** File name: radar_occupancy.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_occupancy.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+#include "cybsp.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Output driving the door lock or signal, a free pin of the Feather header */
+#ifndef RADAR_OCCUPANCY_GPIO
+#define RADAR_OCCUPANCY_GPIO (CYBSP_GPIO12)
+#endif
+/* Level of the output while the room is full */
+#ifndef RADAR_OCCUPANCY_ACTIVE_LEVEL
+#define RADAR_OCCUPANCY_ACTIVE_LEVEL (true)
+#endif
+/* Room is full at this occupancy (in count minus out count) */
+#ifndef RADAR_OCCUPANCY_LIMIT
+#define RADAR_OCCUPANCY_LIMIT (10U)
+#endif
+/* Room is free again once the occupancy dropped this far below the limit */
+#ifndef RADAR_OCCUPANCY_HYSTERESIS
+#define RADAR_OCCUPANCY_HYSTERESIS (1U)
+#endif
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Occupancy state and signaling latency */
+typedef struct
+{
+    uint32_t occupancy;      // current occupancy
+    uint32_t limit;
+    bool full;               // output active
+    uint32_t switches;       // output changes
+    uint32_t latency_last_us; // time from the event callback to the last output edge
+    uint32_t latency_max_us;
+} radar_occupancy_stats_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t radar_occupancy_init(uint32_t in_count, uint32_t out_count);
+void radar_occupancy_update(uint32_t in_count, uint32_t out_count, uint64_t event_us);
+void radar_occupancy_set_limit(uint32_t limit);
+void radar_occupancy_get_stats(radar_occupancy_stats_t *stats);
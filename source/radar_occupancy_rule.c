@@ -0,0 +1,133 @@
+/*****************************************************************************
+** File name: radar_occupancy_rule.c
+**
+** Description: This file implements the occupancy limit rule with hysteresis
+** without any hardware access.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_occupancy_rule.h"
+
+/*******************************************************************************
+ * Function Name: occupancy_rule_evaluate
+ ********************************************************************************
+ * Summary:
+ *   Applies the limit and the hysteresis to the current occupancy. Between
+ *   the limit and the hysteresis below it, the room keeps its state. An
+ *   empty room is always free, even with a hysteresis above the limit.
+ *
+ * Parameters:
+ *   rule: occupancy limit rule
+ *
+ * Return:
+ *   true if the room became full or free
+ *******************************************************************************/
+static bool occupancy_rule_evaluate(radar_occupancy_rule_t *rule)
+{
+    bool full = rule->full;
+    uint32_t release = (rule->limit > rule->hysteresis) ? (rule->limit - rule->hysteresis) : 0U;
+
+    if (rule->occupancy >= rule->limit)
+    {
+        full = true;
+    }
+    else if (rule->occupancy <= release)
+    {
+        full = false;
+    }
+
+    if (full == rule->full)
+    {
+        return false;
+    }
+    rule->full = full;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_rule_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the rule for the counts counting starts with, e.g. the
+ *   counts retained over a warm restart. The state before the restart is
+ *   not known, so the room is full only at or above the limit.
+ *
+ * Parameters:
+ *   rule: occupancy limit rule
+ *   limit: occupancy at which the room is full
+ *   hysteresis: room is free again once the occupancy dropped this far
+ *               below the limit
+ *   in_count: total in count
+ *   out_count: total out count
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_occupancy_rule_init(radar_occupancy_rule_t *rule,
+                               uint32_t limit,
+                               uint32_t hysteresis,
+                               uint32_t in_count,
+                               uint32_t out_count)
+{
+    rule->limit = limit;
+    rule->hysteresis = hysteresis;
+    rule->occupancy = (in_count > out_count) ? (in_count - out_count) : 0U;
+    rule->full = (rule->occupancy >= rule->limit);
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_rule_update
+ ********************************************************************************
+ * Summary:
+ *   Updates the occupancy from the counts of a counter event.
+ *
+ * Parameters:
+ *   rule: occupancy limit rule
+ *   in_count: total in count
+ *   out_count: total out count
+ *
+ * Return:
+ *   true if the room became full or free
+ *******************************************************************************/
+bool radar_occupancy_rule_update(radar_occupancy_rule_t *rule, uint32_t in_count, uint32_t out_count)
+{
+    rule->occupancy = (in_count > out_count) ? (in_count - out_count) : 0U;
+    return occupancy_rule_evaluate(rule);
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_rule_set_limit
+ ********************************************************************************
+ * Summary:
+ *   Changes the limit and applies it to the current occupancy.
+ *
+ * Parameters:
+ *   rule: occupancy limit rule
+ *   limit: occupancy at which the room is full
+ *
+ * Return:
+ *   true if the room became full or free
+ *******************************************************************************/
+bool radar_occupancy_rule_set_limit(radar_occupancy_rule_t *rule, uint32_t limit)
+{
+    rule->limit = limit;
+    return occupancy_rule_evaluate(rule);
+}
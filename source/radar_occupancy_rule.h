@@ -0,0 +1,56 @@
+/******************************************************************************
+** File name: radar_occupancy_rule.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_occupancy_rule.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* This header and radar_occupancy_rule.c only depend on the C standard
+ * library: radar_occupancy.c feeds the counts in and drives the output from
+ * the returned state, so the limit rule can be run on the host. */
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Occupancy limit rule */
+typedef struct
+{
+    uint32_t limit;      // room is full at this occupancy
+    uint32_t hysteresis; // room is free again this far below the limit
+    uint32_t occupancy;  // in count minus out count, 0 if more went out
+    bool full;           // room is full
+} radar_occupancy_rule_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_occupancy_rule_init(radar_occupancy_rule_t *rule,
+                               uint32_t limit,
+                               uint32_t hysteresis,
+                               uint32_t in_count,
+                               uint32_t out_count);
+bool radar_occupancy_rule_update(radar_occupancy_rule_t *rule, uint32_t in_count, uint32_t out_count);
+bool radar_occupancy_rule_set_limit(radar_occupancy_rule_t *rule, uint32_t limit);
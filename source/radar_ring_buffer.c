@@ -0,0 +1,197 @@
+/*****************************************************************************
+** File name: radar_ring_buffer.c
+**
+** Description: This file implements a lock-free byte ring buffer shared
+** between one producer and one consumer.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_ring_buffer.h"
+
+/*******************************************************************************
+ * Function Name: radar_ring_buffer_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes an empty ring buffer on top of the given storage.
+ *
+ * Parameters:
+ *   ring: ring buffer object
+ *   buffer: storage of the ring buffer
+ *   size: size of the storage, must be a power of two
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_ring_buffer_init(radar_ring_buffer_t *ring, uint8_t *buffer, uint32_t size)
+{
+    ring->buffer = buffer;
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_ring_buffer_count
+ ********************************************************************************
+ * Summary:
+ *   Returns the number of bytes stored in the ring buffer.
+ *
+ * Parameters:
+ *   ring: ring buffer object
+ *
+ * Return:
+ *   number of bytes available for reading
+ *******************************************************************************/
+uint32_t radar_ring_buffer_count(const radar_ring_buffer_t *ring)
+{
+    return ring->head - ring->tail;
+}
+
+/*******************************************************************************
+ * Function Name: radar_ring_buffer_space
+ ********************************************************************************
+ * Summary:
+ *   Returns the number of bytes that can be written to the ring buffer.
+ *
+ * Parameters:
+ *   ring: ring buffer object
+ *
+ * Return:
+ *   number of free bytes
+ *******************************************************************************/
+uint32_t radar_ring_buffer_space(const radar_ring_buffer_t *ring)
+{
+    return ring->size - (ring->head - ring->tail);
+}
+
+/*******************************************************************************
+ * Function Name: radar_ring_buffer_put
+ ********************************************************************************
+ * Summary:
+ *   Writes one byte to the ring buffer.
+ *
+ * Parameters:
+ *   ring: ring buffer object
+ *   value: byte to be written
+ *
+ * Return:
+ *   true if written, false if the ring buffer is full
+ *******************************************************************************/
+bool radar_ring_buffer_put(radar_ring_buffer_t *ring, uint8_t value)
+{
+    uint32_t head = ring->head;
+
+    if ((head - ring->tail) >= ring->size)
+    {
+        return false;
+    }
+    ring->buffer[head & (ring->size - 1U)] = value;
+    ring->head = head + 1U;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_ring_buffer_write
+ ********************************************************************************
+ * Summary:
+ *   Writes a block of bytes to the ring buffer. The block is written either
+ *   completely or not at all, so that lines of text are never cut.
+ *
+ * Parameters:
+ *   ring: ring buffer object
+ *   data: bytes to be written
+ *   length: number of bytes
+ *
+ * Return:
+ *   true if written, false if there is not enough space
+ *******************************************************************************/
+bool radar_ring_buffer_write(radar_ring_buffer_t *ring, const uint8_t *data, uint32_t length)
+{
+    uint32_t head = ring->head;
+
+    if ((ring->size - (head - ring->tail)) < length)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < length; i++)
+    {
+        ring->buffer[(head + i) & (ring->size - 1U)] = data[i];
+    }
+    ring->head = head + length;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_ring_buffer_get
+ ********************************************************************************
+ * Summary:
+ *   Reads one byte from the ring buffer.
+ *
+ * Parameters:
+ *   ring: ring buffer object
+ *   value: byte read
+ *
+ * Return:
+ *   true if a byte was read, false if the ring buffer is empty
+ *******************************************************************************/
+bool radar_ring_buffer_get(radar_ring_buffer_t *ring, uint8_t *value)
+{
+    uint32_t tail = ring->tail;
+
+    if (ring->head == tail)
+    {
+        return false;
+    }
+    *value = ring->buffer[tail & (ring->size - 1U)];
+    ring->tail = tail + 1U;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_ring_buffer_read
+ ********************************************************************************
+ * Summary:
+ *   Reads up to maxlength bytes from the ring buffer.
+ *
+ * Parameters:
+ *   ring: ring buffer object
+ *   data: destination of the bytes read
+ *   maxlength: maximum number of bytes to read
+ *
+ * Return:
+ *   number of bytes read
+ *******************************************************************************/
+uint32_t radar_ring_buffer_read(radar_ring_buffer_t *ring, uint8_t *data, uint32_t maxlength)
+{
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+
+    if (count > maxlength)
+    {
+        count = maxlength;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        data[i] = ring->buffer[(tail + i) & (ring->size - 1U)];
+    }
+    ring->tail = tail + count;
+    return count;
+}
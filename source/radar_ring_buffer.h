@@ -0,0 +1,53 @@
+/******************************************************************************
+** File name: radar_ring_buffer.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_ring_buffer.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Byte ring buffer for one producer and one consumer. Indices run freely and
+ * are masked on access, so the size must be a power of two. */
+typedef struct
+{
+    uint8_t *buffer;
+    uint32_t size;
+    volatile uint32_t head; // write index, only modified by the producer
+    volatile uint32_t tail; // read index, only modified by the consumer
+} radar_ring_buffer_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_ring_buffer_init(radar_ring_buffer_t *ring, uint8_t *buffer, uint32_t size);
+uint32_t radar_ring_buffer_count(const radar_ring_buffer_t *ring);
+uint32_t radar_ring_buffer_space(const radar_ring_buffer_t *ring);
+bool radar_ring_buffer_put(radar_ring_buffer_t *ring, uint8_t value);
+bool radar_ring_buffer_write(radar_ring_buffer_t *ring, const uint8_t *data, uint32_t length);
+bool radar_ring_buffer_get(radar_ring_buffer_t *ring, uint8_t *value);
+uint32_t radar_ring_buffer_read(radar_ring_buffer_t *ring, uint8_t *data, uint32_t maxlength);
@@ -0,0 +1,91 @@
+/******************************************************************************
+** File name: radar_sched_profile.h
+**
+** Description: This file contains the scheduling profiles of the tasks used
+**   in this application.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file for RTOS abstraction */
+#include "cyabs_rtos.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Priorities of the original example: the radar counter task runs at normal
+ * priority and prints event messages itself */
+#define RADAR_SCHED_PROFILE_DEFAULT (0)
+/* Radar processing above all other application tasks. Event messages are
+ * always handed to the terminal UI task, so that the processing task never
+ * waits for the UART. */
+#define RADAR_SCHED_PROFILE_REALTIME (1)
+
+#ifndef RADAR_SCHED_PROFILE
+#define RADAR_SCHED_PROFILE RADAR_SCHED_PROFILE_REALTIME
+#endif
+
+/* All tasks run on the CM4 core; the CM0+ core only runs the prebuilt
+ * startup image, so there is no core affinity to configure. The stall check
+ * of radar_counter_health.c runs in the timer task at
+ * configTIMER_TASK_PRIORITY. */
+#if (RADAR_SCHED_PROFILE == RADAR_SCHED_PROFILE_REALTIME)
+#define RADAR_SCHED_PRIORITY_PROCESSING (CY_RTOS_PRIORITY_HIGH)
+#define RADAR_SCHED_PRIORITY_EVENT_BUS (CY_RTOS_PRIORITY_NORMAL)
+#define RADAR_SCHED_PRIORITY_LED (CY_RTOS_PRIORITY_BELOWNORMAL)
+#define RADAR_SCHED_PRIORITY_TERMINAL_UI (CY_RTOS_PRIORITY_LOW)
+#define RADAR_SCHED_PRIORITY_JOURNAL (CY_RTOS_PRIORITY_LOW)
+#define RADAR_SCHED_DEFER_OUTPUT (1)
+#else
+#define RADAR_SCHED_PRIORITY_PROCESSING (CY_RTOS_PRIORITY_NORMAL)
+#define RADAR_SCHED_PRIORITY_EVENT_BUS (CY_RTOS_PRIORITY_BELOWNORMAL)
+#define RADAR_SCHED_PRIORITY_LED (CY_RTOS_PRIORITY_BELOWNORMAL)
+#define RADAR_SCHED_PRIORITY_TERMINAL_UI (CY_RTOS_PRIORITY_BELOWNORMAL)
+#define RADAR_SCHED_PRIORITY_JOURNAL (CY_RTOS_PRIORITY_LOW)
+#define RADAR_SCHED_DEFER_OUTPUT (0)
+#endif
+
+/* A processing call that takes longer than the processing period misses its
+ * deadline: the radar FIFO is serviced late */
+#ifndef RADAR_SCHED_PROCESS_DEADLINE_US
+#define RADAR_SCHED_PROCESS_DEADLINE_US (2000U)
+#endif
+
+/* Processing loop: fixed delay after each call, as in the original example.
+ * The period is the processing time plus the delay and drifts with load. */
+#define RADAR_SCHED_LOOP_DELAY (0)
+/* Processing loop: fixed rate with vTaskDelayUntil, drift free */
+#define RADAR_SCHED_LOOP_FIXED_RATE (1)
+
+#ifndef RADAR_SCHED_LOOP
+#define RADAR_SCHED_LOOP RADAR_SCHED_LOOP_FIXED_RATE
+#endif
+
+/* Catch-up after an overrun of the fixed rate loop: skip the missed periods
+ * and continue at the next period boundary */
+#define RADAR_SCHED_CATCHUP_SKIP (0)
+/* Catch-up after an overrun of the fixed rate loop: run the missed periods
+ * back to back, at most RADAR_SCHED_CATCHUP_MAX_BURST of them */
+#define RADAR_SCHED_CATCHUP_BURST (1)
+
+#ifndef RADAR_SCHED_CATCHUP
+#define RADAR_SCHED_CATCHUP RADAR_SCHED_CATCHUP_SKIP
+#endif
+#define RADAR_SCHED_CATCHUP_MAX_BURST (4U)
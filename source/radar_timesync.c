@@ -0,0 +1,270 @@
+/*****************************************************************************
+** File name: radar_timesync.c
+**
+** Description: This file implements the estimation of the offset and drift of the
+** local clock relative to the reference clock of a gateway from pairs of
+** local and reference timestamps.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "radar_timesync.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+#define TIMESYNC_PPB (1000000000LL)
+
+/*******************************************************************************
+ * Function Name: timesync_offset_at
+ ********************************************************************************
+ * Summary:
+ *   Evaluates the estimated offset at a local time.
+ *
+ * Parameters:
+ *   sync: estimator state with an estimate
+ *   local_us: local time
+ *
+ * Return:
+ *   offset of the reference clock in microseconds
+ *******************************************************************************/
+static int64_t timesync_offset_at(const radar_timesync_t *sync, uint64_t local_us)
+{
+    int64_t elapsed_us = (int64_t)(local_us - sync->anchor_us);
+
+    return sync->offset_us + ((elapsed_us * sync->drift_ppb) / TIMESYNC_PPB);
+}
+
+/*******************************************************************************
+ * Function Name: timesync_fit
+ ********************************************************************************
+ * Summary:
+ *   Fits offset and drift to the samples in the window by least squares.
+ *   The sums are taken relative to the newest sample to keep the precision
+ *   of the double arithmetic, which only runs once per sample. The drift
+ *   estimate is kept until the window spans RADAR_TIMESYNC_MIN_SPAN_US.
+ *
+ * Parameters:
+ *   sync: estimator state with at least one sample
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void timesync_fit(radar_timesync_t *sync)
+{
+    const radar_timesync_sample_t *newest =
+        &sync->samples[(sync->next + RADAR_TIMESYNC_WINDOW - 1U) % RADAR_TIMESYNC_WINDOW];
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    double sxx = 0.0;
+    double sxy = 0.0;
+
+    for (uint32_t i = 0; i < sync->count; i++)
+    {
+        mean_x += (double)(int64_t)(sync->samples[i].local_us - newest->local_us);
+        mean_y += (double)(sync->samples[i].offset_us - newest->offset_us);
+    }
+    mean_x /= (double)sync->count;
+    mean_y /= (double)sync->count;
+
+    for (uint32_t i = 0; i < sync->count; i++)
+    {
+        double dx = (double)(int64_t)(sync->samples[i].local_us - newest->local_us) - mean_x;
+        double dy = (double)(sync->samples[i].offset_us - newest->offset_us) - mean_y;
+        sxx += dx * dx;
+        sxy += dx * dy;
+    }
+
+    if (sxx >= ((double)RADAR_TIMESYNC_MIN_SPAN_US * (double)RADAR_TIMESYNC_MIN_SPAN_US))
+    {
+        double drift_ppb = (sxy / sxx) * (double)TIMESYNC_PPB;
+        if (drift_ppb > (double)RADAR_TIMESYNC_MAX_DRIFT_PPB)
+        {
+            drift_ppb = (double)RADAR_TIMESYNC_MAX_DRIFT_PPB;
+        }
+        else if (drift_ppb < -(double)RADAR_TIMESYNC_MAX_DRIFT_PPB)
+        {
+            drift_ppb = -(double)RADAR_TIMESYNC_MAX_DRIFT_PPB;
+        }
+        sync->drift_ppb = (int32_t)drift_ppb;
+    }
+
+    /* The fitted line passes through the mean of the samples */
+    sync->anchor_us = newest->local_us + (uint64_t)(int64_t)mean_x;
+    sync->offset_us = newest->offset_us + (int64_t)mean_y;
+    sync->synced = true;
+}
+
+/*******************************************************************************
+ * Function Name: timesync_restart
+ ********************************************************************************
+ * Summary:
+ *   Discards all samples and drops the drift estimate.
+ *
+ * Parameters:
+ *   sync: estimator state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void timesync_restart(radar_timesync_t *sync)
+{
+    sync->count = 0U;
+    sync->next = 0U;
+    sync->rejected_in_row = 0U;
+    sync->drift_ppb = 0;
+    sync->jitter_us = 0;
+}
+
+/*******************************************************************************
+ * Function Name: timesync_max_residual
+ ********************************************************************************
+ * Summary:
+ *   Determines the largest deviation of a sample from the estimate that is
+ *   accepted.
+ *
+ * Parameters:
+ *   sync: estimator state
+ *
+ * Return:
+ *   deviation in microseconds
+ *******************************************************************************/
+static int64_t timesync_max_residual(const radar_timesync_t *sync)
+{
+    if (sync->count < RADAR_TIMESYNC_SETTLED)
+    {
+        return RADAR_TIMESYNC_MAX_RESIDUAL_US;
+    }
+
+    int64_t limit = sync->jitter_us * RADAR_TIMESYNC_RESIDUAL_FACTOR;
+    return (limit > RADAR_TIMESYNC_MIN_RESIDUAL_US) ? limit : RADAR_TIMESYNC_MIN_RESIDUAL_US;
+}
+
+/*******************************************************************************
+ * Function Name: radar_timesync_init
+ ********************************************************************************
+ * Summary:
+ *   Initializes the estimator without any estimate.
+ *
+ * Parameters:
+ *   sync: estimator state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_timesync_init(radar_timesync_t *sync)
+{
+    timesync_restart(sync);
+    sync->synced = false;
+    sync->anchor_us = 0U;
+    sync->offset_us = 0;
+    sync->accepted = 0U;
+    sync->rejected = 0U;
+    sync->restarts = 0U;
+    sync->last_residual_us = 0;
+    sync->last_sample_us = 0U;
+}
+
+/*******************************************************************************
+ * Function Name: radar_timesync_update
+ ********************************************************************************
+ * Summary:
+ *   Adds a pair of local and reference timestamps taken at the same instant
+ *   and updates the estimate. A sample that deviates too far from the
+ *   estimate (see RADAR_TIMESYNC_MAX_RESIDUAL_US) is rejected; after
+ *   RADAR_TIMESYNC_MAX_REJECTED rejections in a row the reference clock is
+ *   assumed to have been set and the estimation restarts with the sample.
+ *
+ * Parameters:
+ *   sync: estimator state
+ *   local_us: local time of the sample
+ *   reference_us: reference time of the sample
+ *
+ * Return:
+ *   outcome of the sample
+ *******************************************************************************/
+radar_timesync_result_t radar_timesync_update(radar_timesync_t *sync, uint64_t local_us, uint64_t reference_us)
+{
+    int64_t offset_us = (int64_t)(reference_us - local_us);
+    radar_timesync_result_t result = RADAR_TIMESYNC_ACCEPTED;
+
+    sync->last_sample_us = local_us;
+    if (sync->synced)
+    {
+        int64_t limit = timesync_max_residual(sync);
+        sync->last_residual_us = offset_us - timesync_offset_at(sync, local_us);
+        if ((sync->last_residual_us > limit) || (sync->last_residual_us < -limit))
+        {
+            sync->rejected++;
+            if (++sync->rejected_in_row < RADAR_TIMESYNC_MAX_REJECTED)
+            {
+                return RADAR_TIMESYNC_REJECTED;
+            }
+            sync->restarts++;
+            timesync_restart(sync);
+            result = RADAR_TIMESYNC_RESTARTED;
+        }
+        else if (sync->count > 1U)
+        {
+            /* The deviation from an estimate of two or more samples */
+            int64_t deviation_us = (sync->last_residual_us < 0) ? -sync->last_residual_us : sync->last_residual_us;
+            sync->jitter_us += (deviation_us - sync->jitter_us) / 8;
+        }
+    }
+    else
+    {
+        sync->last_residual_us = 0;
+        result = RADAR_TIMESYNC_RESTARTED;
+    }
+
+    sync->samples[sync->next].local_us = local_us;
+    sync->samples[sync->next].offset_us = offset_us;
+    sync->next = (sync->next + 1U) % RADAR_TIMESYNC_WINDOW;
+    if (sync->count < RADAR_TIMESYNC_WINDOW)
+    {
+        sync->count++;
+    }
+    sync->rejected_in_row = 0U;
+    sync->accepted++;
+    timesync_fit(sync);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_timesync_to_reference
+ ********************************************************************************
+ * Summary:
+ *   Converts a local time into the reference timebase.
+ *
+ * Parameters:
+ *   sync: estimator state
+ *   local_us: local time
+ *
+ * Return:
+ *   reference time, local_us unchanged without an estimate
+ *******************************************************************************/
+uint64_t radar_timesync_to_reference(const radar_timesync_t *sync, uint64_t local_us)
+{
+    if (!sync->synced)
+    {
+        return local_us;
+    }
+    return local_us + (uint64_t)timesync_offset_at(sync, local_us);
+}
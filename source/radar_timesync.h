@@ -0,0 +1,100 @@
+/******************************************************************************
+** File name: radar_timesync.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_timesync.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* This header and radar_timesync.c only depend on the C standard library,
+ * so host tools can run the estimator against simulated clocks. */
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Number of reference samples the offset and drift are fitted to */
+#define RADAR_TIMESYNC_WINDOW (16U)
+/* Largest deviation of a sample from the estimate that is accepted while
+ * the window fills up */
+#define RADAR_TIMESYNC_MAX_RESIDUAL_US (50000)
+/* Once the window holds RADAR_TIMESYNC_SETTLED samples, a sample is accepted
+ * up to RADAR_TIMESYNC_RESIDUAL_FACTOR times the average deviation of the
+ * accepted samples, but at least up to RADAR_TIMESYNC_MIN_RESIDUAL_US. This
+ * rejects reference times that were sent late. */
+#define RADAR_TIMESYNC_SETTLED (4U)
+#define RADAR_TIMESYNC_RESIDUAL_FACTOR (4)
+#define RADAR_TIMESYNC_MIN_RESIDUAL_US (1000)
+/* Rejected samples in a row after which the reference is assumed to have
+ * stepped and the estimation restarts */
+#define RADAR_TIMESYNC_MAX_REJECTED (3U)
+/* Bound of the estimated drift, crystals are specified far below */
+#define RADAR_TIMESYNC_MAX_DRIFT_PPB (500000)
+/* Shortest span of the window for a drift estimate */
+#define RADAR_TIMESYNC_MIN_SPAN_US (1000000U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Outcome of a reference sample */
+typedef enum
+{
+    RADAR_TIMESYNC_ACCEPTED, // sample added to the estimate
+    RADAR_TIMESYNC_REJECTED, // sample too far off the estimate, ignored
+    RADAR_TIMESYNC_RESTARTED // first sample or estimation restarted with it
+} radar_timesync_result_t;
+
+/* Pair of local and reference time, stored as the offset between both */
+typedef struct
+{
+    uint64_t local_us;
+    int64_t offset_us; // reference - local
+} radar_timesync_sample_t;
+
+/* Estimator state. The reference time of a local time t is
+ * t + offset_us + drift_ppb * (t - anchor_us) / 10^9. */
+typedef struct
+{
+    radar_timesync_sample_t samples[RADAR_TIMESYNC_WINDOW];
+    uint32_t count;            // samples in the window
+    uint32_t next;             // slot of the next sample
+    uint32_t rejected_in_row;  // rejected samples since the last accepted one
+    bool synced;               // an estimate is available
+    uint64_t anchor_us;        // local time the offset refers to
+    int64_t offset_us;         // offset at the anchor
+    int32_t drift_ppb;         // rate of the reference clock relative to the local clock - 1
+    uint32_t accepted;         // samples accepted
+    uint32_t rejected;         // samples rejected
+    uint32_t restarts;         // estimation restarts after a step of the reference
+    int64_t last_residual_us;  // deviation of the last sample from the previous estimate
+    int64_t jitter_us;         // average absolute deviation of the accepted samples
+    uint64_t last_sample_us;   // local time of the last sample
+} radar_timesync_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_timesync_init(radar_timesync_t *sync);
+radar_timesync_result_t radar_timesync_update(radar_timesync_t *sync, uint64_t local_us, uint64_t reference_us);
+uint64_t radar_timesync_to_reference(const radar_timesync_t *sync, uint64_t local_us);
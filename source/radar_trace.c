@@ -0,0 +1,137 @@
+/*****************************************************************************
+** File name: radar_trace.c
+**
+** Description: This file implements the trace ring that records task switches, radar
+** processing calls, counter callbacks, terminal mutex waits and UART
+** activity with cycle timestamps, and its dump to the terminal.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdio.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Header file for local module */
+#include "radar_clock.h"
+#include "radar_trace.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Maximum number of tasks listed in the dump */
+#define TRACE_MAX_TASKS (12U)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+radar_trace_record_t radar_trace_buffer[RADAR_TRACE_RECORDS];
+uint32_t radar_trace_head = 0;           // total number of records, wraps
+volatile bool radar_trace_active = false; // cleared while the ring is dumped
+
+/*******************************************************************************
+ * Function Name: radar_trace_task_switched_in
+ ********************************************************************************
+ * Summary:
+ *   Called by the FreeRTOS traceTASK_SWITCHED_IN hook in the context switch.
+ *
+ * Parameters:
+ *   task_number: FreeRTOS task number of the task switched in
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_trace_task_switched_in(uint32_t task_number)
+{
+    RADAR_TRACE(RADAR_TRACE_TASK_SWITCH, task_number);
+}
+
+/*******************************************************************************
+ * Function Name: radar_trace_start
+ ********************************************************************************
+ * Summary:
+ *   Starts recording. The cycle counter must be enabled, see
+ *   radar_clock_init.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_trace_start(void)
+{
+    radar_clock_init();
+    radar_trace_active = (RADAR_TRACE_ENABLE != 0);
+}
+
+/*******************************************************************************
+ * Function Name: radar_trace_dump
+ ********************************************************************************
+ * Summary:
+ *   Prints the task names and the records from the oldest to the newest.
+ *   Recording is paused during the dump, so the ring is printed as it was
+ *   when the dump started. Output lines:
+ *     "T CLOCK <cycles per second>"
+ *     "T TASK <task number> <name>"
+ *     "T <cycles> <event id> <argument>" in hexadecimal
+ *     "T END <records>"
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void radar_trace_dump(void)
+{
+    static TaskStatus_t tasks[TRACE_MAX_TASKS];
+
+    if (RADAR_TRACE_ENABLE == 0)
+    {
+        printf("Trace not enabled, build with RADAR_TRACE=1\r\n");
+        return;
+    }
+
+    radar_trace_active = false;
+
+    printf("T CLOCK %lu\r\n", (unsigned long)SystemCoreClock);
+    UBaseType_t count = uxTaskGetSystemState(tasks, TRACE_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        printf("T TASK %lu %s\r\n", (unsigned long)tasks[i].xTaskNumber, tasks[i].pcTaskName);
+    }
+
+    uint32_t head = radar_trace_head;
+    uint32_t records = (head < RADAR_TRACE_RECORDS) ? head : RADAR_TRACE_RECORDS;
+    for (uint32_t i = head - records; i != head; i++)
+    {
+        const radar_trace_record_t *record = &radar_trace_buffer[i & (RADAR_TRACE_RECORDS - 1U)];
+        printf("T %08lx %02lx %06lx\r\n",
+               (unsigned long)record->cycles,
+               (unsigned long)(record->word >> 24),
+               (unsigned long)(record->word & 0x00FFFFFFU));
+    }
+    printf("T END %lu\r\n", (unsigned long)records);
+
+    radar_trace_head = 0;
+    radar_trace_active = true;
+}
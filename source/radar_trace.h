@@ -0,0 +1,118 @@
+/******************************************************************************
+** File name: radar_trace.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in radar_trace.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Set to 1 to record trace events, e.g. with make build RADAR_TRACE=1 */
+#ifndef RADAR_TRACE_ENABLE
+#define RADAR_TRACE_ENABLE (0)
+#endif
+
+/* Number of records kept, must be a power of two */
+#define RADAR_TRACE_RECORDS (1024U)
+
+/* Records an event with a 24-bit argument, compiled out unless enabled */
+#if RADAR_TRACE_ENABLE
+#define RADAR_TRACE(id, arg) radar_trace_record((id), (uint32_t)(arg))
+#else
+#define RADAR_TRACE(id, arg) ((void)0)
+#endif
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Trace events, the argument of each event is given in the comment */
+typedef enum
+{
+    RADAR_TRACE_TASK_SWITCH = 1,  // task number of the task switched in
+    RADAR_TRACE_PROCESS_START = 2, // 0
+    RADAR_TRACE_PROCESS_END = 3,   // 0 on success, 1 on error
+    RADAR_TRACE_CALLBACK_ENTER = 4, // RadarSensing event
+    RADAR_TRACE_CALLBACK_EXIT = 5,  // RadarSensing event
+    RADAR_TRACE_MUTEX_WAIT = 6,    // timeout in ms, terminal print mutex
+    RADAR_TRACE_MUTEX_TAKE = 7,    // 0 when taken, 1 on timeout
+    RADAR_TRACE_MUTEX_GIVE = 8,    // 0
+    RADAR_TRACE_UART_TX_START = 9, // number of bytes
+    RADAR_TRACE_UART_TX_END = 10,  // number of bytes
+    RADAR_TRACE_UART_RX = 11       // number of bytes received
+} radar_trace_id_t;
+
+/* Trace record, 8 bytes */
+typedef struct
+{
+    uint32_t cycles; // DWT cycle counter
+    uint32_t word;   // event id in bits 24-31, argument in bits 0-23
+} radar_trace_record_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+extern radar_trace_record_t radar_trace_buffer[RADAR_TRACE_RECORDS];
+extern uint32_t radar_trace_head;
+extern volatile bool radar_trace_active;
+
+/*******************************************************************************
+ * Function Name: radar_trace_record
+ ********************************************************************************
+ * Summary:
+ *   Adds a record to the trace ring, overwriting the oldest record. Inline
+ *   with interrupts masked for a few instructions, so it may be called from
+ *   tasks, interrupts and the FreeRTOS context switch.
+ *
+ * Parameters:
+ *   id: event
+ *   arg: argument, only the lower 24 bits are kept
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static inline void radar_trace_record(radar_trace_id_t id, uint32_t arg)
+{
+    if (radar_trace_active)
+    {
+        uint32_t mask = __get_PRIMASK();
+        __disable_irq();
+        radar_trace_record_t *record = &radar_trace_buffer[radar_trace_head++ & (RADAR_TRACE_RECORDS - 1U)];
+        record->cycles = DWT->CYCCNT;
+        record->word = ((uint32_t)id << 24) | (arg & 0x00FFFFFFU);
+        __set_PRIMASK(mask);
+    }
+}
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void radar_trace_task_switched_in(uint32_t task_number);
+void radar_trace_start(void);
+void radar_trace_dump(void);